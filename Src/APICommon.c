@@ -163,6 +163,108 @@ void 	ErrorBeep (const char* info, GSErrCode err)
 #endif
 
 
+// -----------------------------------------------------------------------------
+// Element type table
+//	indexed by API_ElemTypeID; the neig is the one used to select the whole
+//	element (APINeig_None: the type can't be selected with a neig)
+//	The table is validated at compile time (see static_asserts below)
+// -----------------------------------------------------------------------------
+
+struct ElemTypeInfo {
+	API_ElemTypeID	typeID;
+	API_NeigID		neigID;
+	UInt32			inIndex;
+	const char*		name;
+};
+
+static constexpr ElemTypeInfo elemTypeInfos[] = {
+	{ API_ZombieElemID,				APINeig_None,					0,		"Zombie"					},
+	{ API_WallID,					APINeig_Wall,					1,		"Wall"						},
+	{ API_ColumnID,					APINeig_Colu,					0,		"Column"					},
+	{ API_BeamID,					APINeig_Beam,					1,		"Beam"						},
+	{ API_WindowID,					APINeig_WindHole,				0,		"Window"					},
+	{ API_DoorID,					APINeig_DoorHole,				0,		"Door"						},
+	{ API_ObjectID,					APINeig_Symb,					1,		"Object"					},
+	{ API_LampID,					APINeig_Light,					1,		"Lamp"						},
+	{ API_SlabID,					APINeig_Ceil,					1,		"Slab"						},
+	{ API_RoofID,					APINeig_Roof,					1,		"Roof"						},
+	{ API_MeshID,					APINeig_Mesh,					1,		"Mesh"						},
+
+	{ API_DimensionID,				APINeig_DimOn,					1,		"Dimension"					},
+	{ API_RadialDimensionID,		APINeig_RadDim,					1,		"Radial Dimension"			},
+	{ API_LevelDimensionID,			APINeig_LevDim,					1,		"Level Dimension"			},
+	{ API_AngleDimensionID,			APINeig_AngDimOn,				1,		"Angle Dimension"			},
+
+	{ API_TextID,					APINeig_Word,					1,		"Text"						},
+	{ API_LabelID,					APINeig_Label,					1,		"Label"						},
+	{ API_ZoneID,					APINeig_Room,					1,		"Zone"						},
+
+	{ API_HatchID,					APINeig_Hatch,					1,		"Hatch"						},
+	{ API_LineID,					APINeig_Line,					1,		"Line"						},
+	{ API_PolyLineID,				APINeig_PolyLine,				1,		"Polyline"					},
+	{ API_ArcID,					APINeig_Arc,					1,		"Arc"						},
+	{ API_CircleID,					APINeig_Circ,					1,		"Circle"					},
+	{ API_SplineID,					APINeig_Spline,					1,		"Spline"					},
+	{ API_HotspotID,				APINeig_Hot,					1,		"Hotspot"					},
+
+	{ API_CutPlaneID,				APINeig_CutPlane,				1,		"Cut Plane"					},
+	{ API_CameraID,					APINeig_Camera,					1,		"Camera"					},
+	{ API_CamSetID,					APINeig_None,					0,		"CamSet"					},
+
+	{ API_GroupID,					APINeig_None,					0,		"Group"						},		// not used from AC18
+	{ API_SectElemID,				APINeig_VirtSy,					1,		"Section Element"			},
+
+	{ API_DrawingID,				APINeig_DrawingCenter,			1,		"Drawing"					},
+	{ API_PictureID,				APINeig_PictObj,				1,		"Picture"					},
+	{ API_DetailID,					APINeig_Detail,					1,		"Detail Drawing"			},
+	{ API_ElevationID,				APINeig_Elevation,				1,		"Elevation"					},
+	{ API_InteriorElevationID,		APINeig_InteriorElevation,		1,		"InteriorElevation"			},
+	{ API_WorksheetID,				APINeig_Worksheet,				1,		"Worksheet"					},
+
+	{ API_HotlinkID,				APINeig_None,					0,		"Hotlink"					},
+
+	{ API_CurtainWallID,			APINeig_CurtainWall,			1,		"CurtainWall"				},
+	{ API_CurtainWallSegmentID,		APINeig_CWSegment,				1,		"CurtainWall Segment"		},
+	{ API_CurtainWallFrameID,		APINeig_CWFrame,				1,		"CurtainWall Frame"			},
+	{ API_CurtainWallPanelID,		APINeig_CWPanel,				1,		"CurtainWall Panel"			},
+	{ API_CurtainWallJunctionID,	APINeig_CWJunction,				1,		"CurtainWall Junction"		},
+	{ API_CurtainWallAccessoryID,	APINeig_CWAccessory,			1,		"CurtainWall Accessory"		},
+	{ API_ShellID,					APINeig_Shell,					1,		"Shell"						},
+	{ API_SkylightID,				APINeig_SkylightHole,			0,		"Skylight"					},
+
+	{ API_MorphID,					APINeig_Morph,					1,		"Morph"						},
+
+	{ API_ChangeMarkerID,			APINeig_ChangeMarker,			1,		"Change Marker"				},
+};
+
+static constexpr UInt32 elemTypeInfoCount = sizeof (elemTypeInfos) / sizeof (elemTypeInfos[0]);
+
+
+static constexpr bool	IsElemTypeTableIndexed (UInt32 i = 0)
+{
+	return i >= elemTypeInfoCount || (elemTypeInfos[i].typeID == (API_ElemTypeID) i && IsElemTypeTableIndexed (i + 1));
+}
+
+
+static constexpr API_ElemTypeID	FindElemTypeByNeig (API_NeigID neigID, UInt32 i = 0)
+{
+	return i >= elemTypeInfoCount ? API_ZombieElemID :
+		   (elemTypeInfos[i].neigID == neigID ? elemTypeInfos[i].typeID : FindElemTypeByNeig (neigID, i + 1));
+}
+
+
+static constexpr bool	IsNeigTableBijective (UInt32 i = 0)
+{
+	return i >= elemTypeInfoCount ||
+		   ((elemTypeInfos[i].neigID == APINeig_None || FindElemTypeByNeig (elemTypeInfos[i].neigID) == elemTypeInfos[i].typeID) &&
+			IsNeigTableBijective (i + 1));
+}
+
+static_assert (elemTypeInfoCount == API_LastElemType + 1,	"elemTypeInfos must have an entry for each API_ElemTypeID");
+static_assert (IsElemTypeTableIndexed (),					"elemTypeInfos must be ordered by API_ElemTypeID");
+static_assert (IsNeigTableBijective (),						"Each neig in elemTypeInfos must belong to exactly one element type");
+
+
 // -----------------------------------------------------------------------------
 // Convert the NeigID to element type
 // -----------------------------------------------------------------------------
@@ -172,6 +274,14 @@ API_ElemTypeID	Neig_To_ElemID (API_NeigID neigID)
 	API_ElemTypeID	typeID;
 	GSErrCode		err;
 
+	if (neigID == APINeig_None)
+		return API_ZombieElemID;
+
+	typeID = FindElemTypeByNeig (neigID);
+	if (typeID != API_ZombieElemID)
+		return typeID;
+
+	// element part neigs (APINeig_WallOn, etc.) are resolved by the server
 	err = ACAPI_Goodies (APIAny_NeigIDToElemTypeID, &neigID, &typeID);
 	if (err != NoError)
 		typeID = API_ZombieElemID;
@@ -180,6 +290,27 @@ API_ElemTypeID	Neig_To_ElemID (API_NeigID neigID)
 }		// Neig_To_ElemID
 
 
+// -----------------------------------------------------------------------------
+// Fill the neig of an element of the given type
+// -----------------------------------------------------------------------------
+
+static bool		ElemID_To_Neig (API_Neig		*neig,
+								API_ElemTypeID	typeID)
+{
+	if (typeID <= API_ZombieElemID || (UInt32) typeID >= elemTypeInfoCount)
+		return false;
+
+	const ElemTypeInfo& info = elemTypeInfos[typeID];
+	if (info.neigID == APINeig_None)
+		return false;
+
+	neig->neigID = info.neigID;
+	neig->inIndex = info.inIndex;
+
+	return true;
+}		// ElemID_To_Neig
+
+
 // -----------------------------------------------------------------------------
 // Convert the element header to a neig
 // -----------------------------------------------------------------------------
@@ -196,67 +327,183 @@ bool	ElemHead_To_Neig (API_Neig				*neig,
 		ACAPI_Element_GetHeader (elemHeadNonConst);
 	}
 
-	switch (elemHeadNonConst->typeID) {
-		case API_WallID:					neig->neigID = APINeig_Wall;				neig->inIndex = 1;	break;
-		case API_ColumnID:					neig->neigID = APINeig_Colu;				neig->inIndex = 0;	break;
-		case API_BeamID:					neig->neigID = APINeig_Beam;				neig->inIndex = 1;	break;
-		case API_WindowID:					neig->neigID = APINeig_WindHole;			neig->inIndex = 0;	break;
-		case API_DoorID:					neig->neigID = APINeig_DoorHole;			neig->inIndex = 0;	break;
-		case API_ObjectID:					neig->neigID = APINeig_Symb;				neig->inIndex = 1;	break;
-		case API_LampID:					neig->neigID = APINeig_Light;				neig->inIndex = 1;	break;
-		case API_SlabID:					neig->neigID = APINeig_Ceil;				neig->inIndex = 1;	break;
-		case API_RoofID:					neig->neigID = APINeig_Roof;				neig->inIndex = 1;	break;
-		case API_MeshID:					neig->neigID = APINeig_Mesh;				neig->inIndex = 1;	break;
-
-		case API_DimensionID:				neig->neigID = APINeig_DimOn;				neig->inIndex = 1;	break;
-		case API_RadialDimensionID:			neig->neigID = APINeig_RadDim;				neig->inIndex = 1;	break;
-		case API_LevelDimensionID:			neig->neigID = APINeig_LevDim;				neig->inIndex = 1;	break;
-		case API_AngleDimensionID:			neig->neigID = APINeig_AngDimOn;			neig->inIndex = 1;	break;
-
-		case API_TextID:					neig->neigID = APINeig_Word;				neig->inIndex = 1;	break;
-		case API_LabelID:					neig->neigID = APINeig_Label;				neig->inIndex = 1;	break;
-		case API_ZoneID:					neig->neigID = APINeig_Room;				neig->inIndex = 1;	break;
-
-		case API_HatchID:					neig->neigID = APINeig_Hatch;				neig->inIndex = 1;	break;
-		case API_LineID:					neig->neigID = APINeig_Line;				neig->inIndex = 1;	break;
-		case API_PolyLineID:				neig->neigID = APINeig_PolyLine;			neig->inIndex = 1;	break;
-		case API_ArcID:						neig->neigID = APINeig_Arc;					neig->inIndex = 1;	break;
-		case API_CircleID:					neig->neigID = APINeig_Circ;				neig->inIndex = 1;	break;
-		case API_SplineID:					neig->neigID = APINeig_Spline;				neig->inIndex = 1;	break;
-		case API_HotspotID:					neig->neigID = APINeig_Hot;					neig->inIndex = 1;	break;
-
-		case API_CutPlaneID:				neig->neigID = APINeig_CutPlane;			neig->inIndex = 1;	break;
-		case API_ElevationID:				neig->neigID = APINeig_Elevation;			neig->inIndex = 1;	break;
-		case API_InteriorElevationID:		neig->neigID = APINeig_InteriorElevation;	neig->inIndex = 1;	break;
-		case API_CameraID:					neig->neigID = APINeig_Camera;				neig->inIndex = 1;	break;
-		case API_CamSetID:					return false;
-
-		case API_PictureID:					neig->neigID = APINeig_PictObj;				neig->inIndex = 1;	break;
-		case API_DetailID:					neig->neigID = APINeig_Detail;				neig->inIndex = 1;	break;
-		case API_WorksheetID:				neig->neigID = APINeig_Worksheet;			neig->inIndex = 1;	break;
-
-		case API_SectElemID:				neig->neigID = APINeig_VirtSy;				neig->inIndex = 1;	break;
-		case API_DrawingID:					neig->neigID = APINeig_DrawingCenter;		neig->inIndex = 1;	break;
-
-		case API_CurtainWallID:				neig->neigID = APINeig_CurtainWall;			neig->inIndex = 1;	break;
-		case API_CurtainWallSegmentID:		neig->neigID = APINeig_CWSegment;			neig->inIndex = 1;	break;
-		case API_CurtainWallFrameID:		neig->neigID = APINeig_CWFrame;				neig->inIndex = 1;	break;
-		case API_CurtainWallPanelID:		neig->neigID = APINeig_CWPanel;				neig->inIndex = 1;	break;
-		case API_CurtainWallJunctionID:		neig->neigID = APINeig_CWJunction;			neig->inIndex = 1;	break;
-		case API_CurtainWallAccessoryID:	neig->neigID = APINeig_CWAccessory;			neig->inIndex = 1;	break;
-		case API_ShellID:					neig->neigID = APINeig_Shell;				neig->inIndex = 1;	break;
-		case API_SkylightID:				neig->neigID = APINeig_SkylightHole;		neig->inIndex = 0;	break;
-		case API_MorphID:					neig->neigID = APINeig_Morph;				neig->inIndex = 1;	break;
-		case API_ChangeMarkerID:			neig->neigID = APINeig_ChangeMarker;		neig->inIndex = 1;	break;
-
-		case API_GroupID:
-		case API_HotlinkID:
-		default:
-				return false;
+	return ElemID_To_Neig (neig, elemHeadNonConst->typeID);
+}		// ElemHead_To_Neig
+
+
+// -----------------------------------------------------------------------------
+// Convert element headers to neigs in one pass
+//	zombie headers are resolved in place; elements that can't be selected
+//	with a neig are skipped
+//	Return: the number of neigs appended
+// -----------------------------------------------------------------------------
+
+UInt32	ElemHeads_To_Neigs (GS::Array<API_Neig>&		neigs,
+							GS::Array<API_Elem_Head>&	elemHeads)
+{
+	API_Neig	neig;
+	UInt32		nAppended = 0;
+
+	neigs.SetCapacity (neigs.GetSize () + elemHeads.GetSize ());
+	BNZeroMemory (&neig, sizeof (API_Neig));
+
+	for (UInt32 i = 0; i < elemHeads.GetSize (); i++) {
+		API_Elem_Head& elemHead = elemHeads[i];
+		if (elemHead.typeID == API_ZombieElemID) {
+			if (elemHead.guid == APINULLGuid)
+				continue;
+			API_Guid guid = elemHead.guid;
+			BNZeroMemory (&elemHead, sizeof (API_Elem_Head));
+			elemHead.guid = guid;
+			if (ACAPI_Element_GetHeader (&elemHead) != NoError)
+				continue;
+		}
+
+		neig.guid = elemHead.guid;
+		if (ElemID_To_Neig (&neig, elemHead.typeID)) {
+			neigs.Push (neig);
+			nAppended++;
+		}
 	}
 
-	return true;
-}		// ElemHead_To_Neig
+	return nAppended;
+}		// ElemHeads_To_Neigs
+
+
+// -----------------------------------------------------------------------------
+// Convert the guids of elements of a known type to neigs
+//	no header lookup is needed
+//	Return: the number of neigs appended
+// -----------------------------------------------------------------------------
+
+UInt32	ElemGuids_To_Neigs (GS::Array<API_Neig>&		neigs,
+							API_ElemTypeID				typeID,
+							const GS::Array<API_Guid>&	guids)
+{
+	API_Neig	neig;
+
+	BNZeroMemory (&neig, sizeof (API_Neig));
+	if (!ElemID_To_Neig (&neig, typeID))
+		return 0;
+
+	neigs.SetCapacity (neigs.GetSize () + guids.GetSize ());
+	for (UInt32 i = 0; i < guids.GetSize (); i++) {
+		neig.guid = guids[i];
+		neigs.Push (neig);
+	}
+
+	return guids.GetSize ();
+}		// ElemGuids_To_Neigs
+
+
+// -----------------------------------------------------------------------------
+// Error code -> name table
+//	generated at compile time from the list below; the codes are checked for
+//	duplicates by static_assert
+// -----------------------------------------------------------------------------
+
+#define API_ERROR_CODES(X)	\
+	X (APIERR_GENERAL)	\
+	X (APIERR_MEMFULL)	\
+	X (APIERR_CANCEL)	\
+	X (APIERR_BADID)	\
+	X (APIERR_BADINDEX)	\
+	X (APIERR_BADNAME)	\
+	X (APIERR_BADPARS)	\
+	X (APIERR_BADPOLY)	\
+	X (APIERR_BADDATABASE)	\
+	X (APIERR_BADWINDOW)	\
+	X (APIERR_BADKEYCODE)	\
+	X (APIERR_BADPLATFORMSIGN)	\
+	X (APIERR_BADPLANE)	\
+	X (APIERR_BADUSERID)	\
+	X (APIERR_BADVALUE)	\
+	X (APIERR_BADELEMENTTYPE)	\
+	X (APIERR_IRREGULARPOLY)	\
+	X (APIERR_NO3D)	\
+	X (APIERR_NOMORE)	\
+	X (APIERR_NOPLAN)	\
+	X (APIERR_NOLIB)	\
+	X (APIERR_NOLIBSECT)	\
+	X (APIERR_NOSEL)	\
+	X (APIERR_NOTEDITABLE)	\
+	X (APIERR_NOTSUBTYPEOF)	\
+	X (APIERR_NOTEQUALMAIN)	\
+	X (APIERR_NOTEQUALREVISION)	\
+	X (APIERR_NOTEAMWORKPROJECT)	\
+	X (APIERR_NOUSERDATA)	\
+	X (APIERR_MOREUSER)	\
+	X (APIERR_LINKEXIST)	\
+	X (APIERR_LINKNOTEXIST)	\
+	X (APIERR_WINDEXIST)	\
+	X (APIERR_WINDNOTEXIST)	\
+	X (APIERR_UNDOEMPTY)	\
+	X (APIERR_REFERENCEEXIST)	\
+	X (APIERR_NAMEALREADYUSED)	\
+	X (APIERR_ATTREXIST)	\
+	X (APIERR_DELETED)	\
+	X (APIERR_LOCKEDLAY)	\
+	X (APIERR_HIDDENLAY)	\
+	X (APIERR_INVALFLOOR)	\
+	X (APIERR_NOTMINE)	\
+	X (APIERR_NOACCESSRIGHT)	\
+	X (APIERR_BADPROPERTYFORELEM)	\
+	X (APIERR_MODULNOTINSTALLED)	\
+	X (APIERR_MODULCMDMINE)	\
+	X (APIERR_MODULCMDNOTSUPPORTED)	\
+	X (APIERR_MODULCMDVERSNOTSUPPORTED)	\
+	X (APIERR_NOMODULEDATA)	\
+	X (APIERR_PAROVERLAP)	\
+	X (APIERR_PARMISSING)	\
+	X (APIERR_PAROVERFLOW)	\
+	X (APIERR_PARIMPLICIT)	\
+	X (APIERR_RUNOVERLAP)	\
+	X (APIERR_RUNMISSING)	\
+	X (APIERR_RUNOVERFLOW)	\
+	X (APIERR_RUNIMPLICIT)	\
+	X (APIERR_RUNPROTECTED)	\
+	X (APIERR_EOLOVERLAP)	\
+	X (APIERR_TABOVERLAP)	\
+	X (APIERR_SQLPARSE)	\
+	X (APIERR_SQLEXECUTE)	\
+	X (APIERR_SQLANY)	\
+	X (APIERR_NOTINIT)	\
+	X (APIERR_NESTING)	\
+	X (APIERR_NOTSUPPORTED)	\
+	X (APIERR_REFUSEDCMD)	\
+	X (APIERR_REFUSEDPAR)	\
+	X (APIERR_READONLY)	\
+	X (APIERR_SERVICEFAILED)	\
+	X (APIERR_COMMANDFAILED)	\
+	X (APIERR_MISSINGCODE)	\
+	X (APIERR_MISSINGDEF)
+
+struct ErrIDName {
+	GSErrCode	err;
+	const char*	name;
+};
+
+#define API_ERROR_NAME(err)		{ err, #err },
+static constexpr ErrIDName errIDNames[] = {
+	API_ERROR_CODES (API_ERROR_NAME)
+};
+#undef API_ERROR_NAME
+
+static constexpr UInt32 errIDNameCount = sizeof (errIDNames) / sizeof (errIDNames[0]);
+
+
+static constexpr bool	IsErrIDUnique (UInt32 i, UInt32 j)
+{
+	return j >= errIDNameCount || (errIDNames[i].err != errIDNames[j].err && IsErrIDUnique (i, j + 1));
+}
+
+
+static constexpr bool	AreErrIDsUnique (UInt32 i = 0)
+{
+	return i >= errIDNameCount || (IsErrIDUnique (i, i + 1) && AreErrIDsUnique (i + 1));
+}
+
+static_assert (AreErrIDsUnique (), "Duplicated error code in API_ERROR_CODES");
 
 
 // -----------------------------------------------------------------------------
@@ -265,99 +512,12 @@ bool	ElemHead_To_Neig (API_Neig				*neig,
 
 const char*		ErrID_To_Name (GSErrCode err)
 {
-	const char	*str;
-
-	switch (err) {
-		case APIERR_GENERAL:			str = "APIERR_GENERAL";			break;
-		case APIERR_MEMFULL:			str = "APIERR_MEMFULL";			break;
-		case APIERR_CANCEL:				str = "APIERR_CANCEL";			break;
-
-		case APIERR_BADID:				str = "APIERR_BADID";			break;
-		case APIERR_BADINDEX:			str = "APIERR_BADINDEX";		break;
-		case APIERR_BADNAME:			str = "APIERR_BADNAME";			break;
-		case APIERR_BADPARS:			str = "APIERR_BADPARS";			break;
-		case APIERR_BADPOLY:			str = "APIERR_BADPOLY";			break;
-		case APIERR_BADDATABASE:		str = "APIERR_BADDATABASE";		break;
-		case APIERR_BADWINDOW:			str = "APIERR_BADWINDOW";		break;
-		case APIERR_BADKEYCODE:			str = "APIERR_BADKEYCODE";		break;
-		case APIERR_BADPLATFORMSIGN:	str = "APIERR_BADPLATFORMSIGN";	break;
-		case APIERR_BADPLANE:			str = "APIERR_BADPLANE";		break;
-		case APIERR_BADUSERID:			str = "APIERR_BADUSERID";		break;
-		case APIERR_BADVALUE:			str = "APIERR_BADVALUE";		break;
-		case APIERR_BADELEMENTTYPE:		str = "APIERR_BADELEMENTTYPE";	break;
-		case APIERR_IRREGULARPOLY:		str = "APIERR_IRREGULARPOLY";	break;
-
-		case APIERR_NO3D:				str = "APIERR_NO3D";			break;
-		case APIERR_NOMORE:				str = "APIERR_NOMORE";			break;
-		case APIERR_NOPLAN:				str = "APIERR_NOPLAN";			break;
-		case APIERR_NOLIB:				str = "APIERR_NOLIB";			break;
-		case APIERR_NOLIBSECT:			str = "APIERR_NOLIBSECT";		break;
-		case APIERR_NOSEL:				str = "APIERR_NOSEL";			break;
-		case APIERR_NOTEDITABLE:		str = "APIERR_NOTEDITABLE";		break;
-		case APIERR_NOTSUBTYPEOF:		str = "APIERR_NOTSUBTYPEOF";	break;
-		case APIERR_NOTEQUALMAIN:		str = "APIERR_NOTEQUALMAIN";	break;
-		case APIERR_NOTEQUALREVISION:	str = "APIERR_NOTEQUALREVISION";	break;
-		case APIERR_NOTEAMWORKPROJECT:	str = "APIERR_NOTEAMWORKPROJECT";	break;
-
-		case APIERR_NOUSERDATA:			str = "APIERR_NOUSERDATA";		break;
-		case APIERR_MOREUSER:			str = "APIERR_MOREUSER";		break;
-		case APIERR_LINKEXIST:			str = "APIERR_LINKEXIST";		break;
-		case APIERR_LINKNOTEXIST:		str = "APIERR_LINKNOTEXIST";	break;
-		case APIERR_WINDEXIST:			str = "APIERR_WINDEXIST";		break;
-		case APIERR_WINDNOTEXIST:		str = "APIERR_WINDNOTEXIST";	break;
-		case APIERR_UNDOEMPTY:			str = "APIERR_UNDOEMPTY";		break;
-		case APIERR_REFERENCEEXIST:		str = "APIERR_REFERENCEEXIST";	break;
-		case APIERR_NAMEALREADYUSED:	str = "APIERR_NAMEALREADYUSED";	break;
-
-		case APIERR_ATTREXIST:				str = "APIERR_ATTREXIST";			break;
-		case APIERR_DELETED:				str = "APIERR_DELETED";				break;
-		case APIERR_LOCKEDLAY:				str = "APIERR_LOCKEDLAY";			break;
-		case APIERR_HIDDENLAY:				str = "APIERR_HIDDENLAY";			break;
-		case APIERR_INVALFLOOR:				str = "APIERR_INVALFLOOR";			break;
-		case APIERR_NOTMINE:				str = "APIERR_NOTMINE";				break;
-		case APIERR_NOACCESSRIGHT:			str = "APIERR_NOACCESSRIGHT";		break;
-		case APIERR_BADPROPERTYFORELEM:		str = "APIERR_BADPROPERTYFORELEM";	break;
-
-		case APIERR_MODULNOTINSTALLED:			str = "APIERR_MODULNOTINSTALLED";			break;
-		case APIERR_MODULCMDMINE:				str = "APIERR_MODULCMDMINE";				break;
-		case APIERR_MODULCMDNOTSUPPORTED:		str = "APIERR_MODULCMDNOTSUPPORTED";		break;
-		case APIERR_MODULCMDVERSNOTSUPPORTED:	str = "APIERR_MODULCMDVERSNOTSUPPORTED";	break;
-		case APIERR_NOMODULEDATA:				str = "APIERR_NOMODULEDATA";				break;
-
-		case APIERR_PAROVERLAP:			str = "APIERR_PAROVERLAP";		break;
-		case APIERR_PARMISSING:			str = "APIERR_PARMISSING";		break;
-		case APIERR_PAROVERFLOW:		str = "APIERR_PAROVERFLOW";		break;
-		case APIERR_PARIMPLICIT:		str = "APIERR_PARIMPLICIT";		break;
-
-		case APIERR_RUNOVERLAP:			str = "APIERR_RUNOVERLAP";		break;
-		case APIERR_RUNMISSING:			str = "APIERR_RUNMISSING";		break;
-		case APIERR_RUNOVERFLOW:		str = "APIERR_RUNOVERFLOW";		break;
-		case APIERR_RUNIMPLICIT:		str = "APIERR_RUNIMPLICIT";		break;
-		case APIERR_RUNPROTECTED:		str = "APIERR_RUNPROTECTED";	break;
-
-		case APIERR_EOLOVERLAP:			str = "APIERR_EOLOVERLAP";		break;
-
-		case APIERR_TABOVERLAP:			str = "APIERR_TABOVERLAP";		break;
-
-		case APIERR_SQLPARSE:			str = "APIERR_SQLPARSE";		break;
-		case APIERR_SQLEXECUTE:			str = "APIERR_SQLEXECUTE";		break;
-		case APIERR_SQLANY:				str = "APIERR_SQLANY";			break;
-
-		case APIERR_NOTINIT:			str = "APIERR_NOTINIT";			break;
-		case APIERR_NESTING:			str = "APIERR_NESTING";			break;
-		case APIERR_NOTSUPPORTED:		str = "APIERR_NOTSUPPORTED";	break;
-		case APIERR_REFUSEDCMD:			str = "APIERR_REFUSEDCMD";		break;
-		case APIERR_REFUSEDPAR:			str = "APIERR_REFUSEDPAR";		break;
-		case APIERR_READONLY:			str = "APIERR_READONLY";		break;
-		case APIERR_SERVICEFAILED:		str = "APIERR_SERVICEFAILED";	break;
-		case APIERR_COMMANDFAILED:		str = "APIERR_COMMANDFAILED";	break;
-
-		case APIERR_MISSINGCODE:		str = "APIERR_MISSINGCODE";		break;
-		case APIERR_MISSINGDEF:			str = "APIERR_MISSINGDEF";		break;
-		default:						str = "???";					break;
+	for (UInt32 i = 0; i < errIDNameCount; i++) {
+		if (errIDNames[i].err == err)
+			return errIDNames[i].name;
 	}
 
-	return str;
+	return "???";
 }		// ErrID_To_Name
 
 
@@ -365,29 +525,32 @@ const char*		ErrID_To_Name (GSErrCode err)
 // Return a descriptive name for a library part type
 // -----------------------------------------------------------------------------
 
-const char*		LibID_To_Name (API_LibTypeID typeID)
-{
-	static char libNames[][32] = {
-		"Zombie",
+static constexpr const char* libNames[] = {
+	"Zombie",
 
-		"Spec",
+	"Spec",
 
-		"Window",
-		"Door",
-		"Object",
-		"Lamp",
-		"Room",
+	"Window",
+	"Door",
+	"Object",
+	"Lamp",
+	"Room",
 
-		"Property",
-		"PlanSign",
-		"Label",
+	"Property",
+	"PlanSign",
+	"Label",
 
-		"Macro",
-		"Pict",
-		"List Scheme",
-		"Skylight"
-	};
+	"Macro",
+	"Pict",
+	"List Scheme",
+	"Skylight"
+};
 
+static_assert (sizeof (libNames) / sizeof (libNames[0]) == APILib_SkylightID + 1, "libNames must have an entry for each API_LibTypeID");
+
+
+const char*		LibID_To_Name (API_LibTypeID typeID)
+{
 	if (typeID < API_ZombieLibID || typeID > APILib_SkylightID)
 		return "???";
 
@@ -400,31 +563,34 @@ const char*		LibID_To_Name (API_LibTypeID typeID)
 // Return a descriptive name for an attribute type
 // -----------------------------------------------------------------------------
 
+static constexpr const char* attrNames[] = {
+	"Zombie",
+
+	"Pen",
+	"Layer",
+	"Linetype",
+	"Filltype",
+	"CompWall",
+	"Material",
+	"City",
+	"LayerComb",
+	"ZoneCat",
+	"Font",
+	"Profile",
+	"Pen table",
+	"Dimension style",
+	"Model View options",
+	"MEP System",
+	"Operation Profile",
+	"Graphic Override",
+	"Building Material"
+};
+
+static_assert (sizeof (attrNames) / sizeof (attrNames[0]) >= API_LastAttributeID + 1, "attrNames must have an entry for each API_AttrTypeID");
+
+
 const char*		AttrID_To_Name (API_AttrTypeID typeID)
 {
-	static char attrNames[][32] = {
-		"Zombie",
-
-		"Pen",
-		"Layer",
-		"Linetype",
-		"Filltype",
-		"CompWall",
-		"Material",
-		"City",
-		"LayerComb",
-		"ZoneCat",
-		"Font",
-		"Profile",
-		"Pen table",
-		"Dimension style",
-		"Model View options",
-		"MEP System",
-		"Operation Profile",
-		"Graphic Override",
-		"Building Material"
-	};
-
 	if (typeID < API_ZombieAttrID || typeID > API_LastAttributeID)
 		return "???";
 
@@ -438,71 +604,10 @@ const char*		AttrID_To_Name (API_AttrTypeID typeID)
 
 const char*		ElemID_To_Name (API_ElemTypeID typeID)
 {
-	static char elemNames[][32] = {
-			"Zombie",
-
-			"Wall",
-			"Column",
-			"Beam",
-			"Window",
-			"Door",
-			"Object",
-			"Lamp",
-			"Slab",
-			"Roof",
-			"Mesh",
-
-			"Dimension",
-			"Radial Dimension",
-			"Level Dimension",
-			"Angle Dimension",
-
-			"Text",
-			"Label",
-			"Zone",
-
-			"Hatch",
-			"Line",
-			"Polyline",
-			"Arc",
-			"Circle",
-			"Spline",
-			"Hotspot",
-
-			"Cut Plane",
-			"Camera",
-			"CamSet",
-
-			"Group",				// not used from AC18
-			"Section Element",
-
-			"Drawing",
-			"Picture",
-			"Detail Drawing",
-			"Elevation",
-			"InteriorElevation",
-			"Worksheet",
-
-			"Hotlink",
-
-			"CurtainWall",
-			"CurtainWall Segment",
-			"CurtainWall Frame",
-			"CurtainWall Panel",
-			"CurtainWall Junction",
-			"CurtainWall Accessory",
-			"Shell",
-			"Skylight",
-
-			"Morph",
-
-			"Change Marker"
-	};
-
 	if (typeID < API_ZombieElemID || typeID > API_LastElemType)
 		return "???";
 
-	return elemNames[typeID];
+	return elemTypeInfos[typeID].name;
 }		// ElemID_To_Name
 
 
@@ -691,6 +796,105 @@ bool	ClickAnElem (const char			*prompt,
 }		// ClickAnElem
 
 
+// -----------------------------------------------------------------------------
+// Ask the user to click several elements of the requested type
+//	the neigs are appended to 'neigs'
+//	Return: the number of clicked elements
+// -----------------------------------------------------------------------------
+
+UInt32	ClickElements (const char				*prompt,
+					   API_ElemTypeID			needTypeID,
+					   GS::Array<API_Neig>&		neigs)
+{
+	API_Neig	theNeig;
+	UInt32		n = 0;
+
+	while (ClickAnElem (prompt, needTypeID, &theNeig)) {
+		if (theNeig.neigID == APINeig_None)
+			break;
+		neigs.Push (theNeig);
+		n++;
+	}
+
+	return n;
+}		// ClickElements
+
+
+// -----------------------------------------------------------------------------
+// Ask the user for two opposite corners of a rectangle and collect the
+// elements of the requested type that lie completely inside it
+//	'needTypeID' == API_ZombieElemID: all selectable types
+//	the neigs are appended to 'neigs'
+//	Return: the number of collected elements
+// -----------------------------------------------------------------------------
+
+UInt32	ClickElements_Area (const char				*prompt,
+							API_ElemTypeID			needTypeID,
+							GS::Array<API_Neig>&	neigs)
+{
+	API_GetPointType	pointInfo;
+	API_GetLineType		lineInfo;
+	GSErrCode			err;
+
+	BNZeroMemory (&pointInfo, sizeof (API_GetPointType));
+	BNZeroMemory (&lineInfo, sizeof (API_GetLineType));
+
+	CHTruncate (prompt, pointInfo.prompt, sizeof (pointInfo.prompt));
+	pointInfo.changeFilter = false;
+	pointInfo.changePlane  = false;
+	err = ACAPI_Interface (APIIo_GetPointID, &pointInfo, NULL);
+	if (err == NoError) {
+		CHTruncate (prompt, lineInfo.prompt, sizeof (lineInfo.prompt));
+		lineInfo.startCoord = pointInfo.pos;						// the diagonal of the area starts with the clicked point
+		lineInfo.disableDefaultFeedback = false;					// draw the default thick rubber line
+		err = ACAPI_Interface (APIIo_GetLineID, &lineInfo, NULL);
+	}
+	if (err != NoError) {
+		if (err != APIERR_CANCEL)
+			WriteReport_Alert ("Error in ClickElements_Area: %d", err);
+		return 0;
+	}
+
+	double xMin = (lineInfo.startCoord.x < lineInfo.pos.x) ? lineInfo.startCoord.x : lineInfo.pos.x;
+	double xMax = (lineInfo.startCoord.x < lineInfo.pos.x) ? lineInfo.pos.x : lineInfo.startCoord.x;
+	double yMin = (lineInfo.startCoord.y < lineInfo.pos.y) ? lineInfo.startCoord.y : lineInfo.pos.y;
+	double yMax = (lineInfo.startCoord.y < lineInfo.pos.y) ? lineInfo.pos.y : lineInfo.startCoord.y;
+
+	API_ElemTypeID	firstTypeID = (needTypeID == API_ZombieElemID) ? API_WallID : needTypeID;
+	API_ElemTypeID	lastTypeID  = (needTypeID == API_ZombieElemID) ? API_LastElemType : needTypeID;
+	UInt32			n = 0;
+
+	GS::Array<API_Guid>	elemList;
+	GS::Array<API_Guid>	insideList;
+	for (Int32 typeID = firstTypeID; typeID <= lastTypeID; typeID++) {
+		if ((UInt32) typeID >= elemTypeInfoCount || elemTypeInfos[typeID].neigID == APINeig_None)
+			continue;
+
+		elemList.Clear ();
+		if (ACAPI_Element_GetElemList ((API_ElemTypeID) typeID, &elemList, APIFilt_OnVisLayer | APIFilt_OnActFloor) != NoError)
+			continue;
+
+		insideList.Clear ();
+		insideList.SetCapacity (elemList.GetSize ());
+		for (UInt32 i = 0; i < elemList.GetSize (); i++) {
+			API_Elem_Head	elemHead;
+			API_Box3D		bounds;
+			BNZeroMemory (&elemHead, sizeof (API_Elem_Head));
+			elemHead.typeID = (API_ElemTypeID) typeID;
+			elemHead.guid = elemList[i];
+			if (ACAPI_Database (APIDb_CalcBoundsID, &elemHead, &bounds) != NoError)
+				continue;
+			if (bounds.xMin >= xMin && bounds.xMax <= xMax && bounds.yMin >= yMin && bounds.yMax <= yMax)
+				insideList.Push (elemList[i]);
+		}
+
+		n += ElemGuids_To_Neigs (neigs, (API_ElemTypeID) typeID, insideList);
+	}
+
+	return n;
+}		// ClickElements_Area
+
+
 // -----------------------------------------------------------------------------
 // Ask the user to click several elements of the requested type
 //	return the neigs
@@ -700,28 +904,17 @@ API_Neig**	ClickElements_Neig (const char		*prompt,
 								API_ElemTypeID	needTypeID,
 								Int32			*nItem)
 {
-	API_Neig	**items, theNeig;
-	Int32		n;
-
-	items = (API_Neig **) BMAllocateHandle (0, ALLOCATE_CLEAR, 0);
-	n = 0;
-
-	while (items != NULL) {
-		if (ClickAnElem (prompt, needTypeID, &theNeig)) {
-			if (theNeig.neigID == APINeig_None)
-				break;
-			items = (API_Neig **) BMReallocHandle ((GSHandle) items, (n + 1) * sizeof (API_Neig), 0, 0);
-			if (items != NULL) {
-				(*items) [n] = theNeig;
-				n ++;
-			}
-		} else
-			break;
-	}
-
-	if (n == 0 && items != NULL) {
-		BMKillHandle ((GSHandle *) &items);
-		items = NULL;
+	GS::Array<API_Neig>	neigs;
+	API_Neig			**items = NULL;
+	Int32				n;
+
+	n = ClickElements (prompt, needTypeID, neigs);
+	if (n > 0) {
+		items = (API_Neig **) BMAllocateHandle (n * sizeof (API_Neig), 0, 0);
+		if (items != NULL)
+			BNCopyMemory (*items, &neigs[0], n * sizeof (API_Neig));
+		else
+			n = 0;
 	}
 
 	if (nItem != NULL)
@@ -740,25 +933,27 @@ API_Elem_Head**	ClickElements_ElemHead (const char		*prompt,
 										API_ElemTypeID	needTypeID,
 										Int32			*nItem)
 {
-	API_Neig		**items;
-	API_Elem_Head	**elemHead;
-	Int32			i;
-	GSErrCode		err;
-
-	items = ClickElements_Neig (prompt, needTypeID, nItem);
-	if (items == NULL)
+	GS::Array<API_Neig>	neigs;
+	API_Elem_Head		**elemHead;
+	Int32				i, n;
+
+	n = ClickElements (prompt, needTypeID, neigs);
+	if (n == 0) {
+		if (nItem != NULL)
+			*nItem = 0;
 		return NULL;
+	}
 
-	elemHead = (API_Elem_Head **) BMAllocateHandle (*nItem * sizeof (API_Elem_Head), ALLOCATE_CLEAR, 0);
-	err = BMError ();
-	if (err == NoError) {
-		for (i = 0; i < *nItem; i++) {
-			(*elemHead)[i].guid	= (*items)[i].guid;
+	elemHead = (API_Elem_Head **) BMAllocateHandle (n * sizeof (API_Elem_Head), ALLOCATE_CLEAR, 0);
+	if (elemHead != NULL) {
+		for (i = 0; i < n; i++) {
+			(*elemHead)[i].guid	= neigs[i].guid;
 		}
 	} else
-		*nItem = 0;
+		n = 0;
 
-	BMKillHandle ((GSHandle *) &items);
+	if (nItem != NULL)
+		*nItem = n;
 
 	return elemHead;
 }		// ClickElements_ElemHead
@@ -47,6 +47,8 @@ void 		ErrorBeep (const char* info, GSErrCode err);
 API_ElemTypeID	Neig_To_ElemID (API_NeigID neigID);
 
 bool			ElemHead_To_Neig (API_Neig *neig, const API_Elem_Head *elemHead);
+UInt32			ElemHeads_To_Neigs (GS::Array<API_Neig>& neigs, GS::Array<API_Elem_Head>& elemHeads);
+UInt32			ElemGuids_To_Neigs (GS::Array<API_Neig>& neigs, API_ElemTypeID typeID, const GS::Array<API_Guid>& guids);
 
 const char*		ErrID_To_Name  (GSErrCode err);
 const char*		LibID_To_Name  (API_LibTypeID typeID);
@@ -74,6 +76,14 @@ bool		ClickAnElem (const char			*prompt,
 						 bool				ignorePartialSelection = true);
 
 
+UInt32		ClickElements (const char				*prompt,
+						   API_ElemTypeID			needTypeID,
+						   GS::Array<API_Neig>&		neigs);
+
+UInt32		ClickElements_Area (const char				*prompt,
+								API_ElemTypeID			needTypeID,
+								GS::Array<API_Neig>&	neigs);
+
 API_Neig**	ClickElements_Neig (const char		*prompt,
 								API_ElemTypeID	needTypeID,
 								Int32			*nItem);
@@ -10,6 +10,21 @@
 
 #include "Property_Test.hpp"
 #include "Property_Test_Helpers.hpp"
+#include "Property_Test_Selection.hpp"
+#include "Property_Test_Batch.hpp"
+#include "Property_Test_Availability.hpp"
+#include "Property_Test_ElementEdit.hpp"
+#include "Property_Test_Progress.hpp"
+#include "Property_Test_Snapshot.hpp"
+#include "Property_Test_SnapshotDiff.hpp"
+#include "Property_Test_Import.hpp"
+#include "Property_Test_Defaults.hpp"
+#include "Property_Test_Query.hpp"
+#include "Property_Test_Browser.hpp"
+#include "Property_Test_IdGenerator.hpp"
+#include "Property_Test_TestRunner.hpp"
+#include "Property_Test_Stress.hpp"
+#include "Property_Test_WorkerPool.hpp"
 
 // -----------------------------------------------------------------------------
 // Test functions
@@ -43,7 +58,7 @@ static GSErrCode SimpleTestPropertyGroups ()
 	ASSERT (group.name == group2.name);
 
 	// The name of the group can be changed
-	group.name = "Renamed Property_Test Add-On Group - " + PropertyTestHelpers::GenearteUniqueName ();
+	group.name = PropertyTestHelpers::IdGenerator::Get ().NextName ("Renamed Property_Test Add-On Group - ");
 	ASSERT_NO_ERROR (ACAPI_Property_ChangePropertyGroup (group));
 
 	ASSERT (group.name != group2.name);
@@ -69,7 +84,7 @@ static GSErrCode ThoroughTestPropertyGroups ()
 	// Create a property group
 	API_PropertyGroup group;
 	group.guid = APINULLGuid;
-	group.name = "Property_Test Add-On Group - "  + PropertyTestHelpers::GenearteUniqueName ();
+	group.name = PropertyTestHelpers::IdGenerator::Get ().NextName ("Property_Test Add-On Group - ");
 	ASSERT_NO_ERROR (ACAPI_Property_CreatePropertyGroup (group));
 
 	// Try to create another group with the same name
@@ -195,7 +210,7 @@ static GSErrCode SimpleTestPropertyDefinitions ()
 	ASSERT (definition == definition2);
 
 	// The parameters of the definition can be changed
-	definition.name = "Renamed Property_Test Add-On Definition - " + PropertyTestHelpers::GenearteUniqueName ();
+	definition.name = PropertyTestHelpers::IdGenerator::Get ().NextName ("Renamed Property_Test Add-On Definition - ");
 	definition.defaultValue.singleVariant.variant.boolValue = true;
 	ASSERT_NO_ERROR (ACAPI_Property_ChangePropertyDefinition (definition));
 
@@ -223,7 +238,7 @@ static GSErrCode ThoroughTestPropertyDefinitions ()
 	API_PropertyDefinition definition;
 	definition.guid = APINULLGuid;
 	definition.groupGuid = APINULLGuid; // this is not valid
-	definition.name = "Property_Test Add-On Definition - " + PropertyTestHelpers::GenearteUniqueName ();
+	definition.name = PropertyTestHelpers::IdGenerator::Get ().NextName ("Property_Test Add-On Definition - ");
 	definition.valueType = API_PropertyStringValueType;
 	definition.collectionType = API_PropertySingleChoiceEnumerationCollectionType;
 
@@ -490,55 +505,135 @@ static GSErrCode TestPropertiesOnElemDefault (API_ElemTypeID typeId = API_Column
 
 
 /*----------------------------------------------------------------**
-**			Runs all the previously defined test cases.           **
-**				Requires an element to be selected.			      **
+**			Registers all the previously defined test cases.		  **
+**				Some of them need a selected element.			      **
 **----------------------------------------------------------------*/
-static GSErrCode RunTestsOnSelectedElem () 
+static void RegisterPropertyTests (PropertyTestHelpers::TestRegistry& registry)
 {
-	bool wasError = false;
-	GSErrCode error = NoError;
+	registry.Add ("SimpleTestPropertyGroups", SimpleTestPropertyGroups);
+	registry.Add ("ThoroughTestPropertyGroups", ThoroughTestPropertyGroups);
+	registry.Add ("SimpleTestPropertyDefinitions", SimpleTestPropertyDefinitions);
+	registry.Add ("ThoroughTestPropertyDefinitions", ThoroughTestPropertyDefinitions);
+	registry.Add ("TestPropertiesOnElem", [] () { return PropertyTestHelpers::CallOnSelectedElem (TestPropertiesOnElem); });
+	registry.Add ("TestPropertiesOnElemDefault", [] () { return TestPropertiesOnElemDefault (); });
+	PropertyTestQuery::RegisterTests (registry);
+}
+
+
+/*----------------------------------------------------------------**
+**	Writes the results into <project name><suffix> (JUnit) next to **
+**					the project if it is saved					   **
+**----------------------------------------------------------------*/
+static GSErrCode WriteJUnitReport (const PropertyTestHelpers::TestRunner& runner, const char* suffix)
+{
+	IO::Location location;
+	if (PropertyTestSnapshot::GetProjectFileLocation (suffix, location) != NoError) {
+		return NoError;
+	}
 
-	error = SimpleTestPropertyGroups (), wasError = wasError || (error != NoError);
-	error = ThoroughTestPropertyGroups (), wasError = wasError || (error != NoError);
-	error = SimpleTestPropertyDefinitions (), wasError = wasError || (error != NoError);
-	error = ThoroughTestPropertyDefinitions (), wasError = wasError || (error != NoError);
-	error = PropertyTestHelpers::CallOnSelectedElem (TestPropertiesOnElem), wasError = wasError || (error != NoError);
-	error = TestPropertiesOnElemDefault (), wasError = wasError || (error != NoError);
+	ASSERT_NO_ERROR (runner.WriteJUnitReport (location, "Property_Test"));
+	GS::UniString path;
+	location.ToPath (&path);
+	WriteReport ("  JUnit report written to %s", path.ToCStr ().Get ());
 
-	if (wasError) {
+	return NoError;
+}
+
+
+/*----------------------------------------------------------------**
+**	Runs the test cases, each repeatCount times, goes on after a   **
+**	failure, and writes <project name>.tests.xml (JUnit) next to   **
+**					the project if it is saved					   **
+**----------------------------------------------------------------*/
+static GSErrCode RunPropertyTests (const char* commandName, UInt32 repeatCount, bool alertOnSuccess)
+{
+	PropertyTestHelpers::TestRegistry registry;
+	RegisterPropertyTests (registry);
+
+	PropertyTestHelpers::Progress progress (commandName, "Running the tests", registry.GetSize () * repeatCount);
+	PropertyTestHelpers::TestRunner runner (registry);
+	runner.SetRepeatCount (repeatCount);
+	runner.SetProgress (&progress);
+	const GSErrCode error = runner.Run ();
+	runner.Report (commandName);
+
+	ASSERT_NO_ERROR (WriteJUnitReport (runner, ".tests.xml"));
+
+	if (error == APIERR_CANCEL) {
+		return NoError;
+	}
+
+	const UInt32 failedCount = runner.GetFailedCount ();
+	if (failedCount > 0) {
+		DGAlert (DG_ERROR, "Test failure", GS::ValueToUniString (failedCount) + " of " + GS::ValueToUniString (registry.GetSize ()) +
+				 " test(s) failed.", "See the report for the details.", "Ok");
 		return Error;
-	} else {
+	}
+	if (alertOnSuccess) {
 		DGAlert (DG_INFORMATION, "Test success", "Tests executed successfully.", "", "Ok");
-		return NoError;
 	}
+	return NoError;
 }
 
 
-/*------------------------------------------------------------**
-** Creates a new boolean single value property for an element **
-**------------------------------------------------------------*/
-static GSErrCode DefineNewBoolProperty (const API_Guid& wallGuid)
+/*----------------------------------------------------------------**
+**			Runs all the previously defined test cases.           **
+**				Requires an element to be selected.			      **
+**----------------------------------------------------------------*/
+static GSErrCode RunTestsOnSelectedElem () 
 {
-	API_Element         element, mask;
-	GSErrCode           err = NoError;
+	return RunPropertyTests ("RunTestsOnSelectedElem", 1, true);
+}
 
-	BNZeroMemory(&element, sizeof(API_Element));
-	element.header.guid = wallGuid;
-	err = ACAPI_Element_Get(&element);
-	if (err != NoError)
-		return err;
 
+/*----------------------------------------------------------------**
+**	Runs all the test cases ten times for their timing statistics **
+**				Requires an element to be selected.			      **
+**----------------------------------------------------------------*/
+static GSErrCode BenchmarkPropertyTests () 
+{
+	return RunPropertyTests ("BenchmarkPropertyTests", 10, false);
+}
 
-	if (err == NoError) {
-		ACAPI_ELEMENT_MASK_CLEAR(mask);
-		ACAPI_ELEMENT_MASK_SET(mask, API_CurtainWallType, nSegments);
 
-		element.curtainWall.nSegments = 10;
+/*----------------------------------------------------------------**
+**	Creates, reads, lists, finds, renames, changes and deletes 10  **
+**	to 100000 property groups and definitions one by one, and	   **
+**	checks that the cost of every operation grows as expected	   **
+**	with the count												   **
+**----------------------------------------------------------------*/
+static GSErrCode StressTestPropertyObjects ()
+{
+	const std::vector<UInt32> counts = { 10, 100, 1000, 10000, 100000 };
+
+	PropertyTestHelpers::Progress progress ("StressTestPropertyObjects", "Running the stress tests", 0);
+	std::vector<PropertyTestStress::StressRun> runs;
+	PropertyTestHelpers::TestRegistry registry;
+	PropertyTestStress::RegisterStressTests (counts, &progress, runs, registry);
 
-		err = ACAPI_Element_Change(&element, &mask, NULL, 0, true);
+	PropertyTestHelpers::TestRunner runner (registry);
+	runner.SetProgress (&progress);
+	const GSErrCode error = runner.Run ();
+	runner.Report ("StressTestPropertyObjects");
+	ASSERT_NO_ERROR (WriteJUnitReport (runner, ".stress.xml"));
+
+	std::vector<PropertyTestStress::Scaling> scalings;
+	PropertyTestStress::CheckScaling (runs, scalings);
+	PropertyTestStress::Report ("StressTestPropertyObjects", runs, scalings);
+
+	if (error == APIERR_CANCEL) {
+		return NoError;
 	}
 
-	return err;
+	const UInt32 failedCount = runner.GetFailedCount ();
+	const UInt32 superlinearCount = PropertyTestStress::GetSuperlinearCount (scalings);
+	if (failedCount > 0 || superlinearCount > 0) {
+		DGAlert (DG_ERROR, "Stress test failure", GS::ValueToUniString (failedCount) + " stress test(s) failed, " +
+				 GS::ValueToUniString (superlinearCount) + " operation(s) scale superlinearly.", "See the report for the details.", "Ok");
+		return Error;
+	}
+
+	return NoError;
 }
 
 
@@ -606,10 +701,11 @@ static GSErrCode ListAllProperties (const API_Guid& elemGuid)
 {
 	GS::Array<API_PropertyDefinition> definitions;
 	ASSERT_NO_ERROR (ACAPI_Element_GetPropertyDefinitions (elemGuid, definitions));
+	// the guid identifies the definition, ACAPI_Element_GetProperties fills in the rest
 	GS::Array<API_Property> properties;
 	for (UInt32 i = 0; i < definitions.GetSize (); i++) {
 		API_Property property;
-		property.definition = definitions[i];
+		property.definition.guid = definitions[i].guid;
 		properties.Push (property);
 	}
 	ASSERT_NO_ERROR (ACAPI_Element_GetProperties (elemGuid, properties));
@@ -636,18 +732,27 @@ static GSErrCode SetAllPropertiesDefault (const API_Guid& elemGuid)
 {
 	GS::Array<API_PropertyDefinition> definitions;
 	ASSERT_NO_ERROR (ACAPI_Element_GetPropertyDefinitions (elemGuid, definitions));
+	// the guid identifies the definition, ACAPI_Element_GetProperties fills in the rest
 	GS::Array<API_Property> properties;
 	for (UInt32 i = 0; i < definitions.GetSize (); i++) {
 		API_Property property;
-		property.definition = definitions[i];
+		property.definition.guid = definitions[i].guid;
 		properties.Push (property);
 	}
 	ASSERT_NO_ERROR (ACAPI_Element_GetProperties (elemGuid, properties));
 
+	// only the custom values are written, the others are already default
+	GS::Array<API_Property> customProperties;
 	for (UInt32 i = 0; i < properties.GetSize (); i++) {
-		properties[i].isDefault = true;
+		if (!properties[i].isDefault) {
+			properties[i].isDefault = true;
+			customProperties.Push (properties[i]);
+		}
 	}
-	ASSERT_NO_ERROR (ACAPI_Element_SetProperties (elemGuid, properties));
+	if (customProperties.IsEmpty ()) {
+		return NoError;
+	}
+	ASSERT_NO_ERROR (ACAPI_Element_SetProperties (elemGuid, customProperties));
 
 	return NoError;
 }
@@ -663,10 +768,13 @@ static GSErrCode DeleteAllProperties (const API_Guid& elemGuid)
 	API_ElemCategoryValue catValue;
 	ASSERT_NO_ERROR (PropertyTestHelpers::GetElemCategoryValue (elemGuid, catValue));
 
+	// the definitions which are not available for the category are not written
+	PropertyTestBatch::AvailabilityEditor editor;
 	for (UInt32 i = 0; i < definitions.GetSize (); i++) {
-		definitions[i].availability.DeleteAll (catValue);
-		ASSERT_NO_ERROR (ACAPI_Property_ChangePropertyDefinition (definitions[i]));
+		editor.Remove (definitions[i].guid, catValue);
 	}
+	ASSERT_NO_ERROR (editor.Apply ());
+	editor.GetStatistics ().Report ("DeleteAllProperties");
 
 	return NoError;
 }
@@ -675,6 +783,33 @@ static GSErrCode DeleteAllProperties (const API_Guid& elemGuid)
 namespace SelectionProperties {
 
 
+/*-------------------------------------------------------------**
+** Sets the number of segments of all the selected curtain	   **
+**						walls to 10							   **
+**-------------------------------------------------------------*/
+static GSErrCode SetCurtainWallSegmentCount ()
+{
+	const GS::Array<API_Guid> selectedElements = PropertyTestHelpers::GetSelectedElements ();
+	PropertyTestHelpers::Progress progress ("SetCurtainWallSegmentCount", "Changing the curtain walls", selectedElements.GetSize ());
+
+	API_Variant segmentCount;
+	segmentCount.type = API_PropertyIntegerValueType;
+	segmentCount.intValue = 10;
+
+	// the editor skips the selected elements that are not curtain walls
+	PropertyTestBatch::BulkElementEditor editor;
+	editor.SetProgress (&progress);
+	for (UInt32 i = 0; i < selectedElements.GetSize (); ++i) {
+		editor.Add (selectedElements[i], "curtainWall.nSegments", segmentCount);
+	}
+	const GSErrCode error = editor.Run ();
+	editor.GetStatistics ().Report ("SetCurtainWallSegmentCount");
+
+	// the elements changed before the cancel are kept
+	return (error == APIERR_CANCEL) ? NoError : error;
+}
+
+
 /*--------------------------------------------------**
 **  Adds a new integer property that is available   **
 **		 for all of the selected elements			**
@@ -699,33 +834,29 @@ static GSErrCode SetAllIntPropertiesTo42 ()
 {
 	GS::Array<API_PropertyDefinition> definitions;
 	ACAPI_Property_GetPropertyDefinitions (APINULLGuid, definitions);
-	GS::Array<API_Guid> selectedElements = PropertyTestHelpers::GetSelectedElements();
 
+	PropertyTestHelpers::DefinitionTable intDefinitions;
 	for (UIndex i = 0; i < definitions.GetSize (); ++i) {
 		if (definitions[i].collectionType == API_PropertySingleCollectionType &&
 				 definitions[i].valueType == API_PropertyIntegerValueType) {
-			API_Property property;
-			property.definition = definitions[i];
-			property.value.singleVariant.variant.type = property.definition.valueType;
-			property.value.singleVariant.variant.intValue = 42;
-			property.isDefault = false;
-
-			// remove the elements from the list, which the property is not available for
-			// (if you don't remove them, APIERR_BADPROPERTYFORELEM will be returned)
-			GS::Array<API_Guid> filteredSelectedElements;
-
-			for (UIndex i = 0; i < selectedElements.GetSize (); ++i) {
-				API_ElemCategoryValue categoryValue;
-				ASSERT_NO_ERROR (PropertyTestHelpers::GetElemCategoryValue (selectedElements[i], categoryValue));
-				if (property.definition.availability.Contains (categoryValue)) {
-					filteredSelectedElements.Push (selectedElements[i]);
-				}
-			}
-
-			ASSERT_NO_ERROR (ACAPI_ElementList_ModifyPropertyValue (property, filteredSelectedElements));
+			intDefinitions.Add (definitions[i]);
 		}
 	}
-	return NoError;
+
+	const GS::Array<API_Guid> selectedElements = PropertyTestHelpers::GetSelectedElements ();
+	PropertyTestHelpers::Progress progress ("SetAllIntPropertiesTo42", "Setting the integer properties", selectedElements.GetSize ());
+
+	PropertyTestBatch::BulkPropertyUpdate update (intDefinitions, selectedElements);
+	update.SetProgress (&progress);
+	GSErrCode error = update.Run ([] (const API_PropertyDefinition& definition, const API_Guid&, const PropertyTestBatch::ElementValue&, API_PropertyValue& newValue) {
+		newValue.singleVariant.variant.type = definition.valueType;
+		newValue.singleVariant.variant.intValue = 42;
+		return true;
+	});
+	update.GetTimes ().Report ("SetAllIntPropertiesTo42");
+
+	// a canceled update writes nothing
+	return (error == APIERR_CANCEL) ? NoError : error;
 }
 
 
@@ -739,43 +870,429 @@ static GSErrCode DeleteIntegerPropeties ()
 	ACAPI_Property_GetPropertyDefinitions (APINULLGuid, definitions);
 	GS::Array<API_Guid> selectedElements = PropertyTestHelpers::GetSelectedElements();
 
+	// the distinct categories of the selected elements
+	API_ElemCategory category;
+	ASSERT_NO_ERROR (PropertyTestHelpers::GetElemClassificationCategory (category));
+	GS::Array<API_ElemCategoryValue> catValues;
+	for (UIndex i = 0; i < selectedElements.GetSize (); ++i) {
+		API_ElemCategoryValue catValue;
+		if (COLLECT_ERROR (ACAPI_Element_GetCategoryValue (selectedElements[i], category, &catValue)) != NoError) {
+			continue;
+		}
+		bool isNew = true;
+		for (UIndex j = 0; j < catValues.GetSize () && isNew; ++j) {
+			isNew = (catValues[j].guid != catValue.guid);
+		}
+		if (isNew) {
+			catValues.Push (catValue);
+		}
+	}
+
+	PropertyTestBatch::AvailabilityEditor editor;
 	for (UIndex i = 0; i < definitions.GetSize (); ++i) {
 		if (definitions[i].collectionType == API_PropertySingleCollectionType &&
 			definitions[i].valueType == API_PropertyIntegerValueType) {
-			ASSERT_NO_ERROR (ACAPI_ElementList_DeleteProperty (definitions[i].guid, selectedElements));
+			editor.Remove (definitions[i].guid, catValues);
 		}
 	}
+
+	PropertyTestHelpers::Progress progress ("DeleteIntegerPropeties", "Deleting the integer properties", 0);
+	const GSErrCode error = editor.Apply (&progress);
+	editor.GetStatistics ().Report ("DeleteIntegerPropeties");
+
+	// the definitions written before the cancel are kept
+	return (error == APIERR_CANCEL) ? NoError : error;
+}
+
+
+/*---------------------------------------------------------------------**
+** Selects all elements with the same type and classification as the  **
+**					first selected element							   **
+**---------------------------------------------------------------------*/
+static GSErrCode SelectSimilarElements (const API_Guid& elemGuid)
+{
+	API_Elem_Head elemHead;
+	BNZeroMemory (&elemHead, sizeof (API_Elem_Head));
+	elemHead.guid = elemGuid;
+	ASSERT_NO_ERROR (ACAPI_Element_GetHeader (&elemHead));
+
+	API_ElemCategoryValue catValue;
+	ASSERT_NO_ERROR (PropertyTestHelpers::GetElemCategoryValue (elemGuid, catValue));
+
+	UInt32 nSelected = 0;
+	PropertyTestHelpers::Progress progress ("SelectSimilarElements", "Collecting the elements", 0);
+	PropertyTestHelpers::SelectionBuilder builder;
+	builder.AddType (elemHead.typeID).SetClassification (catValue).SetFilterFlags (APIFilt_OnVisLayer | APIFilt_OnActFloor).SetProgress (&progress);
+	const GSErrCode error = builder.Select (false, &nSelected);
+	if (error == APIERR_CANCEL) {
+		return NoError;
+	}
+	ASSERT_NO_ERROR (error);
+
+	WriteReport ("SelectSimilarElements: %u %s element(s) selected", nSelected, ElemID_To_Name (elemHead.typeID));
+
 	return NoError;
 }
 
 } // namespace SelectionProperties
 
+
+namespace ProjectProperties {
+
+
+/*---------------------------------------------------------------------**
+** Saves the property values of every element of the project into a   **
+**		binary snapshot next to the project file; the snapshot it		**
+**				replaces is kept as the previous one					**
+**---------------------------------------------------------------------*/
+static GSErrCode SaveSnapshot ()
+{
+	IO::Location current;
+	IO::Location previous;
+	ASSERT_NO_ERROR (PropertyTestSnapshot::GetSnapshotLocations (current, previous));
+
+	PropertyTestSnapshot::SnapshotWriter writer;
+	{
+		PropertyTestHelpers::Progress progress ("SaveSnapshot", "Reading the properties", 0);
+		const GSErrCode error = PropertyTestSnapshot::CollectProject (writer, &progress);
+		if (error == APIERR_CANCEL) {
+			return NoError;
+		}
+		ASSERT_NO_ERROR (error);
+	}
+
+	std::vector<char> file;
+	writer.Build (file);
+
+	std::vector<char> previousFile;
+	if (PropertyTestSnapshot::LoadFile (current, previousFile) == NoError) {
+		ASSERT_NO_ERROR (PropertyTestSnapshot::SaveFile (previous, previousFile));
+	}
+	ASSERT_NO_ERROR (PropertyTestSnapshot::SaveFile (current, file));
+
+	GS::UniString path;
+	current.ToPath (&path);
+	WriteReport ("SaveSnapshot: %u element(s), %u value(s), %u byte(s) written to %s",
+				 writer.GetElementCount (), writer.GetValueCount (), static_cast<UInt32> (file.size ()), path.ToCStr ().Get ());
+
+	return NoError;
+}
+
+
+/*---------------------------------------------------------------**
+** Writes the differences of two property states of the project  **
+**			into <project name>.ptdiff.txt next to it			  **
+**---------------------------------------------------------------*/
+static GSErrCode WriteSnapshotDiff (const char* commandName, const std::vector<char>& oldFile, const std::vector<char>& newFile)
+{
+	PropertyTestSnapshot::SnapshotView oldState (oldFile.data (), oldFile.size ());
+	PropertyTestSnapshot::SnapshotView newState (newFile.data (), newFile.size ());
+	if (!oldState.IsValid () || !newState.IsValid ()) {
+		DGAlert (DG_ERROR, commandName, "The property snapshot is damaged or has an unknown version.", "", "Ok");
+		return NoError;
+	}
+
+	IO::Location diffLocation;
+	ASSERT_NO_ERROR (PropertyTestSnapshot::GetProjectFileLocation (".ptdiff.txt", diffLocation));
+
+	PropertyTestSnapshot::DiffStatistics statistics;
+	ASSERT_NO_ERROR (PropertyTestSnapshot::WriteDiff (oldState, newState, diffLocation, statistics));
+	statistics.Report (commandName);
+
+	GS::UniString path;
+	diffLocation.ToPath (&path);
+	WriteReport ("  differences written to %s", path.ToCStr ().Get ());
+
+	return NoError;
+}
+
+
+/*--------------------------------------------------------------**
+** Compares the current property values of the project with the **
+**					last saved snapshot							 **
+**--------------------------------------------------------------*/
+static GSErrCode CompareWithSnapshot ()
+{
+	IO::Location current;
+	IO::Location previous;
+	ASSERT_NO_ERROR (PropertyTestSnapshot::GetSnapshotLocations (current, previous));
+
+	std::vector<char> oldFile;
+	if (PropertyTestSnapshot::LoadFile (current, oldFile) != NoError) {
+		DGAlert (DG_INFORMATION, "CompareWithSnapshot", "There is no property snapshot of the project yet.", "", "Ok");
+		return NoError;
+	}
+
+	PropertyTestSnapshot::SnapshotWriter writer;
+	{
+		PropertyTestHelpers::Progress progress ("CompareWithSnapshot", "Reading the properties", 0);
+		const GSErrCode error = PropertyTestSnapshot::CollectProject (writer, &progress);
+		if (error == APIERR_CANCEL) {
+			return NoError;
+		}
+		ASSERT_NO_ERROR (error);
+	}
+
+	std::vector<char> newFile;
+	writer.Build (newFile);
+
+	return WriteSnapshotDiff ("CompareWithSnapshot", oldFile, newFile);
+}
+
+
+/*----------------------------------------------------**
+** Compares the last two saved snapshots of the project **
+**----------------------------------------------------*/
+static GSErrCode CompareLastTwoSnapshots ()
+{
+	IO::Location current;
+	IO::Location previous;
+	ASSERT_NO_ERROR (PropertyTestSnapshot::GetSnapshotLocations (current, previous));
+
+	std::vector<char> oldFile;
+	std::vector<char> newFile;
+	if (PropertyTestSnapshot::LoadFile (previous, oldFile) != NoError || PropertyTestSnapshot::LoadFile (current, newFile) != NoError) {
+		DGAlert (DG_INFORMATION, "CompareLastTwoSnapshots", "The project does not have two property snapshots yet.", "", "Ok");
+		return NoError;
+	}
+
+	return WriteSnapshotDiff ("CompareLastTwoSnapshots", oldFile, newFile);
+}
+
+
+/*----------------------------------------------------------------------**
+** Imports property values from <project name>.import.csv next to the   **
+**		project: element guid, property name, value in every row		 **
+**----------------------------------------------------------------------*/
+static GSErrCode ImportPropertyValues ()
+{
+	IO::Location location;
+	ASSERT_NO_ERROR (PropertyTestSnapshot::GetProjectFileLocation (".import.csv", location));
+
+	GS::Array<API_PropertyDefinition> definitions;
+	ASSERT_NO_ERROR (ACAPI_Property_GetPropertyDefinitions (APINULLGuid, definitions));
+
+	PropertyTestImport::ImportStatistics statistics;
+	{
+		PropertyTestHelpers::Progress progress ("ImportPropertyValues", "Reading the CSV file", 0);
+		const GSErrCode error = PropertyTestImport::ImportFile (location, definitions, &progress, statistics);
+		if (error == APIERR_CANCEL) {
+			return NoError;
+		}
+		if (error != NoError) {
+			GS::UniString path;
+			location.ToPath (&path);
+			DGAlert (DG_ERROR, "ImportPropertyValues", "Cannot read the file to import:", path, "Ok");
+			return NoError;
+		}
+	}
+
+	statistics.Report ("ImportPropertyValues");
+	return NoError;
+}
+
+
+/*-----------------------------------------------------------------**
+** Measures the speed of the CSV import on generated data, with	   **
+**		stand-in definitions and without writing the model		   **
+**-----------------------------------------------------------------*/
+static GSErrCode BenchmarkImport ()
+{
+	PropertyTestImport::ImportStatistics statistics;
+	PropertyTestImport::RunBenchmark (1000000, statistics);
+	statistics.Report ("BenchmarkImport (stand-in)");
+
+	return NoError;
+}
+
+
+
+/*----------------------------------------------------------------------**
+** Selects the elements of the project matching the query written into  **
+**			<project name>.query.txt next to the project				 **
+**----------------------------------------------------------------------*/
+static GSErrCode SelectByQuery ()
+{
+	IO::Location location;
+	ASSERT_NO_ERROR (PropertyTestSnapshot::GetProjectFileLocation (".query.txt", location));
+
+	std::vector<char> text;
+	if (PropertyTestSnapshot::LoadFile (location, text) != NoError) {
+		GS::UniString path;
+		location.ToPath (&path);
+		DGAlert (DG_INFORMATION, "SelectByQuery", "Write the query into the file:", path, "Ok");
+		return NoError;
+	}
+	text.push_back ('\0');
+
+	GS::Array<API_PropertyDefinition> definitions;
+	ASSERT_NO_ERROR (ACAPI_Property_GetPropertyDefinitions (APINULLGuid, definitions));
+
+	PropertyTestQuery::Query query;
+	std::string errorMessage;
+	if (!query.Compile (text.data (), definitions, errorMessage)) {
+		DGAlert (DG_ERROR, "SelectByQuery", "The query is not valid:", GS::UniString (errorMessage.c_str (), CC_UTF8), "Ok");
+		return NoError;
+	}
+
+	GS::Array<API_Guid> elemGuids;
+	ASSERT_NO_ERROR (PropertyTestHelpers::SelectionBuilder ().Collect (elemGuids));
+
+	PropertyTestQuery::ValueTable table (query.GetDefinitions (), elemGuids);
+	{
+		PropertyTestHelpers::Progress progress ("SelectByQuery", "Reading the properties", 0);
+		const GSErrCode error = table.Read (&progress);
+		if (error == APIERR_CANCEL) {
+			return NoError;
+		}
+		ASSERT_NO_ERROR (error);
+	}
+
+	PropertyTestBatch::Stopwatch stopwatch;
+	GS::Array<API_Guid> matchingElements;
+	query.Filter (table, matchingElements);
+	const double filterSeconds = stopwatch.GetSeconds ();
+
+	UInt32 nSelected = 0;
+	ASSERT_NO_ERROR (PropertyTestHelpers::SelectElements (matchingElements, false, &nSelected));
+
+	WriteReport ("SelectByQuery: %u of %u element(s) match, %u selected, filtered in %.3f ms",
+				 matchingElements.GetSize (), table.GetElementCount (), nSelected, filterSeconds * 1000.0);
+
+	return NoError;
+}
+
+
+/*--------------------------------------------------------------**
+** Measures the property queries on generated values of 100000  **
+**						stand-in elements						 **
+**--------------------------------------------------------------*/
+static GSErrCode BenchmarkQuery ()
+{
+	PropertyTestQuery::RunBenchmark (100000, "BenchmarkQuery (stand-in)");
+
+	return NoError;
+}
+
+
+/*----------------------------------------------------------------------**
+** Applies the property template <project name>.defaults.csv next to the **
+**	project to the tool defaults: element type (or * for every tool),	 **
+**				property name, value in every row						 **
+**----------------------------------------------------------------------*/
+static GSErrCode ApplyDefaultsTemplate ()
+{
+	IO::Location location;
+	ASSERT_NO_ERROR (PropertyTestSnapshot::GetProjectFileLocation (".defaults.csv", location));
+
+	GS::Array<API_PropertyDefinition> definitions;
+	ASSERT_NO_ERROR (ACAPI_Property_GetPropertyDefinitions (APINULLGuid, definitions));
+
+	PropertyTestDefaults::TemplateStatistics statistics;
+	GSErrCode error = NoError;
+	{
+		PropertyTestHelpers::Progress progress ("ApplyDefaultsTemplate", "Setting the tool defaults", 0);
+		error = PropertyTestDefaults::ApplyTemplateFile (location, definitions, &progress, statistics);
+	}
+	if (error != NoError && error != APIERR_CANCEL) {
+		GS::UniString path;
+		location.ToPath (&path);
+		DGAlert (DG_INFORMATION, "ApplyDefaultsTemplate", "Write the property template into the file:", path, "Ok");
+		return NoError;
+	}
+
+	// the tool defaults written before a cancel are kept
+	statistics.Report ("ApplyDefaultsTemplate");
+	return NoError;
+}
+
+} // namespace ProjectProperties
+
+// -----------------------------------------------------------------------------
+// Menu commands
+// -----------------------------------------------------------------------------
+
+static GSErrCode RunMenuCommand (short itemIndex)
+{
+	switch (itemIndex) {
+		case  1: return SelectionProperties::SetCurtainWallSegmentCount ();
+		case  2: return PropertyTestHelpers::CallOnSelectedElem (DefineNewStringListProperty);
+		case  3: return PropertyTestHelpers::CallOnSelectedElem (DefineStringMultiEnumtProperty);
+		case  4: return NoError; // "-"
+		case  5: return PropertyTestHelpers::CallOnSelectedElem (ListAllProperties);
+		case  6: return PropertyTestHelpers::CallOnSelectedElem (SetAllPropertiesDefault);
+		case  7: return PropertyTestHelpers::CallOnSelectedElem (DeleteAllProperties);
+		case  8: return NoError; // "-"
+		case  9: return SelectionProperties::DefineNewIntProperty ();
+		case 10: return SelectionProperties::SetAllIntPropertiesTo42 ();
+		case 11: return SelectionProperties::DeleteIntegerPropeties ();
+		case 12: return NoError; // "-"
+		case 13: return RunTestsOnSelectedElem ();
+		case 14: return NoError; // "-"
+		case 15: return PropertyTestHelpers::CallOnSelectedElem (SelectionProperties::SelectSimilarElements);
+		case 16: return NoError; // "-"
+		case 17: return ProjectProperties::SaveSnapshot ();
+		case 18: return ProjectProperties::CompareWithSnapshot ();
+		case 19: return ProjectProperties::CompareLastTwoSnapshots ();
+		case 20: return NoError; // "-"
+		case 21: return ProjectProperties::ImportPropertyValues ();
+		case 22: return ProjectProperties::BenchmarkImport ();
+		case 23: return NoError; // "-"
+		case 24: return ProjectProperties::SelectByQuery ();
+		case 25: return ProjectProperties::BenchmarkQuery ();
+		case 26: return NoError; // "-"
+		case 27: return BenchmarkPropertyTests ();
+		case 28: return NoError; // "-"
+		case 29: return StressTestPropertyObjects ();
+		case 30: return NoError; // "-"
+		case 31: return ProjectProperties::ApplyDefaultsTemplate ();
+		default: return NoError;
+	}
+}
+
+
+/*------------------------------------------------------------------**
+** Commands that only read the model (selection changes included)  **
+**	run without opening an undo step and the database transaction  **
+**------------------------------------------------------------------*/
+static bool IsReadOnlyMenuCommand (short itemIndex)
+{
+	switch (itemIndex) {
+		case  5:	// ListAllProperties
+		case 15:	// SelectSimilarElements
+		case 17:	// SaveSnapshot
+		case 18:	// CompareWithSnapshot
+		case 19:	// CompareLastTwoSnapshots
+		case 22:	// BenchmarkImport
+		case 24:	// SelectByQuery
+		case 25:	// BenchmarkQuery
+			return true;
+		default:
+			return false;
+	}
+}
+
+
 // -----------------------------------------------------------------------------
 // Add-on entry point definition
 // -----------------------------------------------------------------------------
 GSErrCode __ACENV_CALL APIMenuCommandProc_Main (const API_MenuParams *menuParams)
 {
 	if (menuParams->menuItemRef.menuResID == 32500) {
-		GSErrCode errorCode = ACAPI_CallUndoableCommand ("Property Test API Function",
-			[&] () -> GSErrCode {
-				switch (menuParams->menuItemRef.itemIndex) {
-					case  1: return PropertyTestHelpers::CallOnSelectedElem (DefineNewBoolProperty);
-					case  2: return PropertyTestHelpers::CallOnSelectedElem (DefineNewStringListProperty);
-					case  3: return PropertyTestHelpers::CallOnSelectedElem (DefineStringMultiEnumtProperty);
-					case  4: return NoError; // "-"
-					case  5: return PropertyTestHelpers::CallOnSelectedElem (ListAllProperties);
-					case  6: return PropertyTestHelpers::CallOnSelectedElem (SetAllPropertiesDefault);
-					case  7: return PropertyTestHelpers::CallOnSelectedElem (DeleteAllProperties);
-					case  8: return NoError; // "-"
-					case  9: return SelectionProperties::DefineNewIntProperty ();
-					case 10: return SelectionProperties::SetAllIntPropertiesTo42 ();
-					case 11: return SelectionProperties::DeleteIntegerPropeties ();
-					case 12: return NoError; // "-"
-					case 13: return RunTestsOnSelectedElem ();
-					default: return NoError;
-			}
-		});
+		const short itemIndex = menuParams->menuItemRef.itemIndex;
+
+		PropertyTestHelpers::ErrorLog errorLog;
+		GSErrCode errorCode = NoError;
+		if (IsReadOnlyMenuCommand (itemIndex)) {
+			errorCode = RunMenuCommand (itemIndex);
+		} else {
+			errorCode = ACAPI_CallUndoableCommand ("Property Test API Function",
+				[&] () -> GSErrCode {
+					return RunMenuCommand (itemIndex);
+				});
+		}
 
+		errorLog.ReportSummary ("Property Test API Function");
 		return errorCode;
 	}
 	return NoError;
@@ -785,7 +1302,19 @@ GSErrCode __ACENV_CALL APIMenuCommandProc_Main (const API_MenuParams *menuParams
 GSErrCode __ACENV_CALL APIMenuCommandProc_Lister (const API_MenuParams *menuParams)
 {
 	if (menuParams->menuItemRef.menuResID == 32501) {
-		// Lister
+		// Lister: the properties of the selection, or of the whole project if nothing is selected
+		PropertyTestHelpers::ErrorLog errorLog;
+		GS::Array<API_Guid> elemGuids = PropertyTestHelpers::GetSelectedElements (false);
+		GSErrCode errorCode = NoError;
+		if (elemGuids.IsEmpty ()) {
+			errorCode = PropertyTestHelpers::SelectionBuilder ().Collect (elemGuids);
+		}
+		if (errorCode == NoError) {
+			errorCode = PropertyTestBrowser::ShowPropertyBrowser (elemGuids);
+		}
+
+		errorLog.ReportSummary ("Lister");
+		return errorCode;
 	}
 	return NoError;
 }		// APIMenuCommandProc_Lister
@@ -849,5 +1378,6 @@ GSErrCode	__ACENV_CALL Initialize	(void)
 
 GSErrCode	__ACENV_CALL FreeData	(void)
 {
+	PropertyTestHelpers::WorkerPool::Shutdown ();
 	return NoError;
 }
@@ -0,0 +1,236 @@
+// *****************************************************************************
+// File:			Property_Test_Availability.cpp
+// Description:		Property_Test add-on batched availability editing
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestBatch
+// Contact person:	CSAT
+// *****************************************************************************
+
+#include "Property_Test_Availability.hpp"
+#include "Property_Test_Batch.hpp"
+#include "Property_Test_Helpers.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+
+static bool GuidLess (const API_Guid& lhs, const API_Guid& rhs)
+{
+	return std::memcmp (&lhs, &rhs, sizeof (API_Guid)) < 0;
+}
+
+
+static bool FindCategory (const GS::Array<API_ElemCategoryValue>& categories, const API_Guid& categoryGuid, UInt32& index)
+{
+	for (UInt32 i = 0; i < categories.GetSize (); ++i) {
+		if (categories[i].guid == categoryGuid) {
+			index = i;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+// -----------------------------------------------------------------------------
+// AvailabilityStatistics
+// -----------------------------------------------------------------------------
+
+PropertyTestBatch::AvailabilityStatistics::AvailabilityStatistics () :
+	editCount (0),
+	editedDefinitionCount (0),
+	changedDefinitionCount (0),
+	unchangedDefinitionCount (0),
+	unknownDefinitionCount (0),
+	failedDefinitionCount (0),
+	readSeconds (0.0),
+	writeSeconds (0.0)
+{
+}
+
+
+void PropertyTestBatch::AvailabilityStatistics::Report (const char* commandName) const
+{
+	WriteReport ("%s: %u availability edit(s) of %u definition(s), %u changed, %u already up to date, %u unknown",
+				 commandName, editCount, editedDefinitionCount, changedDefinitionCount, unchangedDefinitionCount, unknownDefinitionCount);
+	WriteReport ("  read    %8.3f s", readSeconds);
+	WriteReport ("  write   %8.3f s in %u call(s)", writeSeconds, changedDefinitionCount);
+	if (failedDefinitionCount > 0) {
+		WriteReport ("  %u definition(s) could not be written", failedDefinitionCount);
+	}
+}
+
+
+// -----------------------------------------------------------------------------
+// AvailabilityEditor
+// -----------------------------------------------------------------------------
+
+PropertyTestBatch::AvailabilityEditor::AvailabilityEditor ()
+{
+}
+
+
+void PropertyTestBatch::AvailabilityEditor::Add (const API_Guid& definitionGuid, const API_ElemCategoryValue& category)
+{
+	Edit edit;
+	edit.definitionGuid = definitionGuid;
+	edit.category = category;
+	edit.add = true;
+	edit.order = static_cast<UInt32> (edits.size ());
+	edits.push_back (edit);
+}
+
+
+void PropertyTestBatch::AvailabilityEditor::Add (const API_Guid& definitionGuid, const GS::Array<API_ElemCategoryValue>& categories)
+{
+	for (UInt32 i = 0; i < categories.GetSize (); ++i) {
+		Add (definitionGuid, categories[i]);
+	}
+}
+
+
+void PropertyTestBatch::AvailabilityEditor::Remove (const API_Guid& definitionGuid, const API_ElemCategoryValue& category)
+{
+	Edit edit;
+	edit.definitionGuid = definitionGuid;
+	edit.category = category;
+	edit.add = false;
+	edit.order = static_cast<UInt32> (edits.size ());
+	edits.push_back (edit);
+}
+
+
+void PropertyTestBatch::AvailabilityEditor::Remove (const API_Guid& definitionGuid, const GS::Array<API_ElemCategoryValue>& categories)
+{
+	for (UInt32 i = 0; i < categories.GetSize (); ++i) {
+		Remove (definitionGuid, categories[i]);
+	}
+}
+
+
+void PropertyTestBatch::AvailabilityEditor::Clear ()
+{
+	edits.clear ();
+}
+
+
+UInt32 PropertyTestBatch::AvailabilityEditor::GetEditCount () const
+{
+	return static_cast<UInt32> (edits.size ());
+}
+
+
+bool PropertyTestBatch::AvailabilityEditor::ApplyEdits (GS::Array<API_ElemCategoryValue>& availability, const Edit* begin, const Edit* end)
+{
+	const GS::Array<API_ElemCategoryValue> original = availability;
+
+	for (const Edit* edit = begin; edit != end; ++edit) {
+		UInt32 index = 0;
+		if (edit->add) {
+			if (!FindCategory (availability, edit->category.guid, index)) {
+				availability.Push (edit->category);
+			}
+		} else {
+			while (FindCategory (availability, edit->category.guid, index)) {
+				availability.Delete (index);
+			}
+		}
+	}
+
+	// compared as sets: adding and then removing a category is no change
+	if (availability.GetSize () != original.GetSize ()) {
+		return true;
+	}
+	for (UInt32 i = 0; i < original.GetSize (); ++i) {
+		UInt32 index = 0;
+		if (!FindCategory (availability, original[i].guid, index)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+
+GSErrCode PropertyTestBatch::AvailabilityEditor::Apply (PropertyTestHelpers::Progress* progress /* = nullptr*/)
+{
+	statistics = AvailabilityStatistics ();
+	statistics.editCount = static_cast<UInt32> (edits.size ());
+	if (edits.empty ()) {
+		return NoError;
+	}
+
+	Stopwatch stopwatch;
+
+	// the edits of a definition are next to each other, in the order they were added
+	std::sort (edits.begin (), edits.end (), [] (const Edit& lhs, const Edit& rhs) {
+		const int compare = std::memcmp (&lhs.definitionGuid, &rhs.definitionGuid, sizeof (API_Guid));
+		return compare < 0 || (compare == 0 && lhs.order < rhs.order);
+	});
+	for (size_t i = 0; i < edits.size (); ++i) {
+		if (i == 0 || edits[i].definitionGuid != edits[i - 1].definitionGuid) {
+			++statistics.editedDefinitionCount;
+		}
+	}
+
+	// one call reads every definition
+	GS::Array<API_PropertyDefinition> definitions;
+	GSErrCode error = ACAPI_Property_GetPropertyDefinitions (APINULLGuid, definitions);
+	if (error != NoError) {
+		return error;
+	}
+
+	GS::Array<API_PropertyDefinition> changedDefinitions;
+	UInt32 foundDefinitionCount = 0;
+	for (UInt32 i = 0; i < definitions.GetSize (); ++i) {
+		const API_Guid& definitionGuid = definitions[i].guid;
+		const auto begin = std::lower_bound (edits.begin (), edits.end (), definitionGuid, [] (const Edit& edit, const API_Guid& guid) {
+			return GuidLess (edit.definitionGuid, guid);
+		});
+		if (begin == edits.end () || begin->definitionGuid != definitionGuid) {
+			continue;
+		}
+		const auto end = std::upper_bound (begin, edits.end (), definitionGuid, [] (const API_Guid& guid, const Edit& edit) {
+			return GuidLess (guid, edit.definitionGuid);
+		});
+
+		++foundDefinitionCount;
+		const Edit* firstEdit = edits.data () + (begin - edits.begin ());
+		const Edit* lastEdit = edits.data () + (end - edits.begin ());
+		if (ApplyEdits (definitions[i].availability, firstEdit, lastEdit)) {
+			changedDefinitions.Push (definitions[i]);
+		} else {
+			++statistics.unchangedDefinitionCount;
+		}
+	}
+	statistics.unknownDefinitionCount = statistics.editedDefinitionCount - foundDefinitionCount;
+	statistics.changedDefinitionCount = changedDefinitions.GetSize ();
+	statistics.readSeconds = stopwatch.GetSeconds ();
+
+	// each changed definition is written once
+	stopwatch.Restart ();
+	if (progress != nullptr) {
+		progress->SetItemCount (changedDefinitions.GetSize ());
+	}
+	for (UInt32 i = 0; i < changedDefinitions.GetSize (); ++i) {
+		if (progress != nullptr) {
+			if (progress->IsCanceled ()) {
+				error = APIERR_CANCEL;
+				break;
+			}
+			progress->Advance ();
+		}
+
+		if (COLLECT_ERROR (ACAPI_Property_ChangePropertyDefinition (changedDefinitions[i])) != NoError) {
+			++statistics.failedDefinitionCount;
+		}
+	}
+	statistics.writeSeconds = stopwatch.GetSeconds ();
+
+	return error;
+}
+
+
+const PropertyTestBatch::AvailabilityStatistics& PropertyTestBatch::AvailabilityEditor::GetStatistics () const
+{
+	return statistics;
+}
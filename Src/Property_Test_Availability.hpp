@@ -0,0 +1,84 @@
+// *****************************************************************************
+// File:			Property_Test_Availability.hpp
+// Description:		Property_Test add-on batched availability editing
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestBatch
+// Contact person:	CSAT
+// *****************************************************************************
+
+#if !defined (AVAILABILITY_HPP)
+#define	AVAILABILITY_HPP
+
+#include "Property_Test.hpp"
+#include "Property_Test_Progress.hpp"
+
+#include <vector>
+
+namespace PropertyTestBatch
+{
+
+// -----------------------------------------------------------------------------
+// Statistics of one AvailabilityEditor::Apply
+// -----------------------------------------------------------------------------
+
+struct AvailabilityStatistics {
+	UInt32		editCount;
+	UInt32		editedDefinitionCount;
+	UInt32		changedDefinitionCount;		// written
+	UInt32		unchangedDefinitionCount;	// the edits cancel out or were already done: not written
+	UInt32		unknownDefinitionCount;
+	UInt32		failedDefinitionCount;
+	double		readSeconds;
+	double		writeSeconds;
+
+	AvailabilityStatistics ();
+
+	void		Report (const char* commandName) const;
+};
+
+
+// -----------------------------------------------------------------------------
+// Collects the categories to add to or remove from the availability of
+// property definitions and applies them together:
+//	- the definitions are read in one call
+//	- the final availability of each definition is computed in memory, the
+//	  edits of a definition applied in the order they were added
+//	- each definition whose availability has changed is written once with
+//	  ACAPI_Property_ChangePropertyDefinition, the others are not written
+// The categories are compared by guid.
+// -----------------------------------------------------------------------------
+
+class AvailabilityEditor
+{
+public:
+	AvailabilityEditor ();
+
+	void		Add (const API_Guid& definitionGuid, const API_ElemCategoryValue& category);
+	void		Add (const API_Guid& definitionGuid, const GS::Array<API_ElemCategoryValue>& categories);
+	void		Remove (const API_Guid& definitionGuid, const API_ElemCategoryValue& category);
+	void		Remove (const API_Guid& definitionGuid, const GS::Array<API_ElemCategoryValue>& categories);
+	void		Clear ();
+
+	UInt32		GetEditCount () const;
+
+	GSErrCode	Apply (PropertyTestHelpers::Progress* progress = nullptr);		// APIERR_CANCEL if canceled
+
+	const AvailabilityStatistics&	GetStatistics () const;
+
+private:
+	struct Edit {
+		API_Guid				definitionGuid;
+		API_ElemCategoryValue	category;
+		bool					add;
+		UInt32					order;
+	};
+
+	static bool	ApplyEdits (GS::Array<API_ElemCategoryValue>& availability, const Edit* begin, const Edit* end);
+
+	std::vector<Edit>			edits;
+	AvailabilityStatistics		statistics;
+};
+
+}
+
+#endif
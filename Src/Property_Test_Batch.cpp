@@ -0,0 +1,487 @@
+// *****************************************************************************
+// File:			Property_Test_Batch.cpp
+// Description:		Property_Test add-on bulk property update engine
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestBatch
+// Contact person:	CSAT
+// *****************************************************************************
+
+#include "Property_Test_Batch.hpp"
+#include "Property_Test_Helpers.hpp"
+#include "Property_Test_WorkerPool.hpp"
+
+// Smallest number of values computed by one task
+static const UInt32 MinComputeChunkSize = 256;
+
+
+// -----------------------------------------------------------------------------
+// Stopwatch
+// -----------------------------------------------------------------------------
+
+PropertyTestBatch::Stopwatch::Stopwatch () :
+	start (std::chrono::steady_clock::now ())
+{
+}
+
+
+void PropertyTestBatch::Stopwatch::Restart ()
+{
+	start = std::chrono::steady_clock::now ();
+}
+
+
+double PropertyTestBatch::Stopwatch::GetSeconds () const
+{
+	return std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+}
+
+
+// -----------------------------------------------------------------------------
+// PhaseTimes
+// -----------------------------------------------------------------------------
+
+PropertyTestBatch::PhaseTimes::PhaseTimes () :
+	readSeconds (0.0),
+	computeSeconds (0.0),
+	computeWaitSeconds (0.0),
+	writeSeconds (0.0),
+	totalSeconds (0.0),
+	elementCount (0),
+	batchCount (0),
+	valueCount (0),
+	changedValueCount (0),
+	unchangedValueCount (0),
+	distinctValueCount (0),
+	writeCallCount (0),
+	writeChunkCount (0),
+	failedChunkCount (0),
+	failedValueCount (0),
+	threadCount (0),
+	plannedBatchCount (0),
+	canceled (false)
+{
+}
+
+
+void PropertyTestBatch::PhaseTimes::Report (const char* commandName) const
+{
+	WriteReport ("%s: %u element(s) in %u batch(es), %u value(s) read, %u changed, %u already up to date", commandName, elementCount, batchCount, valueCount, changedValueCount, unchangedValueCount);
+	WriteReport ("  read    %8.3f s", readSeconds);
+	WriteReport ("  compute %8.3f s of work on %u thread(s), main thread waited %.3f s", computeSeconds, threadCount, computeWaitSeconds);
+	WriteReport ("  write   %8.3f s in %u call(s) for %u distinct value(s), %.1f value(s) per call", writeSeconds, writeCallCount, distinctValueCount,
+				 (writeCallCount > 0) ? static_cast<double> (changedValueCount) / writeCallCount : 0.0);
+	if (failedChunkCount > 0) {
+		WriteReport ("  %u of %u chunk(s) failed, %u value(s) could not be written", failedChunkCount, writeChunkCount, failedValueCount);
+	}
+	WriteReport ("  total   %8.3f s", totalSeconds);
+	if (canceled) {
+		WriteReport ("  canceled by the user after %u of %u batch(es), nothing was written", plannedBatchCount, batchCount);
+	}
+}
+
+
+// -----------------------------------------------------------------------------
+// WritePlanner
+// -----------------------------------------------------------------------------
+
+PropertyTestBatch::WritePlanner::WritePlanner (const PropertyTestHelpers::DefinitionTable& definitionsToWrite) :
+	definitions (definitionsToWrite),
+	valueCount (0),
+	chunkSize (DefaultChunkSize)
+{
+}
+
+
+void PropertyTestBatch::WritePlanner::SetChunkSize (UInt32 elementsPerChunk)
+{
+	chunkSize = (elementsPerChunk > 0) ? elementsPerChunk : 1;
+}
+
+
+void PropertyTestBatch::WritePlanner::Add (UInt32 definitionIndex, const API_Guid& elemGuid, const API_PropertyValue& value)
+{
+	GetBucket (definitionIndex, false, value).elemGuids.Push (elemGuid);
+	++valueCount;
+}
+
+
+void PropertyTestBatch::WritePlanner::Add (UInt32 definitionIndex, const GS::Array<API_Guid>& elemGuids, const API_PropertyValue& value)
+{
+	if (elemGuids.IsEmpty ()) {
+		return;
+	}
+
+	GS::Array<API_Guid>& bucketGuids = GetBucket (definitionIndex, false, value).elemGuids;
+	bucketGuids.SetCapacity (bucketGuids.GetSize () + elemGuids.GetSize ());
+	for (UInt32 i = 0; i < elemGuids.GetSize (); ++i) {
+		bucketGuids.Push (elemGuids[i]);
+	}
+	valueCount += elemGuids.GetSize ();
+}
+
+
+void PropertyTestBatch::WritePlanner::AddDefault (UInt32 definitionIndex, const API_Guid& elemGuid)
+{
+	GetBucket (definitionIndex, true, API_PropertyValue ()).elemGuids.Push (elemGuid);
+	++valueCount;
+}
+
+
+void PropertyTestBatch::WritePlanner::Clear ()
+{
+	buckets.clear ();
+	bucketIndices.clear ();
+	valueCount = 0;
+	chunkResults.clear ();
+	failedElements.Clear ();
+}
+
+
+UInt32 PropertyTestBatch::WritePlanner::GetValueCount () const
+{
+	return valueCount;
+}
+
+
+UInt32 PropertyTestBatch::WritePlanner::GetBucketCount () const
+{
+	return static_cast<UInt32> (buckets.size ());
+}
+
+
+PropertyTestBatch::WritePlanner::Bucket& PropertyTestBatch::WritePlanner::GetBucket (UInt32 definitionIndex, bool isDefault, const API_PropertyValue& value)
+{
+	const API_PropertyCollectionType collType = definitions[definitionIndex].collectionType;
+	const ULong hash = (isDefault ? 0 : GenerateHashValue (value, collType)) ^ (definitionIndex * 0x9e3779b1) ^ (isDefault ? 1 : 0);
+
+	auto range = bucketIndices.equal_range (hash);
+	for (auto it = range.first; it != range.second; ++it) {
+		Bucket& bucket = buckets[it->second];
+		if (bucket.definitionIndex == definitionIndex && bucket.isDefault == isDefault &&
+			(isDefault || Equals (bucket.value, value, collType))) {
+			return bucket;
+		}
+	}
+
+	Bucket bucket;
+	bucket.definitionIndex = definitionIndex;
+	bucket.isDefault = isDefault;
+	bucket.value = value;
+	bucketIndices.emplace (hash, static_cast<UInt32> (buckets.size ()));
+	buckets.push_back (bucket);
+	return buckets.back ();
+}
+
+
+UInt32 PropertyTestBatch::WritePlanner::Execute ()
+{
+	UInt32 callCount = 0;
+
+	API_Property property;
+	for (const Bucket& bucket : buckets) {
+		definitions.MakeProperty (bucket.definitionIndex, bucket.isDefault, bucket.value, property);
+
+		const UInt32 elemCount = bucket.elemGuids.GetSize ();
+		for (UInt32 begin = 0; begin < elemCount; begin += chunkSize) {
+			ChunkResult result;
+			result.definitionIndex = bucket.definitionIndex;
+			result.elemCount = (elemCount - begin > chunkSize) ? chunkSize : elemCount - begin;
+			result.failedElemCount = 0;
+			result.callCount = 0;
+			result.firstError = NoError;
+
+			WriteChunk (property, bucket.elemGuids, begin, begin + result.elemCount, result);
+
+			callCount += result.callCount;
+			chunkResults.push_back (result);
+		}
+	}
+
+	return callCount;
+}
+
+
+void PropertyTestBatch::WritePlanner::WriteChunk (const API_Property& property, const GS::Array<API_Guid>& elemGuids, UInt32 begin, UInt32 end, ChunkResult& result)
+{
+	GS::Array<API_Guid> chunk;
+	if (begin == 0 && end == elemGuids.GetSize ()) {
+		chunk = elemGuids;
+	} else {
+		chunk.SetCapacity (end - begin);
+		for (UInt32 i = begin; i < end; ++i) {
+			chunk.Push (elemGuids[i]);
+		}
+	}
+
+	++result.callCount;
+	const GSErrCode error = ACAPI_ElementList_ModifyPropertyValue (property, chunk);
+	if (error == NoError) {
+		return;
+	}
+
+	if (result.firstError == NoError) {
+		result.firstError = error;
+	}
+
+	if (end - begin == 1) {
+		// isolated: only this element is left unchanged
+		PropertyTestHelpers::CollectError (error, "ACAPI_ElementList_ModifyPropertyValue (property, chunk)", __FILE__, __LINE__, __FUNCTION__);
+		failedElements.Push (elemGuids[begin]);
+		++result.failedElemCount;
+		return;
+	}
+
+	const UInt32 middle = begin + (end - begin) / 2;
+	WriteChunk (property, elemGuids, begin, middle, result);
+	WriteChunk (property, elemGuids, middle, end, result);
+}
+
+
+const std::vector<PropertyTestBatch::ChunkResult>& PropertyTestBatch::WritePlanner::GetChunkResults () const
+{
+	return chunkResults;
+}
+
+
+const GS::Array<API_Guid>& PropertyTestBatch::WritePlanner::GetFailedElements () const
+{
+	return failedElements;
+}
+
+
+// -----------------------------------------------------------------------------
+// BulkPropertyUpdate
+// -----------------------------------------------------------------------------
+
+PropertyTestBatch::BulkPropertyUpdate::BulkPropertyUpdate (const PropertyTestHelpers::DefinitionTable& definitionsToUpdate, const GS::Array<API_Guid>& elementsToUpdate) :
+	definitions (definitionsToUpdate),
+	elements (elementsToUpdate),
+	batchSize (DefaultBatchSize),
+	progress (nullptr),
+	computeNanoseconds (0),
+	unchangedValues (0),
+	planner (definitionsToUpdate)
+{
+	times.elementCount = elements.GetSize ();
+}
+
+
+void PropertyTestBatch::BulkPropertyUpdate::SetBatchSize (UInt32 elementsPerBatch)
+{
+	batchSize = (elementsPerBatch > 0) ? elementsPerBatch : 1;
+}
+
+
+void PropertyTestBatch::BulkPropertyUpdate::SetWriteChunkSize (UInt32 elementsPerChunk)
+{
+	planner.SetChunkSize (elementsPerChunk);
+}
+
+
+void PropertyTestBatch::BulkPropertyUpdate::SetProgress (PropertyTestHelpers::Progress* progressToReport)
+{
+	progress = progressToReport;
+}
+
+
+GSErrCode PropertyTestBatch::BulkPropertyUpdate::Run (const ComputeFunction& compute)
+{
+	Stopwatch totalStopwatch;
+
+	GSErrCode error = PropertyTestHelpers::GetElemClassificationCategory (classificationCategory);
+	if (error != NoError) {
+		return error;
+	}
+
+	const UInt32 batchCount = (elements.GetSize () + batchSize - 1) / batchSize;
+	times.batchCount = batchCount;
+	times.threadCount = PropertyTestHelpers::WorkerPool::Get ().GetWorkerCount ();
+	if (batchCount == 0) {
+		return NoError;
+	}
+
+	// the compute tasks of the batch in flight reference these buffers,
+	// so they are waited for even if the main thread throws
+	Batch batches[3];
+	struct ComputeGuard {
+		bool running = false;
+		~ComputeGuard ()
+		{
+			if (running) {
+				try {
+					PropertyTestHelpers::WorkerPool::Get ().Wait ();
+				} catch (...) {
+				}
+			}
+		}
+	} computeGuard;
+
+	Read (batches[0], 0);
+	StartCompute (batches[0], compute);
+	computeGuard.running = true;
+	if (batchCount > 1) {
+		Read (batches[1], 1);
+	}
+
+	for (UInt32 n = 0; n < batchCount; ++n) {
+		computeGuard.running = false;
+		FinishCompute ();
+
+		// no compute is in flight here, so it can stop at once: the planned values are dropped
+		if (progress != nullptr && progress->IsCanceled ()) {
+			times.canceled = true;
+			break;
+		}
+
+		if (n + 1 < batchCount) {
+			StartCompute (batches[(n + 1) % 3], compute);
+			computeGuard.running = true;
+		}
+		if (n + 2 < batchCount) {
+			Read (batches[(n + 2) % 3], n + 2);
+		}
+		Plan (batches[n % 3]);
+
+		++times.plannedBatchCount;
+		if (progress != nullptr) {
+			progress->Advance (batches[n % 3].elemEnd - batches[n % 3].elemBegin);
+		}
+	}
+
+	if (!times.canceled) {
+		Write ();
+	}
+
+	times.computeSeconds = computeNanoseconds / 1e9;
+	times.unchangedValueCount = unchangedValues;
+	times.totalSeconds = totalStopwatch.GetSeconds ();
+
+	return times.canceled ? APIERR_CANCEL : NoError;
+}
+
+
+const PropertyTestBatch::PhaseTimes& PropertyTestBatch::BulkPropertyUpdate::GetTimes () const
+{
+	return times;
+}
+
+
+void PropertyTestBatch::BulkPropertyUpdate::Read (Batch& batch, UInt32 batchIndex)
+{
+	Stopwatch stopwatch;
+
+	batch.elemBegin = batchIndex * batchSize;
+	batch.elemEnd = (elements.GetSize () - batch.elemBegin > batchSize) ? batch.elemBegin + batchSize : elements.GetSize ();
+	batch.values.clear ();
+	batch.values.reserve (batch.elemEnd - batch.elemBegin);
+
+	GS::Array<API_Property>	properties;
+	GS::Array<UInt32>		definitionIndices;
+	for (UInt32 elemIndex = batch.elemBegin; elemIndex < batch.elemEnd; ++elemIndex) {
+		// remove the definitions which are not available for the element
+		// (if you don't remove them, APIERR_BADPROPERTYFORELEM will be returned)
+		API_ElemCategoryValue catValue;
+		if (COLLECT_ERROR (ACAPI_Element_GetCategoryValue (elements[elemIndex], classificationCategory, &catValue)) != NoError) {
+			continue;
+		}
+
+		properties.Clear ();
+		definitionIndices.Clear ();
+		for (UInt32 definitionIndex = 0; definitionIndex < definitions.GetSize (); ++definitionIndex) {
+			if (PropertyTestHelpers::IsPropertyAvailable (definitions[definitionIndex], catValue)) {
+				API_Property property;
+				definitions.MakeRequest (definitionIndex, property);
+				properties.Push (property);
+				definitionIndices.Push (definitionIndex);
+			}
+		}
+		if (properties.IsEmpty ()) {
+			continue;
+		}
+
+		// one call reads all the values of the element
+		if (COLLECT_ERROR (ACAPI_Element_GetProperties (elements[elemIndex], properties)) != NoError) {
+			continue;
+		}
+
+		for (UInt32 i = 0; i < properties.GetSize (); ++i) {
+			ElementValue value;
+			value.elemIndex = elemIndex;
+			value.definitionIndex = definitionIndices[i];
+			value.isDefault = properties[i].isDefault;
+			value.value = properties[i].value;
+			batch.values.push_back (value);
+		}
+	}
+
+	times.valueCount += static_cast<UInt32> (batch.values.size ());
+	times.readSeconds += stopwatch.GetSeconds ();
+}
+
+
+void PropertyTestBatch::BulkPropertyUpdate::StartCompute (Batch& batch, const ComputeFunction& compute)
+{
+	batch.targets.clear ();
+	batch.targets.resize (batch.values.size ());
+
+	PropertyTestHelpers::WorkerPool::Get ().ParallelForAsync (static_cast<UInt32> (batch.values.size ()), MinComputeChunkSize,
+		[this, &batch, &compute] (UInt32 begin, UInt32 end) {
+			Stopwatch stopwatch;
+			UInt32 unchangedCount = 0;
+			for (UInt32 i = begin; i < end; ++i) {
+				const ElementValue& value = batch.values[i];
+				const API_PropertyDefinition& definition = definitions[value.definitionIndex];
+				Target& target = batch.targets[i];
+				target.changed = compute (definition, elements[value.elemIndex], value, target.value);
+
+				// diff stage: a custom value that is equal to the target would be a no-op write
+				if (target.changed && !value.isDefault && Equals (value.value, target.value, definition.collectionType)) {
+					target.changed = false;
+					++unchangedCount;
+				}
+			}
+			unchangedValues += unchangedCount;
+			computeNanoseconds += static_cast<Int64> (stopwatch.GetSeconds () * 1e9);
+		});
+}
+
+
+void PropertyTestBatch::BulkPropertyUpdate::FinishCompute ()
+{
+	Stopwatch stopwatch;
+	PropertyTestHelpers::WorkerPool::Get ().Wait ();
+	times.computeWaitSeconds += stopwatch.GetSeconds ();
+}
+
+
+void PropertyTestBatch::BulkPropertyUpdate::Plan (const Batch& batch)
+{
+	Stopwatch stopwatch;
+
+	for (UInt32 i = 0; i < batch.values.size (); ++i) {
+		if (batch.targets[i].changed) {
+			planner.Add (batch.values[i].definitionIndex, elements[batch.values[i].elemIndex], batch.targets[i].value);
+		}
+	}
+
+	times.writeSeconds += stopwatch.GetSeconds ();
+}
+
+
+void PropertyTestBatch::BulkPropertyUpdate::Write ()
+{
+	Stopwatch stopwatch;
+
+	times.changedValueCount = planner.GetValueCount ();
+	times.distinctValueCount = planner.GetBucketCount ();
+	times.writeCallCount = planner.Execute ();
+	for (const ChunkResult& result : planner.GetChunkResults ()) {
+		++times.writeChunkCount;
+		if (result.failedElemCount > 0) {
+			++times.failedChunkCount;
+			times.failedValueCount += result.failedElemCount;
+		}
+	}
+
+	times.writeSeconds += stopwatch.GetSeconds ();
+}
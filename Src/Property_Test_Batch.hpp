@@ -0,0 +1,227 @@
+// *****************************************************************************
+// File:			Property_Test_Batch.hpp
+// Description:		Property_Test add-on bulk property update engine
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestBatch
+// Contact person:	CSAT
+// *****************************************************************************
+
+#if !defined (BATCH_HPP)
+#define	BATCH_HPP
+
+#include "Property_Test.hpp"
+#include "Property_Test_DefinitionTable.hpp"
+#include "Property_Test_Progress.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace PropertyTestBatch
+{
+
+// -----------------------------------------------------------------------------
+// Wall-clock time measurement
+// -----------------------------------------------------------------------------
+
+class Stopwatch
+{
+public:
+	Stopwatch ();
+
+	void		Restart ();
+	double		GetSeconds () const;
+
+private:
+	std::chrono::steady_clock::time_point	start;
+};
+
+
+// -----------------------------------------------------------------------------
+// Statistics of one bulk command, reported when it ends
+// -----------------------------------------------------------------------------
+
+struct PhaseTimes {
+	double		readSeconds;		// main thread
+	double		computeSeconds;		// summed over the worker threads
+	double		computeWaitSeconds;	// main thread waiting for the compute phase
+	double		writeSeconds;		// main thread
+	double		totalSeconds;
+	UInt32		elementCount;
+	UInt32		batchCount;
+	UInt32		valueCount;
+	UInt32		changedValueCount;
+	UInt32		unchangedValueCount;	// computed, but equal to the current value: not written
+	UInt32		distinctValueCount;		// (definition, value) buckets of the changed values
+	UInt32		writeCallCount;
+	UInt32		writeChunkCount;
+	UInt32		failedChunkCount;		// bisected to isolate the failing elements
+	UInt32		failedValueCount;
+	UInt32		threadCount;
+	UInt32		plannedBatchCount;
+	bool		canceled;
+
+	PhaseTimes ();
+
+	void		Report (const char* commandName) const;
+};
+
+
+// -----------------------------------------------------------------------------
+// One property value of one element, as read from the model
+// -----------------------------------------------------------------------------
+
+struct ElementValue {
+	UInt32				elemIndex;
+	UInt32				definitionIndex;
+	bool				isDefault;
+	API_PropertyValue	value;
+};
+
+
+// -----------------------------------------------------------------------------
+// Computes the new value of one property of one element.
+// Returns false if the value should be left unchanged.
+// It runs on worker threads, so it must not call the API.
+// -----------------------------------------------------------------------------
+
+typedef std::function<bool (const API_PropertyDefinition&	definition,
+							const API_Guid&					elemGuid,
+							const ElementValue&				current,
+							API_PropertyValue&				newValue)>	ComputeFunction;
+
+
+// -----------------------------------------------------------------------------
+// Result of one chunk written by the WritePlanner
+// -----------------------------------------------------------------------------
+
+struct ChunkResult {
+	UInt32		definitionIndex;
+	UInt32		elemCount;
+	UInt32		failedElemCount;
+	UInt32		callCount;			// 1 if the chunk succeeded at once, more if it was bisected
+	GSErrCode	firstError;
+};
+
+
+// -----------------------------------------------------------------------------
+// Plans the writes of per-element target values: the elements are bucketed
+// by (definition, value), and each bucket is written with one
+// ACAPI_ElementList_ModifyPropertyValue call per chunk instead of one
+// ACAPI_Element_SetProperties call per element.
+// A failed call leaves its chunk unchanged, so a failing chunk is bisected
+// and retried until the failing elements are isolated: they are reported,
+// all the others are written.
+// -----------------------------------------------------------------------------
+
+class WritePlanner
+{
+public:
+	static const UInt32	DefaultChunkSize = 4096;
+
+	explicit WritePlanner (const PropertyTestHelpers::DefinitionTable& definitionsToWrite);
+
+	void		SetChunkSize (UInt32 elementsPerChunk);
+
+	void		Add (UInt32 definitionIndex, const API_Guid& elemGuid, const API_PropertyValue& value);
+	void		Add (UInt32 definitionIndex, const GS::Array<API_Guid>& elemGuids, const API_PropertyValue& value);
+	void		AddDefault (UInt32 definitionIndex, const API_Guid& elemGuid);
+	void		Clear ();
+
+	UInt32		GetValueCount () const;
+	UInt32		GetBucketCount () const;
+
+	UInt32		Execute ();						// returns the number of calls made
+
+	const std::vector<ChunkResult>&	GetChunkResults () const;
+	const GS::Array<API_Guid>&		GetFailedElements () const;
+
+private:
+	struct Bucket {
+		UInt32				definitionIndex;
+		bool				isDefault;
+		API_PropertyValue	value;
+		GS::Array<API_Guid>	elemGuids;
+	};
+
+	Bucket&		GetBucket (UInt32 definitionIndex, bool isDefault, const API_PropertyValue& value);
+	void		WriteChunk (const API_Property& property, const GS::Array<API_Guid>& elemGuids, UInt32 begin, UInt32 end, ChunkResult& result);
+
+	PropertyTestHelpers::DefinitionTable		definitions;
+	std::vector<Bucket>							buckets;		// in the order of the first occurrence
+	std::unordered_multimap<ULong, UInt32>		bucketIndices;	// hash of (definition, value) -> bucket
+	UInt32										valueCount;
+	UInt32										chunkSize;
+	std::vector<ChunkResult>					chunkResults;
+	GS::Array<API_Guid>							failedElements;
+};
+
+
+// -----------------------------------------------------------------------------
+// Updates the values of the given property definitions on the given elements
+// in three phases:
+//	- read:		categories and current values, on the main thread
+//	- compute:	the new values, on the worker pool
+//	- write:	the changed values, on the main thread
+// Target values that are equal to the current custom value are not written,
+// so running the same update twice writes nothing the second time.
+// The elements are processed in batches, and the phases are pipelined: while
+// batch N is written, batch N+1 is computed on the workers and batch N+2 is
+// read. The changed values of every batch go to one WritePlanner, which
+// writes them at the end, so a value set on elements of different batches is
+// still one call per chunk. The order of the written values does not depend
+// on the scheduling.
+// With a Progress, cancellation is checked between the batches; a canceled
+// update writes nothing.
+// -----------------------------------------------------------------------------
+
+class BulkPropertyUpdate
+{
+public:
+	static const UInt32	DefaultBatchSize = 2048;
+
+	BulkPropertyUpdate (const PropertyTestHelpers::DefinitionTable& definitionsToUpdate, const GS::Array<API_Guid>& elementsToUpdate);
+
+	void				SetBatchSize (UInt32 elementsPerBatch);
+	void				SetWriteChunkSize (UInt32 elementsPerChunk);
+	void				SetProgress (PropertyTestHelpers::Progress* progressToReport);
+
+	GSErrCode			Run (const ComputeFunction& compute);		// APIERR_CANCEL if the user canceled it
+
+	const PhaseTimes&	GetTimes () const;
+
+private:
+	struct Target {
+		bool				changed;
+		API_PropertyValue	value;
+	};
+
+	struct Batch {
+		UInt32						elemBegin;
+		UInt32						elemEnd;
+		std::vector<ElementValue>	values;
+		std::vector<Target>			targets;
+	};
+
+	void				Read (Batch& batch, UInt32 batchIndex);
+	void				StartCompute (Batch& batch, const ComputeFunction& compute);
+	void				FinishCompute ();
+	void				Plan (const Batch& batch);
+	void				Write ();
+
+	PropertyTestHelpers::DefinitionTable	definitions;		// shared with the planner
+	GS::Array<API_Guid>						elements;
+	API_ElemCategory						classificationCategory;
+	UInt32									batchSize;
+	PropertyTestHelpers::Progress*			progress;
+	std::atomic<Int64>						computeNanoseconds;
+	std::atomic<UInt32>						unchangedValues;
+	WritePlanner							planner;			// the changed values of all the batches
+	PhaseTimes								times;
+};
+
+}
+
+#endif
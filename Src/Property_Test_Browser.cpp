@@ -0,0 +1,522 @@
+// *****************************************************************************
+// File:			Property_Test_Browser.cpp
+// Description:		Property_Test add-on property browser dialog
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestBrowser
+// Contact person:	CSAT
+// *****************************************************************************
+
+#include "Property_Test_Browser.hpp"
+#include "Property_Test_Helpers.hpp"
+
+#include <algorithm>
+#include <unordered_set>
+
+// Elements read between two checks of the cancel button
+static const UInt32 CancelCheckInterval = 256;
+
+
+// -----------------------------------------------------------------------------
+// PropertyBrowser
+// -----------------------------------------------------------------------------
+
+struct PropertyTestBrowser::PropertyBrowser::ElementValues {
+	enum CellState {
+		NotAvailable	= 0,
+		DefaultValue	= 1,
+		CustomValue		= 2
+	};
+
+	std::vector<UInt8>				states;		// CellState, per definition
+	std::vector<API_PropertyValue>	values;		// valid for the CustomValue cells only
+	GS::UniString					rowText;	// the cells of every column, lowercased; empty until the first filtering
+};
+
+
+PropertyTestBrowser::PropertyBrowser::PropertyBrowser (const PropertyTestHelpers::DefinitionTable& definitionsToShow, const GS::Array<API_Guid>& elemGuids) :
+	definitions (definitionsToShow),
+	elements (elemGuids),
+	values (elemGuids.GetSize ()),
+	readCount (0),
+	hasClassificationCategory (false),
+	order (elemGuids.GetSize ())
+{
+	for (UInt32 i = 0; i < elemGuids.GetSize (); ++i) {
+		order[i] = i;
+	}
+	rows = order;
+
+	hasClassificationCategory = (PropertyTestHelpers::GetElemClassificationCategory (classificationCategory) == NoError);
+}
+
+
+PropertyTestBrowser::PropertyBrowser::~PropertyBrowser ()
+{
+}
+
+
+UInt32 PropertyTestBrowser::PropertyBrowser::GetRowCount () const
+{
+	return static_cast<UInt32> (rows.size ());
+}
+
+
+UInt32 PropertyTestBrowser::PropertyBrowser::GetElementCount () const
+{
+	return elements.GetSize ();
+}
+
+
+UInt32 PropertyTestBrowser::PropertyBrowser::GetColumnCount () const
+{
+	return definitions.GetSize () + 1;
+}
+
+
+GS::UniString PropertyTestBrowser::PropertyBrowser::GetColumnTitle (UInt32 column) const
+{
+	return (column == 0) ? GS::UniString ("Element") : definitions[column - 1].name;
+}
+
+
+GS::UniString PropertyTestBrowser::PropertyBrowser::GetCellText (UInt32 row, UInt32 column)
+{
+	return GetElementText (rows[row], column);
+}
+
+
+const API_Guid& PropertyTestBrowser::PropertyBrowser::GetRowElement (UInt32 row) const
+{
+	return elements[rows[row]];
+}
+
+
+bool PropertyTestBrowser::PropertyBrowser::IsAllRead () const
+{
+	return readCount == elements.GetSize () || definitions.IsEmpty ();
+}
+
+
+GSErrCode PropertyTestBrowser::PropertyBrowser::ReadAll (PropertyTestHelpers::Progress* progress)
+{
+	if (IsAllRead ()) {
+		return NoError;
+	}
+
+	if (progress != nullptr) {
+		progress->SetItemCount (elements.GetSize () - readCount);
+	}
+
+	UInt32 readNow = 0;
+	for (UInt32 elemIndex = 0; elemIndex < elements.GetSize (); ++elemIndex) {
+		if (values[elemIndex] != nullptr) {
+			continue;
+		}
+
+		if (progress != nullptr) {
+			if (readNow % CancelCheckInterval == 0 && progress->IsCanceled ()) {
+				return APIERR_CANCEL;
+			}
+			progress->Advance ();
+		}
+
+		GetValues (elemIndex);
+		++readNow;
+	}
+
+	return NoError;
+}
+
+
+void PropertyTestBrowser::PropertyBrowser::SetFilter (const GS::UniString& filterText)
+{
+	if (filterText == filter) {
+		return;
+	}
+
+	// a row with a cell containing the new text passed the old filter already
+	const bool narrowing = !filter.IsEmpty () && filterText.Contains (filter, GS::UniString::CaseInsensitive);
+	filter = filterText;
+
+	if (filter.IsEmpty ()) {
+		rows = order;
+		return;
+	}
+
+	const GS::UniString lowerCaseFilter = filter.ToLowerCase ();
+	const std::vector<UInt32>& candidates = narrowing ? rows : order;
+	std::vector<UInt32> matching;
+	matching.reserve (candidates.size ());
+	for (UInt32 elemIndex : candidates) {
+		if (IsMatching (elemIndex, lowerCaseFilter)) {
+			matching.push_back (elemIndex);
+		}
+	}
+	rows.swap (matching);
+}
+
+
+void PropertyTestBrowser::PropertyBrowser::Sort (UInt32 column, bool descending)
+{
+	// the keys are computed once per element, not in every comparison
+	const UInt32 elementCount = elements.GetSize ();
+	std::vector<UInt8>			missing (elementCount, 0);
+	std::vector<double>			numbers;
+	std::vector<GS::UniString>	texts;
+
+	const bool numeric = IsNumericColumn (column);
+	if (numeric) {
+		numbers.resize (elementCount);
+	} else {
+		texts.resize (elementCount);
+	}
+	for (UInt32 elemIndex = 0; elemIndex < elementCount; ++elemIndex) {
+		if (column > 0 && GetValues (elemIndex).states[column - 1] == ElementValues::NotAvailable) {
+			missing[elemIndex] = 1;
+		} else if (numeric) {
+			numbers[elemIndex] = GetNumber (elemIndex, column);
+		} else {
+			texts[elemIndex] = GetElementText (elemIndex, column);
+		}
+	}
+
+	std::stable_sort (order.begin (), order.end (), [&] (UInt32 lhs, UInt32 rhs) {
+		if (missing[lhs] != missing[rhs]) {
+			return missing[lhs] < missing[rhs];
+		}
+		if (missing[lhs] != 0) {
+			return false;
+		}
+		if (numeric) {
+			return descending ? numbers[rhs] < numbers[lhs] : numbers[lhs] < numbers[rhs];
+		}
+		return descending ? texts[rhs] < texts[lhs] : texts[lhs] < texts[rhs];
+	});
+
+	if (filter.IsEmpty ()) {
+		rows = order;
+	} else {
+		std::vector<UInt8> passed (elementCount, 0);
+		for (UInt32 elemIndex : rows) {
+			passed[elemIndex] = 1;
+		}
+		rows.clear ();
+		for (UInt32 elemIndex : order) {
+			if (passed[elemIndex] != 0) {
+				rows.push_back (elemIndex);
+			}
+		}
+	}
+}
+
+
+const GS::UniString& PropertyTestBrowser::PropertyBrowser::GetFilter () const
+{
+	return filter;
+}
+
+
+const PropertyTestBrowser::PropertyBrowser::ElementValues& PropertyTestBrowser::PropertyBrowser::GetValues (UInt32 elemIndex)
+{
+	std::unique_ptr<ElementValues>& elementValues = values[elemIndex];
+	if (elementValues != nullptr) {
+		return *elementValues;
+	}
+
+	elementValues.reset (new ElementValues ());
+	elementValues->states.assign (definitions.GetSize (), static_cast<UInt8> (ElementValues::NotAvailable));
+	elementValues->values.resize (definitions.GetSize ());
+	++readCount;
+
+	GS::Array<API_Property>	properties;
+	GS::Array<UInt32>		definitionIndices;
+	if (hasClassificationCategory && !definitions.IsEmpty () &&
+		PropertyTestHelpers::GetAvailableProperties (elements[elemIndex], classificationCategory, definitions, properties, definitionIndices) == NoError)
+	{
+		for (UInt32 i = 0; i < properties.GetSize (); ++i) {
+			const UInt32 definitionIndex = definitionIndices[i];
+			if (properties[i].isDefault) {
+				elementValues->states[definitionIndex] = static_cast<UInt8> (ElementValues::DefaultValue);
+			} else {
+				elementValues->states[definitionIndex] = static_cast<UInt8> (ElementValues::CustomValue);
+				elementValues->values[definitionIndex] = properties[i].value;
+			}
+		}
+	}
+
+	return *elementValues;
+}
+
+
+GS::UniString PropertyTestBrowser::PropertyBrowser::GetElementText (UInt32 elemIndex, UInt32 column)
+{
+	if (column == 0) {
+		return APIGuid2GSGuid (elements[elemIndex]).ToUniString ();
+	}
+
+	const UInt32 definitionIndex = column - 1;
+	const API_PropertyDefinition& definition = definitions[definitionIndex];
+	const ElementValues& elementValues = GetValues (elemIndex);
+	switch (elementValues.states[definitionIndex]) {
+		case ElementValues::DefaultValue:	return PropertyTestHelpers::ToString (definition.defaultValue, definition.collectionType);
+		case ElementValues::CustomValue:	return PropertyTestHelpers::ToString (elementValues.values[definitionIndex], definition.collectionType);
+		default:							return GS::UniString ();
+	}
+}
+
+
+// The texts of the cells are formatted once per element, on its first
+// filtering; the later filters only search them
+const GS::UniString& PropertyTestBrowser::PropertyBrowser::GetRowText (UInt32 elemIndex)
+{
+	GetValues (elemIndex);
+	GS::UniString& rowText = values[elemIndex]->rowText;
+	if (rowText.IsEmpty ()) {
+		GS::UniString text;
+		for (UInt32 column = 0; column < GetColumnCount (); ++column) {
+			text += GetElementText (elemIndex, column);
+			text += "\n";		// a one-line filter does not match across the cells
+		}
+		rowText = text.ToLowerCase ();
+	}
+	return rowText;
+}
+
+
+bool PropertyTestBrowser::PropertyBrowser::IsMatching (UInt32 elemIndex, const GS::UniString& lowerCaseText)
+{
+	return GetRowText (elemIndex).Contains (lowerCaseText);
+}
+
+
+bool PropertyTestBrowser::PropertyBrowser::IsNumericColumn (UInt32 column) const
+{
+	if (column == 0) {
+		return false;
+	}
+
+	const API_PropertyDefinition& definition = definitions[column - 1];
+	return definition.collectionType == API_PropertySingleCollectionType &&
+		   (definition.valueType == API_PropertyIntegerValueType ||
+			definition.valueType == API_PropertyRealValueType ||
+			definition.valueType == API_PropertyBooleanValueType);
+}
+
+
+double PropertyTestBrowser::PropertyBrowser::GetNumber (UInt32 elemIndex, UInt32 column)
+{
+	const UInt32 definitionIndex = column - 1;
+	const ElementValues& elementValues = GetValues (elemIndex);
+	const API_Variant& variant = (elementValues.states[definitionIndex] == ElementValues::CustomValue) ?
+									elementValues.values[definitionIndex].singleVariant.variant :
+									definitions[definitionIndex].defaultValue.singleVariant.variant;
+	switch (variant.type) {
+		case API_PropertyIntegerValueType:	return variant.intValue;
+		case API_PropertyRealValueType:		return variant.doubleValue;
+		case API_PropertyBooleanValueType:	return variant.boolValue ? 1.0 : 0.0;
+		default:							return 0.0;
+	}
+}
+
+
+// -----------------------------------------------------------------------------
+// The dialog
+// The list box holds only the visible rows; the scroll bar gives the first
+// row shown, and the texts of the visible rows are set again when it moves.
+// -----------------------------------------------------------------------------
+
+static const short	BrowserDialogResId		= 32500;
+
+enum BrowserDialogItem {
+	CloseButtonItem		= 1,
+	FilterLabelItem		= 2,
+	FilterEditItem		= 3,
+	SortLabelItem		= 4,
+	SortPopupItem		= 5,
+	DescendingItem		= 6,
+	ListItem			= 7,
+	ScrollBarItem		= 8,
+	CountTextItem		= 9
+};
+
+// Follow the list box in the GDLG resource: its width and the rows fitting
+// under its header
+static const short	ListWidth				= 862;
+static const short	VisibleRowCount			= 24;
+static const short	ElementColumnWidth		= 250;
+
+// Only so many definitions are shown, so the columns stay readable
+static const UInt32	MaxPropertyColumnCount	= 6;
+
+
+static bool ReadAllWithProgress (PropertyTestBrowser::PropertyBrowser& browser)
+{
+	if (browser.IsAllRead ()) {
+		return true;
+	}
+
+	PropertyTestHelpers::Progress progress ("Lister", "Reading the properties", browser.GetElementCount ());
+	return browser.ReadAll (&progress) == NoError;
+}
+
+
+static void SetupList (short dialId, const PropertyTestBrowser::PropertyBrowser& browser)
+{
+	const short columnCount = static_cast<short> (browser.GetColumnCount ());
+	const short propertyColumnWidth = (columnCount > 1) ? static_cast<short> ((ListWidth - ElementColumnWidth) / (columnCount - 1)) : 0;
+
+	DGListBoxSetTabFieldCount (dialId, ListItem, columnCount);
+	for (short column = 0; column < columnCount; ++column) {
+		const short tabIndex = static_cast<short> (column + 1);
+		const short begPos = (column == 0) ? 0 : static_cast<short> (ElementColumnWidth + (column - 1) * propertyColumnWidth);
+		const short endPos = (column == 0) ? ElementColumnWidth : static_cast<short> (begPos + propertyColumnWidth);
+		DGListBoxSetTabFieldProperties (dialId, ListItem, tabIndex, begPos, endPos, DG_IS_LEFT, DG_IS_TRUNCEND, true, true);
+		DGListBoxSetHeaderItemText (dialId, ListItem, tabIndex, browser.GetColumnTitle (column));
+
+		DGPopUpInsertItem (dialId, SortPopupItem, DG_POPUP_BOTTOM);
+		DGPopUpSetItemText (dialId, SortPopupItem, DG_POPUP_BOTTOM, browser.GetColumnTitle (column));
+	}
+	DGPopUpSelectItem (dialId, SortPopupItem, 1);
+
+	for (short item = 0; item < VisibleRowCount; ++item) {
+		DGListBoxInsertItem (dialId, ListItem, DG_LIST_BOTTOM);
+	}
+}
+
+
+static void FillVisibleRows (short dialId, PropertyTestBrowser::PropertyBrowser& browser)
+{
+	const UInt32 firstRow = static_cast<UInt32> (DGGetItemValLong (dialId, ScrollBarItem));
+
+	DGListBoxDisableDraw (dialId, ListItem);
+	for (short item = 1; item <= VisibleRowCount; ++item) {
+		const UInt32 row = firstRow + item - 1;
+		for (UInt32 column = 0; column < browser.GetColumnCount (); ++column) {
+			const GS::UniString text = (row < browser.GetRowCount ()) ? browser.GetCellText (row, column) : GS::UniString ();
+			DGListBoxSetTabItemText (dialId, ListItem, item, static_cast<short> (column + 1), text);
+		}
+	}
+	DGListBoxEnableDraw (dialId, ListItem);
+}
+
+
+static void ShowFromFirstRow (short dialId, PropertyTestBrowser::PropertyBrowser& browser)
+{
+	const UInt32 rowCount = browser.GetRowCount ();
+	DGSetItemMinLong (dialId, ScrollBarItem, 0);
+	DGSetItemMaxLong (dialId, ScrollBarItem, (rowCount > VisibleRowCount) ? static_cast<Int32> (rowCount - VisibleRowCount) : 0);
+	DGSetItemValLong (dialId, ScrollBarItem, 0);
+
+	DGSetItemText (dialId, CountTextItem, GS::ValueToUniString (rowCount) + " of " +
+				   GS::ValueToUniString (browser.GetElementCount ()) + " element(s)");
+
+	FillVisibleRows (dialId, browser);
+}
+
+
+static void ChangeFilter (short dialId, PropertyTestBrowser::PropertyBrowser& browser)
+{
+	const GS::UniString filterText = DGGetItemText (dialId, FilterEditItem);
+	if (!filterText.IsEmpty () && !ReadAllWithProgress (browser)) {
+		DGSetItemText (dialId, FilterEditItem, browser.GetFilter ());
+		return;
+	}
+
+	browser.SetFilter (filterText);
+	ShowFromFirstRow (dialId, browser);
+}
+
+
+static void ChangeSort (short dialId, PropertyTestBrowser::PropertyBrowser& browser)
+{
+	const UInt32 column = static_cast<UInt32> (DGPopUpGetSelected (dialId, SortPopupItem) - 1);
+	if (column > 0 && !ReadAllWithProgress (browser)) {
+		return;
+	}
+
+	browser.Sort (column, DGGetItemValLong (dialId, DescendingItem) != 0);
+	ShowFromFirstRow (dialId, browser);
+}
+
+
+static short DGCALLBACK BrowserDialogCallBack (short message, short dialId, short item, DGUserData userData, DGMessageData /*msgData*/)
+{
+	PropertyTestBrowser::PropertyBrowser& browser = *reinterpret_cast<PropertyTestBrowser::PropertyBrowser*> (userData);
+
+	switch (message) {
+		case DG_MSG_INIT:
+			SetupList (dialId, browser);
+			ShowFromFirstRow (dialId, browser);
+			break;
+
+		case DG_MSG_CHANGE:
+			switch (item) {
+				case FilterEditItem:	ChangeFilter (dialId, browser);			break;
+				case SortPopupItem:
+				case DescendingItem:	ChangeSort (dialId, browser);			break;
+				case ScrollBarItem:		FillVisibleRows (dialId, browser);		break;
+			}
+			break;
+
+		case DG_MSG_CLICK:
+			if (item == CloseButtonItem) {
+				return item;
+			}
+			break;
+	}
+
+	return 0;
+}
+
+
+// The columns are the definitions available for the classifications of the
+// elements, in the order of the project, the classifications taken in the order
+// of the elements. The elements are visited only until the columns are full:
+// one category value per element, the properties are read later.
+static GSErrCode CollectColumnDefinitions (const GS::Array<API_Guid>& elemGuids, PropertyTestHelpers::DefinitionTable& definitionsToShow)
+{
+	GS::Array<API_PropertyDefinition> definitions;
+	GSErrCode error = ACAPI_Property_GetPropertyDefinitions (APINULLGuid, definitions);
+	if (error != NoError) {
+		return error;
+	}
+
+	API_ElemCategory classificationCategory;
+	error = PropertyTestHelpers::GetElemClassificationCategory (classificationCategory);
+	if (error != NoError) {
+		return error;
+	}
+
+	std::unordered_set<API_Guid, PropertyTestHelpers::GuidHash> seenClassifications;
+	for (UInt32 elemIndex = 0; elemIndex < elemGuids.GetSize () && definitionsToShow.GetSize () < MaxPropertyColumnCount; ++elemIndex) {
+		API_ElemCategoryValue catValue;
+		if (COLLECT_ERROR (ACAPI_Element_GetCategoryValue (elemGuids[elemIndex], classificationCategory, &catValue)) != NoError ||
+			!seenClassifications.insert (catValue.guid).second)
+		{
+			continue;
+		}
+
+		for (UInt32 i = 0; i < definitions.GetSize () && definitionsToShow.GetSize () < MaxPropertyColumnCount; ++i) {
+			if (PropertyTestHelpers::IsPropertyAvailable (definitions[i], catValue)) {
+				definitionsToShow.Add (definitions[i]);
+			}
+		}
+	}
+
+	return NoError;
+}
+
+
+GSErrCode PropertyTestBrowser::ShowPropertyBrowser (const GS::Array<API_Guid>& elemGuids)
+{
+	PropertyTestHelpers::DefinitionTable definitionsToShow;
+	const GSErrCode error = CollectColumnDefinitions (elemGuids, definitionsToShow);
+	if (error != NoError) {
+		return error;
+	}
+
+	PropertyBrowser browser (definitionsToShow, elemGuids);
+	DGModalDialog (ACAPI_GetOwnResModule (), BrowserDialogResId, ACAPI_GetOwnResModule (), BrowserDialogCallBack, reinterpret_cast<DGUserData> (&browser));
+
+	return NoError;
+}
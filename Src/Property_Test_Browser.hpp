@@ -0,0 +1,97 @@
+// *****************************************************************************
+// File:			Property_Test_Browser.hpp
+// Description:		Property_Test add-on property browser dialog
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestBrowser
+// Contact person:	CSAT
+// *****************************************************************************
+
+#if !defined (BROWSER_HPP)
+#define	BROWSER_HPP
+
+#include "Property_Test.hpp"
+#include "Property_Test_DefinitionTable.hpp"
+#include "Property_Test_Progress.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace PropertyTestBrowser
+{
+
+// -----------------------------------------------------------------------------
+// The rows of the property browser: one row per element, the first column is
+// the element, the others are the values of the given definitions.
+// Nothing is read when it is created, so it is ready at once for any number
+// of elements:
+//	- the properties of an element are read when one of its cells is asked
+//	  for the first time, then kept
+//	- the cell texts are formatted when asked for, which is only for the
+//	  visible rows; for filtering, the texts of all the cells of an element
+//	  are formatted once and kept lowercased in one text, so changing the
+//	  filter does not format the values again
+//	- filtering and sorting on the property columns need every element,
+//	  ReadAll reads the ones still missing once; then they run on the kept
+//	  values without API calls
+// Filtering keeps the rows with the filter text in any of their cells, case
+// insensitively. A filter extending the previous one only looks at the rows
+// that passed the previous one.
+// Sorting is stable and typed: numbers and flags by value, the others by
+// their text; the rows without the property go to the end.
+// -----------------------------------------------------------------------------
+
+class PropertyBrowser
+{
+public:
+	PropertyBrowser (const PropertyTestHelpers::DefinitionTable& definitionsToShow, const GS::Array<API_Guid>& elemGuids);
+	~PropertyBrowser ();
+
+	UInt32			GetRowCount () const;		// the rows passing the filter
+	UInt32			GetElementCount () const;
+	UInt32			GetColumnCount () const;
+
+	GS::UniString	GetColumnTitle (UInt32 column) const;
+	GS::UniString	GetCellText (UInt32 row, UInt32 column);
+	const API_Guid&	GetRowElement (UInt32 row) const;
+
+	bool			IsAllRead () const;
+	GSErrCode		ReadAll (PropertyTestHelpers::Progress* progress);	// APIERR_CANCEL if canceled
+
+	// filtering and sorting on a property column read the missing elements one
+	// by one: call ReadAll first to show their progress
+	void			SetFilter (const GS::UniString& filterText);
+	void			Sort (UInt32 column, bool descending);
+
+	const GS::UniString&	GetFilter () const;
+
+private:
+	struct ElementValues;
+
+	const ElementValues&	GetValues (UInt32 elemIndex);
+	GS::UniString			GetElementText (UInt32 elemIndex, UInt32 column);
+	const GS::UniString&	GetRowText (UInt32 elemIndex);
+	bool					IsMatching (UInt32 elemIndex, const GS::UniString& lowerCaseText);
+	bool					IsNumericColumn (UInt32 column) const;
+	double					GetNumber (UInt32 elemIndex, UInt32 column);
+
+	PropertyTestHelpers::DefinitionTable			definitions;
+	GS::Array<API_Guid>								elements;
+	std::vector<std::unique_ptr<ElementValues>>		values;			// per element, null until read
+	UInt32											readCount;
+	API_ElemCategory								classificationCategory;
+	bool											hasClassificationCategory;
+	std::vector<UInt32>								order;			// every element in the sort order
+	std::vector<UInt32>								rows;			// the elements passing the filter, in the sort order
+	GS::UniString									filter;
+};
+
+
+// -----------------------------------------------------------------------------
+// Shows the properties of the elements in a modal dialog
+// -----------------------------------------------------------------------------
+
+GSErrCode	ShowPropertyBrowser (const GS::Array<API_Guid>& elemGuids);
+
+}
+
+#endif
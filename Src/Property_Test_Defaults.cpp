@@ -0,0 +1,297 @@
+// *****************************************************************************
+// File:			Property_Test_Defaults.cpp
+// Description:		Property_Test add-on property template for the tool defaults
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestDefaults
+// Contact person:	CSAT
+// *****************************************************************************
+
+#include "Property_Test_Defaults.hpp"
+#include "Property_Test_Batch.hpp"
+#include "Property_Test_Helpers.hpp"
+#include "Property_Test_Snapshot.hpp"
+
+#include <cstring>
+
+
+// -----------------------------------------------------------------------------
+// TemplateStatistics
+// -----------------------------------------------------------------------------
+
+PropertyTestDefaults::TemplateStatistics::TemplateStatistics () :
+	rowCount (0),
+	badTypeCount (0),
+	unknownDefinitionCount (0),
+	badValueCount (0),
+	toolCount (0),
+	valueCount (0),
+	notAvailableCount (0),
+	unchangedCount (0),
+	changedCount (0),
+	readCallCount (0),
+	writeCallCount (0),
+	failedToolCount (0),
+	parseSeconds (0.0),
+	applySeconds (0.0)
+{
+}
+
+
+void PropertyTestDefaults::TemplateStatistics::Report (const char* commandName) const
+{
+	WriteReport ("%s: %u row(s), %u bad type(s), %u unknown definition(s), %u bad value(s), parsed in %.3f s",
+				 commandName, rowCount, badTypeCount, unknownDefinitionCount, badValueCount, parseSeconds);
+	WriteReport ("  %u tool default(s), %u value(s): %u changed, %u already up to date, %u not available for the tool",
+				 toolCount, valueCount, changedCount, unchangedCount, notAvailableCount);
+	WriteReport ("  %u read and %u write call(s) in %.3f s, %u tool default(s) failed",
+				 readCallCount, writeCallCount, applySeconds, failedToolCount);
+}
+
+
+// -----------------------------------------------------------------------------
+// Tool defaults
+// -----------------------------------------------------------------------------
+
+const std::vector<PropertyTestDefaults::ToolDefault>& PropertyTestDefaults::GetToolDefaults ()
+{
+	static const std::vector<ToolDefault> toolDefaults = {
+		{ API_WallID,			APIVarId_Generic },
+		{ API_ColumnID,			APIVarId_Generic },
+		{ API_BeamID,			APIVarId_Generic },
+		{ API_WindowID,			APIVarId_Generic },
+		{ API_DoorID,			APIVarId_Generic },
+		{ API_ObjectID,			APIVarId_Generic },
+		{ API_LampID,			APIVarId_Generic },
+		{ API_SlabID,			APIVarId_Generic },
+		{ API_RoofID,			APIVarId_Generic },
+		{ API_MeshID,			APIVarId_Generic },
+		{ API_ZoneID,			APIVarId_Generic },
+		{ API_CurtainWallID,	APIVarId_Generic },
+		{ API_ShellID,			APIVarId_Generic },
+		{ API_SkylightID,		APIVarId_Generic },
+		{ API_MorphID,			APIVarId_Generic }
+	};
+	return toolDefaults;
+}
+
+
+// -----------------------------------------------------------------------------
+// DefaultsTemplate
+// -----------------------------------------------------------------------------
+
+PropertyTestDefaults::DefaultsTemplate::DefaultsTemplate (const GS::Array<API_PropertyDefinition>& definitionsToApply) :
+	definitions (definitionsToApply),
+	parser (definitionsToApply),
+	tools (GetToolDefaults ().size ())
+{
+}
+
+
+bool PropertyTestDefaults::DefaultsTemplate::FindTool (const char* name, UInt32& toolIndex) const
+{
+	const GS::UniString toolName (name, CC_UTF8);
+	const std::vector<ToolDefault>& toolDefaults = GetToolDefaults ();
+	for (UInt32 i = 0; i < toolDefaults.size (); ++i) {
+		if (toolName.IsEqual (ElemID_To_Name (toolDefaults[i].typeID), GS::UniString::CaseInsensitive)) {
+			toolIndex = i;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+void PropertyTestDefaults::DefaultsTemplate::AddRow (const PropertyTestImport::CsvRow& row)
+{
+	const bool isEveryTool = std::strcmp (row.fields[0], "*") == 0;
+	UInt32 toolIndex = 0;
+	if (!isEveryTool && !FindTool (row.fields[0], toolIndex)) {
+		if (row.lineNumber == 1) {
+			return;		// header
+		}
+		++statistics.rowCount;
+		++statistics.badTypeCount;
+		return;
+	}
+
+	++statistics.rowCount;
+	UInt32 definitionIndex = 0;
+	if (row.fieldCount < 3 || !parser.FindDefinition (row.fields[1], row.lengths[1], definitionIndex)) {
+		++statistics.unknownDefinitionCount;
+		return;
+	}
+
+	API_PropertyValue value;
+	if (!parser.ParseValue (definitionIndex, std::string (row.fields[2], row.lengths[2]), value)) {
+		++statistics.badValueCount;
+		return;
+	}
+
+	if (isEveryTool) {
+		for (UInt32 i = 0; i < tools.size (); ++i) {
+			Add (i, definitionIndex, value);
+		}
+	} else {
+		Add (toolIndex, definitionIndex, value);
+	}
+}
+
+
+void PropertyTestDefaults::DefaultsTemplate::Add (UInt32 toolIndex, UInt32 definitionIndex, const API_PropertyValue& value)
+{
+	ToolValues& tool = tools[toolIndex];
+	auto found = tool.valueIndices.find (definitionIndex);
+	if (found != tool.valueIndices.end ()) {
+		tool.values[found->second].value = value;
+		return;
+	}
+
+	tool.valueIndices.emplace (definitionIndex, static_cast<UInt32> (tool.values.size ()));
+	Value newValue;
+	newValue.definitionIndex = definitionIndex;
+	newValue.value = value;
+	tool.values.push_back (newValue);
+}
+
+
+GSErrCode PropertyTestDefaults::DefaultsTemplate::ApplyTool (UInt32 toolIndex)
+{
+	const ToolDefault& toolDefault = GetToolDefaults ()[toolIndex];
+	const ToolValues& tool = tools[toolIndex];
+
+	API_ElemCategoryValue catValue;
+	GSErrCode error = COLLECT_ERROR (PropertyTestHelpers::GetElemCategoryValueDefault (toolDefault.typeID, toolDefault.variationID, catValue));
+	if (error != NoError) {
+		return error;
+	}
+
+	// only the definitions available for the category of the tool have a default value
+	GS::Array<API_Property> properties;
+	std::vector<const Value*> propertyValues;
+	for (const Value& value : tool.values) {
+		if (!PropertyTestHelpers::IsPropertyAvailable (definitions[value.definitionIndex], catValue)) {
+			++statistics.notAvailableCount;
+			continue;
+		}
+		API_Property property;
+		property.definition = definitions[value.definitionIndex];
+		properties.Push (property);
+		propertyValues.push_back (&value);
+	}
+	if (properties.IsEmpty ()) {
+		return NoError;
+	}
+
+	++statistics.readCallCount;
+	error = COLLECT_ERROR (ACAPI_Element_GetPropertiesDefault (toolDefault.typeID, toolDefault.variationID, properties));
+	if (error != NoError) {
+		return error;
+	}
+
+	GS::Array<API_Property> changedProperties;
+	for (UInt32 i = 0; i < properties.GetSize (); ++i) {
+		API_Property& property = properties[i];
+		const API_PropertyValue& newValue = propertyValues[i]->value;
+		if (parser.IsUnchanged (propertyValues[i]->definitionIndex, property, newValue)) {
+			++statistics.unchangedCount;
+			continue;
+		}
+		property.isDefault = false;
+		property.value = newValue;
+		changedProperties.Push (property);
+	}
+	if (changedProperties.IsEmpty ()) {
+		return NoError;
+	}
+
+	++statistics.writeCallCount;
+	error = COLLECT_ERROR (ACAPI_Element_SetPropertiesDefault (toolDefault.typeID, toolDefault.variationID, changedProperties));
+	if (error != NoError) {
+		return error;
+	}
+	statistics.changedCount += changedProperties.GetSize ();
+
+	return NoError;
+}
+
+
+GSErrCode PropertyTestDefaults::DefaultsTemplate::Apply (PropertyTestHelpers::Progress* progress)
+{
+	PropertyTestBatch::Stopwatch stopwatch;
+
+	UInt32 toolCount = 0;
+	for (const ToolValues& tool : tools) {
+		if (!tool.values.empty ()) {
+			++toolCount;
+		}
+	}
+	if (progress != nullptr) {
+		progress->SetItemCount (toolCount);
+	}
+
+	GSErrCode error = NoError;
+	for (UInt32 i = 0; i < tools.size (); ++i) {
+		if (tools[i].values.empty ()) {
+			continue;
+		}
+		if (progress != nullptr) {
+			if (progress->IsCanceled ()) {
+				error = APIERR_CANCEL;
+				break;
+			}
+			progress->Advance ();
+		}
+
+		++statistics.toolCount;
+		statistics.valueCount += static_cast<UInt32> (tools[i].values.size ());
+		if (ApplyTool (i) != NoError) {
+			++statistics.failedToolCount;		// collected, the other tools go on
+		}
+	}
+
+	statistics.applySeconds = stopwatch.GetSeconds ();
+	return error;
+}
+
+
+const PropertyTestDefaults::TemplateStatistics& PropertyTestDefaults::DefaultsTemplate::GetStatistics () const
+{
+	return statistics;
+}
+
+
+PropertyTestDefaults::TemplateStatistics& PropertyTestDefaults::DefaultsTemplate::GetStatistics ()
+{
+	return statistics;
+}
+
+
+// -----------------------------------------------------------------------------
+// Template file
+// -----------------------------------------------------------------------------
+
+GSErrCode PropertyTestDefaults::ApplyTemplateFile (const IO::Location& location, const GS::Array<API_PropertyDefinition>& definitions,
+												   PropertyTestHelpers::Progress* progress, TemplateStatistics& statistics)
+{
+	PropertyTestBatch::Stopwatch stopwatch;
+
+	// a template is small: it is read at once
+	std::vector<char> file;
+	GSErrCode error = PropertyTestSnapshot::LoadFile (location, file);
+	if (error != NoError) {
+		return error;
+	}
+
+	DefaultsTemplate defaultsTemplate (definitions);
+	PropertyTestImport::CsvReader reader;
+	const PropertyTestImport::CsvReader::RowCallback onRow = [&defaultsTemplate] (const PropertyTestImport::CsvRow& row) {
+		defaultsTemplate.AddRow (row);
+	};
+	reader.Feed (file.data (), file.size (), onRow);
+	reader.Finish (onRow);
+	defaultsTemplate.GetStatistics ().parseSeconds = stopwatch.GetSeconds ();
+
+	error = defaultsTemplate.Apply (progress);
+	statistics = defaultsTemplate.GetStatistics ();
+	return error;
+}
@@ -0,0 +1,120 @@
+// *****************************************************************************
+// File:			Property_Test_Defaults.hpp
+// Description:		Property_Test add-on property template for the tool defaults
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestDefaults
+// Contact person:	CSAT
+// *****************************************************************************
+
+#if !defined (DEFAULTS_HPP)
+#define	DEFAULTS_HPP
+
+#include "Property_Test.hpp"
+#include "Property_Test_Import.hpp"
+#include "Property_Test_Progress.hpp"
+
+#include "Location.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace PropertyTestDefaults
+{
+
+// -----------------------------------------------------------------------------
+// The element type and variation of a tool default
+// -----------------------------------------------------------------------------
+
+struct ToolDefault {
+	API_ElemTypeID			typeID;
+	API_ElemVariationID		variationID;
+};
+
+
+// The tool defaults a template can set, in the order they are written
+const std::vector<ToolDefault>&		GetToolDefaults ();
+
+
+// -----------------------------------------------------------------------------
+// Statistics of one template application
+// -----------------------------------------------------------------------------
+
+struct TemplateStatistics {
+	UInt32		rowCount;
+	UInt32		badTypeCount;			// not the name of a tool default, nor *
+	UInt32		unknownDefinitionCount;
+	UInt32		badValueCount;
+	UInt32		toolCount;				// tool defaults the template has a value for
+	UInt32		valueCount;				// template values over all the tool defaults
+	UInt32		notAvailableCount;		// the definition is not available for the category of the tool default
+	UInt32		unchangedCount;			// the tool default already has the value: not written
+	UInt32		changedCount;
+	UInt32		readCallCount;
+	UInt32		writeCallCount;
+	UInt32		failedToolCount;		// its category, its values could not be read or written
+	double		parseSeconds;
+	double		applySeconds;
+
+	TemplateStatistics ();
+
+	void		Report (const char* commandName) const;
+};
+
+
+// -----------------------------------------------------------------------------
+// Property values for the tool defaults, applied in one pass:
+//	- the category of every tool default is resolved once
+//	- its current values of the template definitions are read in one call
+//	- only the values that differ are written, in one call per tool default
+// A later value of the same definition for the same tool default replaces
+// the earlier one, so a template can set a value for every tool (*) and
+// override it for some of them.
+// The rows of a template file are: element type name (as ElemID_To_Name
+// gives it, or * for every tool default), definition name, value; a first
+// row with an unknown type is taken as a header.
+// -----------------------------------------------------------------------------
+
+class DefaultsTemplate
+{
+public:
+	explicit DefaultsTemplate (const GS::Array<API_PropertyDefinition>& definitionsToApply);
+
+	void		AddRow (const PropertyTestImport::CsvRow& row);
+	void		Add (UInt32 toolIndex, UInt32 definitionIndex, const API_PropertyValue& value);
+
+	GSErrCode	Apply (PropertyTestHelpers::Progress* progress);		// APIERR_CANCEL: the tool defaults written before are kept
+
+	const TemplateStatistics&	GetStatistics () const;
+	TemplateStatistics&			GetStatistics ();
+
+private:
+	struct Value {
+		UInt32				definitionIndex;
+		API_PropertyValue	value;
+	};
+
+	struct ToolValues {
+		std::vector<Value>						values;
+		std::unordered_map<UInt32, UInt32>		valueIndices;		// definition -> value
+	};
+
+	bool		FindTool (const char* name, UInt32& toolIndex) const;
+	GSErrCode	ApplyTool (UInt32 toolIndex);
+
+	const GS::Array<API_PropertyDefinition>&	definitions;
+	PropertyTestImport::ValueParser				parser;
+	std::vector<ToolValues>						tools;				// parallel to GetToolDefaults ()
+	TemplateStatistics							statistics;
+};
+
+
+// -----------------------------------------------------------------------------
+// Reads the template from a CSV file and applies it
+// -----------------------------------------------------------------------------
+
+GSErrCode	ApplyTemplateFile (const IO::Location& location, const GS::Array<API_PropertyDefinition>& definitions,
+							   PropertyTestHelpers::Progress* progress, TemplateStatistics& statistics);
+
+}
+
+#endif
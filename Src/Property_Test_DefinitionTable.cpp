@@ -0,0 +1,122 @@
+// *****************************************************************************
+// File:			Property_Test_DefinitionTable.cpp
+// Description:		Property_Test add-on shared table of property definitions
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestHelpers
+// Contact person:	CSAT
+// *****************************************************************************
+
+#include "Property_Test_DefinitionTable.hpp"
+
+
+// The empty tables share one, so they cost no allocation until the first Add
+const std::shared_ptr<PropertyTestHelpers::DefinitionTable::Data>& PropertyTestHelpers::DefinitionTable::GetEmptyData ()
+{
+	static const std::shared_ptr<Data> emptyData = std::make_shared<Data> ();
+	return emptyData;
+}
+
+
+PropertyTestHelpers::DefinitionTable::DefinitionTable () :
+	data (GetEmptyData ())
+{
+}
+
+
+PropertyTestHelpers::DefinitionTable::DefinitionTable (const GS::Array<API_PropertyDefinition>& definitionsToShare) :
+	data (GetEmptyData ())
+{
+	Data& newData = Edit ();
+	newData.definitions.SetCapacity (definitionsToShare.GetSize ());
+	newData.indices.reserve (definitionsToShare.GetSize ());
+	for (UInt32 i = 0; i < definitionsToShare.GetSize (); ++i) {
+		newData.indices.emplace (definitionsToShare[i].guid, i);
+		newData.definitions.Push (definitionsToShare[i]);
+	}
+}
+
+
+UInt32 PropertyTestHelpers::DefinitionTable::GetSize () const
+{
+	return data->definitions.GetSize ();
+}
+
+
+bool PropertyTestHelpers::DefinitionTable::IsEmpty () const
+{
+	return data->definitions.IsEmpty ();
+}
+
+
+const API_PropertyDefinition& PropertyTestHelpers::DefinitionTable::operator[] (UInt32 index) const
+{
+	return data->definitions[index];
+}
+
+
+const GS::Array<API_PropertyDefinition>& PropertyTestHelpers::DefinitionTable::GetDefinitions () const
+{
+	return data->definitions;
+}
+
+
+// Of more definitions with the same guid, the first one is found
+bool PropertyTestHelpers::DefinitionTable::Find (const API_Guid& guid, UInt32& index) const
+{
+	auto found = data->indices.find (guid);
+	if (found == data->indices.end ()) {
+		return false;
+	}
+	index = found->second;
+	return true;
+}
+
+
+UInt32 PropertyTestHelpers::DefinitionTable::Add (const API_PropertyDefinition& definition)
+{
+	UInt32 index = 0;
+	if (Find (definition.guid, index)) {
+		return index;
+	}
+
+	Data& editedData = Edit ();
+	index = editedData.definitions.GetSize ();
+	editedData.indices.emplace (definition.guid, index);
+	editedData.definitions.Push (definition);
+	return index;
+}
+
+
+void PropertyTestHelpers::DefinitionTable::Clear ()
+{
+	data = GetEmptyData ();
+}
+
+
+bool PropertyTestHelpers::DefinitionTable::IsShared () const
+{
+	return data.use_count () > 1;
+}
+
+
+void PropertyTestHelpers::DefinitionTable::MakeRequest (UInt32 index, API_Property& property) const
+{
+	property.definition.guid = data->definitions[index].guid;
+}
+
+
+void PropertyTestHelpers::DefinitionTable::MakeProperty (UInt32 index, bool isDefault, const API_PropertyValue& value, API_Property& property) const
+{
+	property.definition = data->definitions[index];
+	property.isDefault = isDefault;
+	property.value = value;
+}
+
+
+PropertyTestHelpers::DefinitionTable::Data& PropertyTestHelpers::DefinitionTable::Edit ()
+{
+	if (IsShared ()) {
+		data = std::make_shared<Data> (*data);
+	}
+	return *data;
+}
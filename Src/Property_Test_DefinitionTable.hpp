@@ -0,0 +1,68 @@
+// *****************************************************************************
+// File:			Property_Test_DefinitionTable.hpp
+// Description:		Property_Test add-on shared table of property definitions
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestHelpers
+// Contact person:	CSAT
+// *****************************************************************************
+
+#if !defined (DEFINITIONTABLE_HPP)
+#define	DEFINITIONTABLE_HPP
+
+#include "Property_Test.hpp"
+#include "Property_Test_Helpers.hpp"
+
+#include <memory>
+#include <unordered_map>
+
+namespace PropertyTestHelpers
+{
+
+// -----------------------------------------------------------------------------
+// The property definitions of a command, held once and shared by everything
+// that works on their values: a copy of a table only adds a reference, the
+// definitions are copied when a shared table is changed (copy on write).
+// The values refer to their definition by index; a full API_Property is made
+// only at the API calls:
+//	- a read request has the guid of the definition only, the API fills in
+//	  the rest
+//	- a written property gets the whole definition
+// A table is changed on the main thread only.
+// -----------------------------------------------------------------------------
+
+class DefinitionTable
+{
+public:
+	DefinitionTable ();
+	explicit DefinitionTable (const GS::Array<API_PropertyDefinition>& definitionsToShare);
+
+	UInt32										GetSize () const;
+	bool										IsEmpty () const;
+	const API_PropertyDefinition&				operator[] (UInt32 index) const;
+	const GS::Array<API_PropertyDefinition>&	GetDefinitions () const;
+
+	bool		Find (const API_Guid& guid, UInt32& index) const;
+	UInt32		Add (const API_PropertyDefinition& definition);		// the index of the definition, added if it is not in the table
+	void		Clear ();
+
+	bool		IsShared () const;
+
+	void		MakeRequest (UInt32 index, API_Property& property) const;
+	void		MakeProperty (UInt32 index, bool isDefault, const API_PropertyValue& value, API_Property& property) const;
+
+private:
+	struct Data {
+		GS::Array<API_PropertyDefinition>					definitions;
+		std::unordered_map<API_Guid, UInt32, GuidHash>		indices;		// guid -> definition
+	};
+
+	static const std::shared_ptr<Data>&		GetEmptyData ();
+
+	Data&		Edit ();
+
+	std::shared_ptr<Data>	data;
+};
+
+}
+
+#endif
@@ -0,0 +1,292 @@
+// *****************************************************************************
+// File:			Property_Test_ElementEdit.cpp
+// Description:		Property_Test add-on bulk masked element changes
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestBatch
+// Contact person:	CSAT
+// *****************************************************************************
+
+#include "Property_Test_ElementEdit.hpp"
+#include "Property_Test_Batch.hpp"
+#include "Property_Test_Helpers.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+// Elements changed between two checks of the cancel button
+static const UInt32 CancelCheckInterval = 64;
+
+
+// -----------------------------------------------------------------------------
+// Writing a value into a field: false if the type of the value does not fit,
+// changed is set if the field gets a new value
+// -----------------------------------------------------------------------------
+
+static bool ApplyValue (Int32& field, const API_Variant& value, bool& changed)
+{
+	if (value.type != API_PropertyIntegerValueType) {
+		return false;
+	}
+	changed = changed || field != value.intValue;
+	field = value.intValue;
+	return true;
+}
+
+
+static bool ApplyValue (double& field, const API_Variant& value, bool& changed)
+{
+	double newValue = 0.0;
+	if (value.type == API_PropertyRealValueType) {
+		newValue = value.doubleValue;
+	} else if (value.type == API_PropertyIntegerValueType) {
+		newValue = value.intValue;
+	} else {
+		return false;
+	}
+	changed = changed || field != newValue;
+	field = newValue;
+	return true;
+}
+
+
+static bool ApplyValue (bool& field, const API_Variant& value, bool& changed)
+{
+	if (value.type != API_PropertyBooleanValueType) {
+		return false;
+	}
+	changed = changed || field != value.boolValue;
+	field = value.boolValue;
+	return true;
+}
+
+
+// -----------------------------------------------------------------------------
+// The fields that can be edited
+// -----------------------------------------------------------------------------
+
+struct ElementField {
+	API_ElemTypeID	typeID;
+	const char*		path;
+	void			(*setMask) (API_Element& mask);
+	bool			(*apply) (API_Element& element, const API_Variant& value, bool& changed);
+};
+
+#define ELEMENT_FIELD(typeID, member, memberType, field)													\
+	{ typeID, #member "." #field,																			\
+	  [] (API_Element& mask) { ACAPI_ELEMENT_MASK_SET (mask, memberType, field); },							\
+	  [] (API_Element& element, const API_Variant& value, bool& changed) { return ApplyValue (element.member.field, value, changed); } }
+
+static const ElementField elementFields[] = {
+	ELEMENT_FIELD (API_WallID,			wall,			API_WallType,			thickness),
+	ELEMENT_FIELD (API_WallID,			wall,			API_WallType,			height),
+	ELEMENT_FIELD (API_WallID,			wall,			API_WallType,			bottomOffset),
+	ELEMENT_FIELD (API_WallID,			wall,			API_WallType,			flipped),
+	ELEMENT_FIELD (API_SlabID,			slab,			API_SlabType,			thickness),
+	ELEMENT_FIELD (API_SlabID,			slab,			API_SlabType,			level),
+	ELEMENT_FIELD (API_CurtainWallID,	curtainWall,	API_CurtainWallType,	nSegments),
+};
+
+#undef ELEMENT_FIELD
+
+static const UInt32 ElementFieldCount = sizeof (elementFields) / sizeof (elementFields[0]);
+
+
+static bool FindElementField (const char* path, UInt32& fieldIndex)
+{
+	for (UInt32 i = 0; i < ElementFieldCount; ++i) {
+		if (std::strcmp (elementFields[i].path, path) == 0) {
+			fieldIndex = i;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+// -----------------------------------------------------------------------------
+// ElementEditStatistics
+// -----------------------------------------------------------------------------
+
+PropertyTestBatch::ElementEditStatistics::ElementEditStatistics () :
+	editCount (0),
+	badValueCount (0),
+	elementCount (0),
+	changedCount (0),
+	unchangedCount (0),
+	otherTypeCount (0),
+	failedCount (0),
+	getSeconds (0.0),
+	changeSeconds (0.0),
+	totalSeconds (0.0),
+	canceled (false)
+{
+}
+
+
+void PropertyTestBatch::ElementEditStatistics::Report (const char* commandName) const
+{
+	WriteReport ("%s: %u edit(s) of %u element(s), %u changed, %u already up to date, %u of other type(s), %u failed",
+				 commandName, editCount, elementCount, changedCount, unchangedCount, otherTypeCount, failedCount);
+	if (badValueCount > 0) {
+		WriteReport ("  %u edit(s) with a value not fitting the field", badValueCount);
+	}
+	WriteReport ("  get     %8.3f s", getSeconds);
+	WriteReport ("  change  %8.3f s, %.0f element(s)/s", changeSeconds, (changeSeconds > 0.0) ? changedCount / changeSeconds : 0.0);
+	WriteReport ("  total   %8.3f s, %.0f element(s)/s", totalSeconds, (totalSeconds > 0.0) ? elementCount / totalSeconds : 0.0);
+	if (canceled) {
+		WriteReport ("  canceled by the user");
+	}
+}
+
+
+// -----------------------------------------------------------------------------
+// BulkElementEditor
+// -----------------------------------------------------------------------------
+
+PropertyTestBatch::BulkElementEditor::BulkElementEditor () :
+	progress (nullptr)
+{
+}
+
+
+void PropertyTestBatch::BulkElementEditor::SetProgress (PropertyTestHelpers::Progress* progressToReport)
+{
+	progress = progressToReport;
+}
+
+
+bool PropertyTestBatch::BulkElementEditor::Add (const API_Guid& elemGuid, const char* fieldPath, const API_Variant& value)
+{
+	Edit edit;
+	if (!FindElementField (fieldPath, edit.fieldIndex)) {
+		return false;
+	}
+	edit.elemGuid = elemGuid;
+	edit.value = value;
+	edit.order = static_cast<UInt32> (edits.size ());
+	edits.push_back (edit);
+	return true;
+}
+
+
+void PropertyTestBatch::BulkElementEditor::Clear ()
+{
+	edits.clear ();
+}
+
+
+GSErrCode PropertyTestBatch::BulkElementEditor::Run ()
+{
+	Stopwatch totalStopwatch;
+	statistics = ElementEditStatistics ();
+	statistics.editCount = static_cast<UInt32> (edits.size ());
+
+	// the edits of a type are next to each other, in them the edits of an element, in the order they were added
+	std::sort (edits.begin (), edits.end (), [] (const Edit& lhs, const Edit& rhs) {
+		const API_ElemTypeID lhsTypeID = elementFields[lhs.fieldIndex].typeID;
+		const API_ElemTypeID rhsTypeID = elementFields[rhs.fieldIndex].typeID;
+		if (lhsTypeID != rhsTypeID) {
+			return lhsTypeID < rhsTypeID;
+		}
+		const int compare = std::memcmp (&lhs.elemGuid, &rhs.elemGuid, sizeof (API_Guid));
+		return compare < 0 || (compare == 0 && lhs.order < rhs.order);
+	});
+	for (size_t i = 0; i < edits.size (); ++i) {
+		if (i == 0 || edits[i].elemGuid != edits[i - 1].elemGuid ||
+			elementFields[edits[i].fieldIndex].typeID != elementFields[edits[i - 1].fieldIndex].typeID)
+		{
+			++statistics.elementCount;
+		}
+	}
+
+	if (progress != nullptr) {
+		progress->SetItemCount (statistics.elementCount);
+	}
+
+	// one buffer and one mask for every element
+	API_Element element;
+	API_Element mask;
+	BNZeroMemory (&element, sizeof (API_Element));
+
+	GSErrCode error = NoError;
+	Stopwatch stopwatch;
+	UInt32 elementIndex = 0;
+	size_t typeBegin = 0;
+	while (typeBegin < edits.size () && error == NoError) {
+		const API_ElemTypeID typeID = elementFields[edits[typeBegin].fieldIndex].typeID;
+		size_t typeEnd = typeBegin;
+		while (typeEnd < edits.size () && elementFields[edits[typeEnd].fieldIndex].typeID == typeID) {
+			++typeEnd;
+		}
+
+		// the mask of every field edited on this type: the fields not edited on an element are written back unchanged
+		ACAPI_ELEMENT_MASK_CLEAR (mask);
+		for (size_t i = typeBegin; i < typeEnd; ++i) {
+			elementFields[edits[i].fieldIndex].setMask (mask);
+		}
+
+		size_t elemBegin = typeBegin;
+		while (elemBegin < typeEnd) {
+			size_t elemEnd = elemBegin + 1;
+			while (elemEnd < typeEnd && edits[elemEnd].elemGuid == edits[elemBegin].elemGuid) {
+				++elemEnd;
+			}
+
+			if (progress != nullptr) {
+				if (elementIndex % CancelCheckInterval == 0 && progress->IsCanceled ()) {
+					statistics.canceled = true;
+					error = APIERR_CANCEL;
+					break;
+				}
+				progress->Advance ();
+			}
+			++elementIndex;
+
+			// ACAPI_Element_Get needs the guid only, it overwrites the rest
+			BNZeroMemory (&element.header, sizeof (API_Elem_Head));
+			element.header.guid = edits[elemBegin].elemGuid;
+
+			stopwatch.Restart ();
+			const GSErrCode getError = COLLECT_ERROR (ACAPI_Element_Get (&element));
+			statistics.getSeconds += stopwatch.GetSeconds ();
+
+			if (getError != NoError) {
+				++statistics.failedCount;
+			} else if (element.header.typeID != typeID) {
+				++statistics.otherTypeCount;
+			} else {
+				bool changed = false;
+				for (size_t i = elemBegin; i < elemEnd; ++i) {
+					if (!elementFields[edits[i].fieldIndex].apply (element, edits[i].value, changed)) {
+						++statistics.badValueCount;
+					}
+				}
+
+				if (!changed) {
+					++statistics.unchangedCount;
+				} else {
+					stopwatch.Restart ();
+					if (COLLECT_ERROR (ACAPI_Element_Change (&element, &mask, nullptr, 0, true)) == NoError) {
+						++statistics.changedCount;
+					} else {
+						++statistics.failedCount;
+					}
+					statistics.changeSeconds += stopwatch.GetSeconds ();
+				}
+			}
+
+			elemBegin = elemEnd;
+		}
+
+		typeBegin = typeEnd;
+	}
+
+	statistics.totalSeconds = totalStopwatch.GetSeconds ();
+	return error;
+}
+
+
+const PropertyTestBatch::ElementEditStatistics& PropertyTestBatch::BulkElementEditor::GetStatistics () const
+{
+	return statistics;
+}
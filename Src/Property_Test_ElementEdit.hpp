@@ -0,0 +1,91 @@
+// *****************************************************************************
+// File:			Property_Test_ElementEdit.hpp
+// Description:		Property_Test add-on bulk masked element changes
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestBatch
+// Contact person:	CSAT
+// *****************************************************************************
+
+#if !defined (ELEMENTEDIT_HPP)
+#define	ELEMENTEDIT_HPP
+
+#include "Property_Test.hpp"
+#include "Property_Test_Progress.hpp"
+
+#include <vector>
+
+namespace PropertyTestBatch
+{
+
+// -----------------------------------------------------------------------------
+// Statistics of one bulk element change
+// -----------------------------------------------------------------------------
+
+struct ElementEditStatistics {
+	UInt32		editCount;
+	UInt32		badValueCount;		// the type of the value does not fit the field: not applied
+	UInt32		elementCount;
+	UInt32		changedCount;
+	UInt32		unchangedCount;		// the element has the target values already: not written
+	UInt32		otherTypeCount;		// not of the type of the edited fields: skipped
+	UInt32		failedCount;
+	double		getSeconds;
+	double		changeSeconds;
+	double		totalSeconds;
+	bool		canceled;
+
+	ElementEditStatistics ();
+
+	void		Report (const char* commandName) const;
+};
+
+
+// -----------------------------------------------------------------------------
+// Changes fields of elements, given as (element guid, field path, value)
+// edits. The field path is the member of API_Element and the field, for
+// example "curtainWall.nSegments" or "wall.height"; the type of the value
+// must fit the field (API_PropertyIntegerValueType for an integer field, a
+// number for a real one, API_PropertyBooleanValueType for a flag).
+// The edits are grouped by element type and by element:
+//	- the mask is built once per type, from every field edited on that type
+//	- each element is read with one ACAPI_Element_Get and, if any of its
+//	  fields changes, written with one masked ACAPI_Element_Change, however
+//	  many of its fields are edited; an element of another type is skipped
+//	  after its get, before any field is applied
+// One element buffer and one mask are used for every element; the buffer
+// is not cleared between the elements, ACAPI_Element_Get overwrites it.
+// The later edit of the same field of an element wins.
+// With a Progress, cancellation is checked between the elements: the elements
+// changed so far stay changed.
+// -----------------------------------------------------------------------------
+
+class BulkElementEditor
+{
+public:
+	BulkElementEditor ();
+
+	void		SetProgress (PropertyTestHelpers::Progress* progressToReport);
+
+	bool		Add (const API_Guid& elemGuid, const char* fieldPath, const API_Variant& value);	// false if the field is unknown
+	void		Clear ();
+
+	GSErrCode	Run ();			// APIERR_CANCEL if the user canceled it
+
+	const ElementEditStatistics&	GetStatistics () const;
+
+private:
+	struct Edit {
+		API_Guid		elemGuid;
+		UInt32			fieldIndex;
+		API_Variant		value;
+		UInt32			order;
+	};
+
+	std::vector<Edit>				edits;
+	PropertyTestHelpers::Progress*	progress;
+	ElementEditStatistics			statistics;
+};
+
+}
+
+#endif
@@ -0,0 +1,216 @@
+// *****************************************************************************
+// File:			Property_Test_EnumIndex.cpp
+// Description:		Property_Test add-on ordinal index of enumeration values
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestHelpers
+// Contact person:	CSAT
+// *****************************************************************************
+
+#include "Property_Test_EnumIndex.hpp"
+#include "Property_Test_Helpers.hpp"
+
+#include <algorithm>
+
+
+static UInt32 CountBits (UInt64 word)
+{
+	UInt32 count = 0;
+	for (; word != 0; word &= word - 1) {
+		++count;
+	}
+	return count;
+}
+
+
+// -----------------------------------------------------------------------------
+// EnumSet
+// -----------------------------------------------------------------------------
+
+PropertyTestHelpers::EnumSet::EnumSet () :
+	firstWord (0)
+{
+}
+
+
+void PropertyTestHelpers::EnumSet::Add (UInt32 ordinal)
+{
+	const UInt32 wordIndex = ordinal / WordBits;
+	const UInt64 bit = 1ULL << (ordinal % WordBits);
+	if (wordIndex == 0) {
+		firstWord |= bit;
+		return;
+	}
+	if (moreWords.size () < wordIndex) {
+		moreWords.resize (wordIndex, 0);
+	}
+	moreWords[wordIndex - 1] |= bit;
+}
+
+
+void PropertyTestHelpers::EnumSet::Remove (UInt32 ordinal)
+{
+	const UInt32 wordIndex = ordinal / WordBits;
+	const UInt64 bit = 1ULL << (ordinal % WordBits);
+	if (wordIndex == 0) {
+		firstWord &= ~bit;
+	} else if (wordIndex <= moreWords.size ()) {
+		moreWords[wordIndex - 1] &= ~bit;
+	}
+}
+
+
+void PropertyTestHelpers::EnumSet::Clear ()
+{
+	firstWord = 0;
+	moreWords.clear ();
+}
+
+
+bool PropertyTestHelpers::EnumSet::Contains (UInt32 ordinal) const
+{
+	return (GetWord (ordinal / WordBits) & (1ULL << (ordinal % WordBits))) != 0;
+}
+
+
+bool PropertyTestHelpers::EnumSet::ContainsAll (const EnumSet& other) const
+{
+	const UInt32 wordCount = other.GetWordCount ();
+	for (UInt32 i = 0; i < wordCount; ++i) {
+		const UInt64 otherWord = other.GetWord (i);
+		if ((GetWord (i) & otherWord) != otherWord) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+bool PropertyTestHelpers::EnumSet::IsEmpty () const
+{
+	return GetCount () == 0;
+}
+
+
+UInt32 PropertyTestHelpers::EnumSet::GetCount () const
+{
+	UInt32 count = CountBits (firstWord);
+	for (UInt64 word : moreWords) {
+		count += CountBits (word);
+	}
+	return count;
+}
+
+
+bool PropertyTestHelpers::EnumSet::operator== (const EnumSet& other) const
+{
+	const UInt32 wordCount = std::max (GetWordCount (), other.GetWordCount ());
+	for (UInt32 i = 0; i < wordCount; ++i) {
+		if (GetWord (i) != other.GetWord (i)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+bool PropertyTestHelpers::EnumSet::operator!= (const EnumSet& other) const
+{
+	return !(*this == other);
+}
+
+
+UInt32 PropertyTestHelpers::EnumSet::GetWordCount () const
+{
+	return 1 + static_cast<UInt32> (moreWords.size ());
+}
+
+
+UInt64 PropertyTestHelpers::EnumSet::GetWord (UInt32 wordIndex) const
+{
+	if (wordIndex == 0) {
+		return firstWord;
+	}
+	return (wordIndex <= moreWords.size ()) ? moreWords[wordIndex - 1] : 0;
+}
+
+
+// -----------------------------------------------------------------------------
+// EnumIndex
+// -----------------------------------------------------------------------------
+
+PropertyTestHelpers::EnumIndex::EnumIndex ()
+{
+}
+
+
+PropertyTestHelpers::EnumIndex::EnumIndex (const API_PropertyDefinition& definition) :
+	values (definition.possibleEnumValues)
+{
+	guidOrdinals.reserve (values.GetSize ());
+	textOrdinals.reserve (values.GetSize ());
+	for (UInt32 i = 0; i < values.GetSize (); ++i) {
+		guidOrdinals.emplace (values[i].guid, i);
+		textOrdinals.emplace (ToString (values[i].variant).ToCStr (CC_UTF8).Get (), i);
+	}
+}
+
+
+UInt32 PropertyTestHelpers::EnumIndex::GetSize () const
+{
+	return values.GetSize ();
+}
+
+
+const API_SingleEnumerationVariant& PropertyTestHelpers::EnumIndex::Get (UInt32 ordinal) const
+{
+	return values[ordinal];
+}
+
+
+bool PropertyTestHelpers::EnumIndex::FindByGuid (const API_Guid& guid, UInt32& ordinal) const
+{
+	auto found = guidOrdinals.find (guid);
+	if (found == guidOrdinals.end ()) {
+		return false;
+	}
+	ordinal = found->second;
+	return true;
+}
+
+
+bool PropertyTestHelpers::EnumIndex::FindByText (const char* text, size_t length, UInt32& ordinal) const
+{
+	auto found = textOrdinals.find (std::string (text, length));
+	if (found == textOrdinals.end ()) {
+		return false;
+	}
+	ordinal = found->second;
+	return true;
+}
+
+
+bool PropertyTestHelpers::EnumIndex::ToSet (const API_MultipleEnumerationVariant& value, EnumSet& set) const
+{
+	set.Clear ();
+	bool isComplete = true;
+	for (UInt32 i = 0; i < value.variants.GetSize (); ++i) {
+		UInt32 ordinal = 0;
+		if (FindByGuid (value.variants[i].guid, ordinal)) {
+			set.Add (ordinal);
+		} else {
+			isComplete = false;
+		}
+	}
+	return isComplete;
+}
+
+
+void PropertyTestHelpers::EnumIndex::ToValue (const EnumSet& set, API_MultipleEnumerationVariant& value) const
+{
+	value.variants.Clear ();
+	for (UInt32 i = 0; i < values.GetSize (); ++i) {
+		if (set.Contains (i)) {
+			value.variants.Push (values[i]);
+		}
+	}
+}
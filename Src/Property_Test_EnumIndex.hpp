@@ -0,0 +1,87 @@
+// *****************************************************************************
+// File:			Property_Test_EnumIndex.hpp
+// Description:		Property_Test add-on ordinal index of enumeration values
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestHelpers
+// Contact person:	CSAT
+// *****************************************************************************
+
+#if !defined (ENUMINDEX_HPP)
+#define	ENUMINDEX_HPP
+
+#include "Property_Test.hpp"
+#include "Property_Test_Helpers.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace PropertyTestHelpers
+{
+
+// -----------------------------------------------------------------------------
+// A set of enumeration values as a bitset over their ordinals. The first 64
+// ordinals are kept inline, so the set of a usual enumeration costs no
+// allocation; setting, comparing and testing are word operations.
+// -----------------------------------------------------------------------------
+
+class EnumSet
+{
+public:
+	EnumSet ();
+
+	void		Add (UInt32 ordinal);
+	void		Remove (UInt32 ordinal);
+	void		Clear ();
+
+	bool		Contains (UInt32 ordinal) const;
+	bool		ContainsAll (const EnumSet& other) const;
+	bool		IsEmpty () const;
+	UInt32		GetCount () const;
+
+	bool		operator== (const EnumSet& other) const;
+	bool		operator!= (const EnumSet& other) const;
+
+private:
+	static const UInt32	WordBits = 64;
+
+	UInt32		GetWordCount () const;
+	UInt64		GetWord (UInt32 wordIndex) const;		// 0 beyond the stored words
+
+	UInt64					firstWord;		// ordinals 0-63
+	std::vector<UInt64>		moreWords;		// ordinals from 64
+};
+
+
+// -----------------------------------------------------------------------------
+// The possible values of an enumeration definition by ordinal (their index
+// in possibleEnumValues), found by guid or by display text with one hash
+// lookup. The definitions of the same guid give the same ordinals, so the
+// sets of an index can be tested against the sets of another one.
+// -----------------------------------------------------------------------------
+
+class EnumIndex
+{
+public:
+	EnumIndex ();
+	explicit EnumIndex (const API_PropertyDefinition& definition);
+
+	UInt32									GetSize () const;
+	const API_SingleEnumerationVariant&		Get (UInt32 ordinal) const;
+
+	bool		FindByGuid (const API_Guid& guid, UInt32& ordinal) const;
+	bool		FindByText (const char* text, size_t length, UInt32& ordinal) const;		// UTF-8; the first of equal texts
+
+	// false if a value is not a possible one (e.g. it was deleted since), it is left out of the set
+	bool		ToSet (const API_MultipleEnumerationVariant& value, EnumSet& set) const;
+	void		ToValue (const EnumSet& set, API_MultipleEnumerationVariant& value) const;	// in the order of the possible values
+
+private:
+	GS::Array<API_SingleEnumerationVariant>				values;
+	std::unordered_map<API_Guid, UInt32, GuidHash>		guidOrdinals;
+	std::unordered_map<std::string, UInt32>				textOrdinals;
+};
+
+}
+
+#endif
@@ -0,0 +1,134 @@
+// *****************************************************************************
+// File:			Property_Test_ErrorLog.cpp
+// Description:		Property_Test add-on per-command error aggregation
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestHelpers
+// Contact person:	CSAT
+// *****************************************************************************
+
+#include "Property_Test_Helpers.hpp"
+#include "Property_Test_TestRunner.hpp"
+
+#include <algorithm>
+#include <vector>
+
+static PropertyTestHelpers::ErrorLog* activeLog = nullptr;
+
+static const UInt32 MaxReportedCallSites = 20;
+
+
+PropertyTestHelpers::ErrorLog::ErrorLog () :
+	errorCount (0),
+	reported (false),
+	previous (activeLog)
+{
+	activeLog = this;
+}
+
+
+PropertyTestHelpers::ErrorLog::~ErrorLog ()
+{
+	activeLog = previous;
+}
+
+
+void PropertyTestHelpers::ErrorLog::Record (GSErrCode error, const char* expression, const char* file, UInt32 line, const char* function)
+{
+	CallSite site = { error, file, line };
+	auto it = entries.find (site);
+	if (it == entries.end ()) {
+		Entry entry = { 0, expression, function };
+		it = entries.emplace (site, entry).first;
+	}
+
+	++it->second.count;
+	++errorCount;
+}
+
+
+UInt32 PropertyTestHelpers::ErrorLog::GetErrorCount () const
+{
+	return errorCount;
+}
+
+
+UInt32 PropertyTestHelpers::ErrorLog::GetErrorCount (GSErrCode error) const
+{
+	UInt32 count = 0;
+	for (const auto& entry : entries) {
+		if (entry.first.error == error) {
+			count += entry.second.count;
+		}
+	}
+	return count;
+}
+
+
+bool PropertyTestHelpers::ErrorLog::IsEmpty () const
+{
+	return errorCount == 0;
+}
+
+
+void PropertyTestHelpers::ErrorLog::ReportSummary (const GS::UniString& commandName)
+{
+	if (reported || IsEmpty ()) {
+		return;
+	}
+	reported = true;
+
+	typedef std::pair<CallSite, Entry> SiteEntry;
+	std::vector<SiteEntry> sorted (entries.begin (), entries.end ());
+	std::sort (sorted.begin (), sorted.end (), [] (const SiteEntry& lhs, const SiteEntry& rhs) {
+		return lhs.second.count > rhs.second.count;
+	});
+
+	WriteReport ("%s: %u failed API call(s) at %u call site(s)",
+				 commandName.ToCStr ().Get (), errorCount, static_cast<UInt32> (sorted.size ()));
+
+	GS::UniString details;
+	for (UInt32 i = 0; i < sorted.size (); ++i) {
+		const CallSite& site = sorted[i].first;
+		const Entry& entry = sorted[i].second;
+		WriteReport ("  %6u x %s (%d) in %s, %s:%u: %s", entry.count, ErrID_To_Name (site.error), (int) site.error,
+					 entry.function, site.file, site.line, entry.expression);
+
+		if (i < MaxReportedCallSites) {
+			details += GS::ValueToUniString (entry.count) + " x " + ErrID_To_Name (site.error) +
+					   "\n    " + entry.expression + "\n";
+		}
+	}
+	if (sorted.size () > MaxReportedCallSites) {
+		details += "... (see the report window for the full list)";
+	}
+
+	DGAlert (DG_WARNING, commandName,
+			 GS::ValueToUniString (errorCount) + " API call(s) failed, the remaining elements were processed.",
+			 details, "Ok");
+}
+
+
+PropertyTestHelpers::ErrorLog* PropertyTestHelpers::ErrorLog::GetActive ()
+{
+	return activeLog;
+}
+
+
+GSErrCode PropertyTestHelpers::CollectError (GSErrCode error, const char* expression, const char* file, UInt32 line, const char* function)
+{
+	ErrorLog* log = ErrorLog::GetActive ();
+	if (log == nullptr) {
+		DebugAssertNoError (error, expression, file, line, function);		// counts the call for the TestRunner too
+		return error;
+	}
+
+	TestRunner* runner = TestRunner::GetActive ();
+	if (runner != nullptr) {
+		runner->RecordApiCall ();
+	}
+
+	if (error != NoError) {
+		log->Record (error, expression, file, line, function);
+	}
+	return error;
+}
@@ -0,0 +1,87 @@
+// *****************************************************************************
+// File:			Property_Test_ErrorLog.hpp
+// Description:		Property_Test add-on per-command error aggregation
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestHelpers
+// Contact person:	CSAT
+// *****************************************************************************
+
+#if !defined (ERRORLOG_HPP)
+#define	ERRORLOG_HPP
+
+#include "Property_Test.hpp"
+
+#include <unordered_map>
+
+namespace PropertyTestHelpers
+{
+
+// -----------------------------------------------------------------------------
+// Collects the failed API calls of one command instead of stopping at the
+// first one. Errors are counted per error code and call site; the summary is
+// emitted once, when the command ends.
+// While an ErrorLog object is alive it is the active log of the add-on.
+// -----------------------------------------------------------------------------
+
+class ErrorLog
+{
+public:
+	ErrorLog ();
+	~ErrorLog ();
+
+	void			Record (GSErrCode error, const char* expression, const char* file, UInt32 line, const char* function);
+
+	UInt32			GetErrorCount () const;
+	UInt32			GetErrorCount (GSErrCode error) const;
+	bool			IsEmpty () const;
+
+	void			ReportSummary (const GS::UniString& commandName);
+
+	static ErrorLog*	GetActive ();
+
+private:
+	struct CallSite {
+		GSErrCode		error;
+		const char*		file;		// __FILE__ literals, compared by address
+		UInt32			line;
+
+		bool operator== (const CallSite& other) const
+		{
+			return error == other.error && file == other.file && line == other.line;
+		}
+	};
+
+	struct CallSiteHash {
+		size_t operator() (const CallSite& site) const
+		{
+			return std::hash<const void*> () (site.file) ^ (static_cast<size_t> (site.line) << 16) ^ static_cast<size_t> (site.error);
+		}
+	};
+
+	struct Entry {
+		UInt32			count;
+		const char*		expression;
+		const char*		function;
+	};
+
+	ErrorLog (const ErrorLog&);				// disabled
+	ErrorLog& operator= (const ErrorLog&);	// disabled
+
+	std::unordered_map<CallSite, Entry, CallSiteHash>	entries;
+	UInt32			errorCount;
+	bool			reported;
+	ErrorLog*		previous;
+};
+
+
+// -----------------------------------------------------------------------------
+// Records the error into the active log and returns it, so the caller can
+// skip the failed item. Without an active log it behaves like
+// DebugAssertNoError (alert + exception).
+// -----------------------------------------------------------------------------
+
+GSErrCode		CollectError (GSErrCode error, const char* expression, const char* file, UInt32 line, const char* function);
+
+}
+
+#endif
@@ -7,19 +7,28 @@
 // *****************************************************************************
 
 #include "Property_Test_Helpers.hpp"
+#include "Property_Test_DefinitionTable.hpp"
+#include "Property_Test_IdGenerator.hpp"
+#include "Property_Test_TestRunner.hpp"
+
+#include <cstring>
+
+size_t PropertyTestHelpers::GuidHash::operator() (const API_Guid& guid) const
+{
+	UInt64 words[2];
+	std::memcpy (words, &guid, sizeof (words));
+	return static_cast<size_t> (words[0] ^ (words[1] * 0x9e3779b97f4a7c15ULL));
+}
+
 
 API_Guid PropertyTestHelpers::RandomGuid () {
-	GS::Guid guid;
-	guid.Generate ();
-	return GSGuid2APIGuid (guid);
+	return IdGenerator::Get ().NextGuid ();
 }
 
 
 GS::UniString PropertyTestHelpers::GenearteUniqueName () 
 {
-	GS::Guid guid;
-	guid.Generate ();
-	return guid.ToUniString ();
+	return IdGenerator::Get ().NextName ();
 }
 
 
@@ -27,7 +36,7 @@ API_PropertyGroup PropertyTestHelpers::CreateExamplePropertyGroup ()
 {
 	API_PropertyGroup group;
 	group.guid = APINULLGuid;
-	group.name = "Property_Test Add-On Group - " + PropertyTestHelpers::GenearteUniqueName ();
+	group.name = PropertyTestHelpers::IdGenerator::Get ().NextName ("Property_Test Add-On Group - ");
 	return group;
 }
 
@@ -74,7 +83,7 @@ static API_PropertyDefinition CreateExamplePropertyDefinition (API_PropertyGroup
 	API_PropertyDefinition definition;
 	definition.guid = APINULLGuid;
 	definition.groupGuid = group.guid;
-	definition.name = "Property_Test Add-On Definition - " + PropertyTestHelpers::GenearteUniqueName ();
+	definition.name = PropertyTestHelpers::IdGenerator::Get ().NextName ("Property_Test Add-On Definition - ");
 	definition.description = "An example property definition.";
 	return definition;
 }
@@ -138,7 +147,7 @@ API_PropertyDefinition PropertyTestHelpers::CreateExampleStringMultiEnumProperty
 }
 
 
-GSErrCode PropertyTestHelpers::GetElemCategoryValue (const API_Guid& elemGuid, API_ElemCategoryValue& catValue) 
+GSErrCode PropertyTestHelpers::GetElemClassificationCategory (API_ElemCategory& category)
 {
 	GS::Array<API_ElemCategory> categoryList;
 	GSErrCode error = ACAPI_Database (APIDb_GetElementCategoriesID, &categoryList);
@@ -146,13 +155,26 @@ GSErrCode PropertyTestHelpers::GetElemCategoryValue (const API_Guid& elemGuid, A
 		return error;
 	}
 
-	categoryList.Enumerate ([&] (const API_ElemCategory& category) {
-		if (category.categoryID == API_ElemCategory_ElementClassification) {
-			error = ACAPI_Element_GetCategoryValue (elemGuid, category, &catValue);
+	for (UInt32 i = 0; i < categoryList.GetSize (); ++i) {
+		if (categoryList[i].categoryID == API_ElemCategory_ElementClassification) {
+			category = categoryList[i];
+			return NoError;
 		}
-	});
+	}
 
-	return error;
+	return APIERR_GENERAL;
+}
+
+
+GSErrCode PropertyTestHelpers::GetElemCategoryValue (const API_Guid& elemGuid, API_ElemCategoryValue& catValue) 
+{
+	API_ElemCategory category;
+	GSErrCode error = GetElemClassificationCategory (category);
+	if (error != NoError) {
+		return error;
+	}
+
+	return ACAPI_Element_GetCategoryValue (elemGuid, category, &catValue);
 }
 
 
@@ -174,6 +196,54 @@ GSErrCode PropertyTestHelpers::GetElemCategoryValueDefault (API_ElemTypeID typeI
 }
 
 
+bool PropertyTestHelpers::IsPropertyAvailable (const API_PropertyDefinition& definition, const API_ElemCategoryValue& catValue)
+{
+	for (UInt32 i = 0; i < definition.availability.GetSize (); ++i) {
+		if (definition.availability[i].guid == catValue.guid) {
+			return true;
+		}
+	}
+	return false;
+}
+
+
+// The definitions which are not available for the element would fail the whole
+// ACAPI_Element_GetProperties call, so only the available ones are read.
+// definitionIndices gets the index in definitions of each read property.
+GSErrCode PropertyTestHelpers::GetAvailableProperties (const API_Guid& elemGuid, const API_ElemCategory& classificationCategory,
+													   const DefinitionTable& definitions,
+													   GS::Array<API_Property>& properties, GS::Array<UInt32>& definitionIndices)
+{
+	properties.Clear ();
+	definitionIndices.Clear ();
+
+	API_ElemCategoryValue catValue;
+	GSErrCode error = COLLECT_ERROR (ACAPI_Element_GetCategoryValue (elemGuid, classificationCategory, &catValue));
+	if (error != NoError) {
+		return error;
+	}
+
+	for (UInt32 i = 0; i < definitions.GetSize (); ++i) {
+		if (IsPropertyAvailable (definitions[i], catValue)) {
+			API_Property property;
+			definitions.MakeRequest (i, property);
+			properties.Push (property);
+			definitionIndices.Push (i);
+		}
+	}
+	if (properties.IsEmpty ()) {
+		return NoError;
+	}
+
+	error = COLLECT_ERROR (ACAPI_Element_GetProperties (elemGuid, properties));
+	if (error != NoError) {
+		properties.Clear ();
+		definitionIndices.Clear ();
+	}
+	return error;
+}
+
+
 GS::Array<API_Guid>	PropertyTestHelpers::GetSelectedElements (bool assertIfNoSel /* = true*/) 
 {
 	GSErrCode            err;
@@ -229,39 +299,31 @@ GS::UniString PropertyTestHelpers::ToString (const API_Variant& variant)
 }
 
 
-GS::UniString PropertyTestHelpers::ToString (const API_Property& property) 
+GS::UniString PropertyTestHelpers::ToString (const API_PropertyValue& value, API_PropertyCollectionType collectionType)
 {
 	GS::UniString string;
-	string += property.definition.name;
-	string += ": ";
-	const API_PropertyValue* value;
-	if (property.isDefault) {
-		value = &property.definition.defaultValue;
-	} else {
-		value = &property.value;
-	}
-	switch (property.definition.collectionType) {
+	switch (collectionType) {
 		case API_PropertySingleCollectionType: {
-			string += ToString (value->singleVariant.variant);
+			string += ToString (value.singleVariant.variant);
 		} break;
 		case API_PropertyListCollectionType: {
 			string += '[';
-			for (UInt32 i = 0; i < value->listVariant.variants.GetSize (); i++) {
-				string += ToString (value->listVariant.variants[i]);
-				if (i != value->listVariant.variants.GetSize () - 1) {
+			for (UInt32 i = 0; i < value.listVariant.variants.GetSize (); i++) {
+				string += ToString (value.listVariant.variants[i]);
+				if (i != value.listVariant.variants.GetSize () - 1) {
 					string += ", ";
 				}
 			}
 			string += ']';
 		} break;
 		case API_PropertySingleChoiceEnumerationCollectionType: {
-			string += ToString (value->singleEnumVariant.variant);
+			string += ToString (value.singleEnumVariant.variant);
 		} break;
 		case API_PropertyMultipleChoiceEnumerationCollectionType: {
 			string += '[';
-			for (UInt32 i = 0; i < value->multipleEnumVariant.variants.GetSize (); i++) {
-				string += ToString (value->multipleEnumVariant.variants[i].variant);
-				if (i != value->multipleEnumVariant.variants.GetSize () - 1) {
+			for (UInt32 i = 0; i < value.multipleEnumVariant.variants.GetSize (); i++) {
+				string += ToString (value.multipleEnumVariant.variants[i].variant);
+				if (i != value.multipleEnumVariant.variants.GetSize () - 1) {
 					string += ", ";
 				}
 			}
@@ -276,6 +338,20 @@ GS::UniString PropertyTestHelpers::ToString (const API_Property& property)
 }
 
 
+GS::UniString PropertyTestHelpers::ToString (const API_Property& property) 
+{
+	GS::UniString string;
+	string += property.definition.name;
+	string += ": ";
+	if (property.isDefault) {
+		string += ToString (property.definition.defaultValue, property.definition.collectionType);
+	} else {
+		string += ToString (property.value, property.definition.collectionType);
+	}
+	return string;
+}
+
+
 void PropertyTestHelpers::DebugAssert (bool success, GS::UniString expression, const char* file, UInt32 line, const char* function)
 {
 	if (success) {
@@ -284,6 +360,13 @@ void PropertyTestHelpers::DebugAssert (bool success, GS::UniString expression, c
 
 	expression += " is false.";
 
+	TestRunner* runner = TestRunner::GetActive ();
+	if (runner != nullptr) {
+		// the runner reports it with the test and goes on with the next one
+		runner->RecordFailure (expression + " At: " + GS::UniString (file) + ":" + GS::ValueToUniString (line));
+		throw GS::Exception (expression);
+	}
+
 #if defined (DEBUVERS)
 	DBBreak (file, line, expression.ToCStr ().Get (), nullptr, function, nullptr);
 #else
@@ -298,18 +381,29 @@ void PropertyTestHelpers::DebugAssert (bool success, GS::UniString expression, c
 
 void PropertyTestHelpers::DebugAssertNoError (GSErrCode error, GS::UniString expression, const char* file, UInt32 line, const char* function)
 {
+	TestRunner* runner = TestRunner::GetActive ();
+	if (runner != nullptr) {
+		runner->RecordApiCall ();
+	}
+
 	if (error == NoError) {
 		return;
 	}
 
 	expression += " returned with an error.";
 
+	if (runner != nullptr) {
+		runner->RecordFailure (expression + " ErrorCode: " + GS::UniString (ErrID_To_Name (error)) +
+							   " At: " + GS::UniString (file) + ":" + GS::ValueToUniString (line));
+		throw GS::Exception (expression);
+	}
+
 #if defined (DEBUVERS)
 	DBBreak (file, line, expression.ToCStr ().Get (), nullptr, function, nullptr);
 #else
 	UNUSED_PARAMETER (function);
 	DGAlert (DG_ERROR, "Assertion",	expression,
-			 "ErrorCode: " + GS::ValueToUniString (error) +
+			 "ErrorCode: " + GS::UniString (ErrID_To_Name (error)) + " (" + GS::ValueToUniString (error) + ")" +
 			 "\nAt: " + GS::UniString (file) + ":" + GS::ValueToUniString (line), "Ok");
 #endif
 
@@ -379,6 +473,71 @@ bool Equals (const API_PropertyValue& lhs, const API_PropertyValue& rhs, API_Pro
 }
 
 
+static ULong CombineHashValues (ULong seed, ULong hash)
+{
+	return seed ^ (hash + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+
+static ULong GenerateGuidHashValue (const API_Guid& guid)
+{
+	const UInt32* words = reinterpret_cast<const UInt32*> (&guid);
+	ULong hash = 0;
+	for (UInt32 i = 0; i < sizeof (API_Guid) / sizeof (UInt32); ++i) {
+		hash = CombineHashValues (hash, words[i]);
+	}
+	return hash;
+}
+
+
+// Consistent with operator== (API_Variant): equal variants have equal hash values
+ULong GenerateHashValue (const API_Variant& variant)
+{
+	ULong hash = static_cast<ULong> (variant.type);
+	switch (variant.type) {
+		case API_PropertyIntegerValueType:
+			return CombineHashValues (hash, static_cast<ULong> (variant.intValue));
+		case API_PropertyRealValueType: {
+			const double value = (variant.doubleValue == 0.0) ? 0.0 : variant.doubleValue;	// -0.0 == 0.0
+			UInt64 bits;
+			BNCopyMemory (&bits, &value, sizeof (bits));
+			return CombineHashValues (hash, static_cast<ULong> (bits ^ (bits >> 32)));
+		}
+		case API_PropertyStringValueType:
+			return CombineHashValues (hash, variant.uniStringValue.GenerateHashValue ());
+		case API_PropertyBooleanValueType:
+			return CombineHashValues (hash, variant.boolValue ? 1 : 0);
+		default:
+			return hash;
+	}
+}
+
+
+// Consistent with Equals (API_PropertyValue, ..., collType)
+ULong GenerateHashValue (const API_PropertyValue& value, API_PropertyCollectionType collType)
+{
+	ULong hash = static_cast<ULong> (collType);
+	switch (collType) {
+		case API_PropertySingleCollectionType:
+			return CombineHashValues (hash, GenerateHashValue (value.singleVariant.variant));
+		case API_PropertyListCollectionType:
+			for (UInt32 i = 0; i < value.listVariant.variants.GetSize (); ++i) {
+				hash = CombineHashValues (hash, GenerateHashValue (value.listVariant.variants[i]));
+			}
+			return hash;
+		case API_PropertySingleChoiceEnumerationCollectionType:
+			return CombineHashValues (hash, GenerateGuidHashValue (value.singleEnumVariant.guid));
+		case API_PropertyMultipleChoiceEnumerationCollectionType:
+			for (UInt32 i = 0; i < value.multipleEnumVariant.variants.GetSize (); ++i) {
+				hash = CombineHashValues (hash, GenerateGuidHashValue (value.multipleEnumVariant.variants[i].guid));
+			}
+			return hash;
+		default:
+			return hash;
+	}
+}
+
+
 bool operator== (const API_PropertyGroup& lhs, const API_PropertyGroup& rhs)
 {
 	return lhs.guid == rhs.guid && 
@@ -10,6 +10,7 @@
 #define	HELPERS_HPP
 
 #include "Property_Test.hpp"
+#include "Property_Test_ErrorLog.hpp"
 #include "ApiCommon.h"
 #include "DGModule.hpp"
 #include "StringConversion.hpp"
@@ -30,6 +31,14 @@
 #define ASSERT_NO_ERROR(expression) PropertyTestHelpers::DebugAssertNoError((expression), #expression, __FILE__, __LINE__, __FUNCTION__)
 
 
+// Records a failed call into the active ErrorLog and evaluates to the error code,
+// so batch commands can skip the failed item and go on
+#if defined (COLLECT_ERROR)
+	#undef COLLECT_ERROR
+#endif
+#define COLLECT_ERROR(expression) PropertyTestHelpers::CollectError((expression), #expression, __FILE__, __LINE__, __FUNCTION__)
+
+
 // -----------------------------------------------------------------------------
 // Helper functions
 // -----------------------------------------------------------------------------
@@ -37,6 +46,13 @@
 namespace PropertyTestHelpers 
 {
 
+class DefinitionTable;
+
+// Hash of a guid for the unordered containers keyed by API_Guid
+struct GuidHash {
+	size_t operator() (const API_Guid& guid) const;
+};
+
 API_Guid				RandomGuid ();
 
 GS::UniString			GenearteUniqueName ();
@@ -53,16 +69,26 @@ API_PropertyDefinition	CreateExampleStringListPropertyDefinition (API_PropertyGr
 
 API_PropertyDefinition	CreateExampleStringMultiEnumPropertyDefinition (API_PropertyGroup group);
 
+GSErrCode				GetElemClassificationCategory (API_ElemCategory& category);
+
 GSErrCode				GetElemCategoryValue (const API_Guid& elemGuid, API_ElemCategoryValue& catValue);
 
 GSErrCode				GetElemCategoryValueDefault (API_ElemTypeID typeId, API_ElemVariationID variationID, API_ElemCategoryValue& catValue);
 
+bool					IsPropertyAvailable (const API_PropertyDefinition& definition, const API_ElemCategoryValue& catValue);
+
+GSErrCode				GetAvailableProperties (const API_Guid& elemGuid, const API_ElemCategory& classificationCategory,
+												const DefinitionTable& definitions,
+												GS::Array<API_Property>& properties, GS::Array<UInt32>& definitionIndices);
+
 GS::Array<API_Guid>		GetSelectedElements (bool assertIfNoSel = true);
 
 GSErrCode				CallOnSelectedElem (GSErrCode (*function)(const API_Guid&), bool assertIfNoSel = true);
 
 GS::UniString			ToString (const API_Variant& variant);
 
+GS::UniString			ToString (const API_PropertyValue& value, API_PropertyCollectionType collectionType);
+
 GS::UniString			ToString (const API_Property& property);
 
 void					DebugAssert	(bool success, GS::UniString expression, const char* file, UInt32 line, const char* function);
@@ -83,6 +109,10 @@ bool operator== (const API_MultipleEnumerationVariant& lhs, const API_MultipleEn
 
 bool Equals (const API_PropertyValue& lhs, const API_PropertyValue& rhs, API_PropertyCollectionType collType);
 
+ULong GenerateHashValue (const API_Variant& variant);
+
+ULong GenerateHashValue (const API_PropertyValue& value, API_PropertyCollectionType collType);
+
 bool operator== (const API_PropertyGroup& lhs, const API_PropertyGroup& rhs);
 
 bool operator== (const API_ElemCategory& lhs, const API_ElemCategory& rhs);
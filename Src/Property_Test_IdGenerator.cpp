@@ -0,0 +1,186 @@
+// *****************************************************************************
+// File:			Property_Test_IdGenerator.cpp
+// Description:		Property_Test add-on fast guid and unique name generation
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestHelpers
+// Contact person:	CSAT
+// *****************************************************************************
+
+#include "Property_Test_IdGenerator.hpp"
+
+#include <cstring>
+
+
+static UInt64 SplitMix64 (UInt64& x)
+{
+	x += 0x9E3779B97F4A7C15ULL;
+	UInt64 z = x;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+
+static UInt64 RotateLeft (UInt64 x, int bits)
+{
+	return (x << bits) | (x >> (64 - bits));
+}
+
+
+// The same layout as PropertyTestSnapshot::FormatGuid, without snprintf
+static char* WriteHex (char* out, UInt32 value, int digitCount)
+{
+	static const char digits[] = "0123456789ABCDEF";
+	for (int i = digitCount - 1; i >= 0; --i) {
+		out[i] = digits[value & 0xF];
+		value >>= 4;
+	}
+	return out + digitCount;
+}
+
+
+static void FormatGuid (const API_Guid& guid, char* out)
+{
+	UInt8 bytes[16];
+	std::memcpy (bytes, &guid, sizeof (bytes));
+
+	UInt32 data1;
+	UInt16 data2;
+	UInt16 data3;
+	std::memcpy (&data1, bytes, 4);
+	std::memcpy (&data2, bytes + 4, 2);
+	std::memcpy (&data3, bytes + 6, 2);
+
+	out = WriteHex (out, data1, 8);
+	*out++ = '-';
+	out = WriteHex (out, data2, 4);
+	*out++ = '-';
+	out = WriteHex (out, data3, 4);
+	*out++ = '-';
+	out = WriteHex (out, bytes[8], 2);
+	out = WriteHex (out, bytes[9], 2);
+	*out++ = '-';
+	for (int i = 10; i < 16; ++i) {
+		out = WriteHex (out, bytes[i], 2);
+	}
+}
+
+
+// -----------------------------------------------------------------------------
+// IdGenerator
+// -----------------------------------------------------------------------------
+
+PropertyTestHelpers::IdGenerator::IdGenerator ()
+{
+	GS::Guid seedGuid;
+	seedGuid.Generate ();
+	const API_Guid apiSeedGuid = GSGuid2APIGuid (seedGuid);
+
+	UInt64 seeds[2];
+	std::memcpy (seeds, &apiSeedGuid, sizeof (seeds));
+	state[0] = SplitMix64 (seeds[0]);
+	state[1] = SplitMix64 (seeds[0]);
+	state[2] = SplitMix64 (seeds[1]);
+	state[3] = SplitMix64 (seeds[1]);
+}
+
+
+PropertyTestHelpers::IdGenerator::IdGenerator (UInt64 seed)
+{
+	Reseed (seed);
+}
+
+
+void PropertyTestHelpers::IdGenerator::Reseed (UInt64 seed)
+{
+	for (UInt64& word : state) {
+		word = SplitMix64 (seed);
+	}
+}
+
+
+UInt64 PropertyTestHelpers::IdGenerator::NextUInt64 ()
+{
+	const UInt64 result = RotateLeft (state[1] * 5, 7) * 9;
+	const UInt64 shifted = state[1] << 17;
+
+	state[2] ^= state[0];
+	state[3] ^= state[1];
+	state[1] ^= state[2];
+	state[0] ^= state[3];
+	state[2] ^= shifted;
+	state[3] = RotateLeft (state[3], 45);
+
+	return result;
+}
+
+
+API_Guid PropertyTestHelpers::IdGenerator::NextGuid ()
+{
+	UInt64 words[2];
+	words[0] = NextUInt64 ();
+	words[1] = NextUInt64 ();
+
+	UInt8 bytes[16];
+	std::memcpy (bytes, words, sizeof (bytes));
+
+	// version 4 and the variant of RFC 4122, as GS::Guid::Generate makes them
+	UInt16 data3;
+	std::memcpy (&data3, bytes + 6, 2);
+	data3 = static_cast<UInt16> ((data3 & 0x0FFF) | 0x4000);
+	std::memcpy (bytes + 6, &data3, 2);
+	bytes[8] = static_cast<UInt8> ((bytes[8] & 0x3F) | 0x80);
+
+	API_Guid guid;
+	std::memcpy (&guid, bytes, sizeof (API_Guid));
+	return guid;
+}
+
+
+void PropertyTestHelpers::IdGenerator::NextGuids (UInt32 count, GS::Array<API_Guid>& guids)
+{
+	guids.SetCapacity (guids.GetSize () + count);
+	for (UInt32 i = 0; i < count; ++i) {
+		guids.Push (NextGuid ());
+	}
+}
+
+
+const GS::UniString& PropertyTestHelpers::IdGenerator::NextName (const char* prefix /* = ""*/)
+{
+	size_t prefixLength = std::strlen (prefix);
+	if (prefixLength > NameBufferSize - GuidTextLength - 1) {
+		prefixLength = NameBufferSize - GuidTextLength - 1;
+	}
+
+	std::memcpy (nameBuffer, prefix, prefixLength);
+	FormatGuid (NextGuid (), nameBuffer + prefixLength);
+	nameBuffer[prefixLength + GuidTextLength] = '\0';
+
+	name = GS::UniString (nameBuffer, CC_UTF8);
+	return name;
+}
+
+
+PropertyTestHelpers::IdGenerator& PropertyTestHelpers::IdGenerator::Get ()
+{
+	static IdGenerator generator;
+	return generator;
+}
+
+
+// -----------------------------------------------------------------------------
+// Benchmark fixtures
+// -----------------------------------------------------------------------------
+
+API_PropertyDefinition PropertyTestHelpers::CreateStandInDefinition (IdGenerator& ids, const char* name, API_PropertyCollectionType collectionType, API_VariantType valueType)
+{
+	API_PropertyDefinition definition;
+	definition.guid = ids.NextGuid ();
+	definition.groupGuid = APINULLGuid;
+	definition.name = name;
+	definition.collectionType = collectionType;
+	definition.valueType = valueType;
+	definition.defaultValue.singleVariant.variant.type = valueType;
+	return definition;
+}
@@ -0,0 +1,68 @@
+// *****************************************************************************
+// File:			Property_Test_IdGenerator.hpp
+// Description:		Property_Test add-on fast guid and unique name generation
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestHelpers
+// Contact person:	CSAT
+// *****************************************************************************
+
+#if !defined (IDGENERATOR_HPP)
+#define	IDGENERATOR_HPP
+
+#include "Property_Test.hpp"
+
+namespace PropertyTestHelpers
+{
+
+// -----------------------------------------------------------------------------
+// Generates random (version 4) guids and unique names from a xoshiro256**
+// generator, without a system call per guid:
+//	- by default it is seeded once from GS::Guid::Generate, which takes its
+//	  bits from the random source of the system, so every run differs
+//	- with a seed it gives the same guids and names in every run, for
+//	  reproducible benchmark models
+// The names are the prefix and the text of a new guid, formatted into a
+// buffer kept by the generator; the returned string is valid until the next
+// NextName call.
+// Not thread safe: use one generator per thread.
+// -----------------------------------------------------------------------------
+
+class IdGenerator
+{
+public:
+	IdGenerator ();
+	explicit IdGenerator (UInt64 seed);
+
+	void					Reseed (UInt64 seed);
+
+	API_Guid				NextGuid ();
+	void					NextGuids (UInt32 count, GS::Array<API_Guid>& guids);		// appended to guids
+	const GS::UniString&	NextName (const char* prefix = "");
+
+	static IdGenerator&		Get ();		// the generator behind RandomGuid and GenearteUniqueName
+
+private:
+	static const UInt32		NameBufferSize = 256;
+	static const UInt32		GuidTextLength = 36;
+
+	UInt64					NextUInt64 ();
+
+	UInt64					state[4];
+	char					nameBuffer[NameBufferSize];
+	GS::UniString			name;
+};
+
+
+// -----------------------------------------------------------------------------
+// Fixtures of the benchmarks: their stand-in models are generated from
+// BenchmarkSeed, so they get the same guids and values in every run
+// -----------------------------------------------------------------------------
+
+const UInt64			BenchmarkSeed = 42;
+
+// A definition that is not in the project: a new guid, no group, a default value of its type
+API_PropertyDefinition	CreateStandInDefinition (IdGenerator& ids, const char* name, API_PropertyCollectionType collectionType, API_VariantType valueType);
+
+}
+
+#endif
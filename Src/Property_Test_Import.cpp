@@ -0,0 +1,730 @@
+// *****************************************************************************
+// File:			Property_Test_Import.cpp
+// Description:		Property_Test add-on bulk import of property values from CSV
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestImport
+// Contact person:	CSAT
+// *****************************************************************************
+
+#include "Property_Test_Import.hpp"
+#include "Property_Test_Helpers.hpp"
+#include "Property_Test_IdGenerator.hpp"
+#include "Property_Test_SnapshotDiff.hpp"
+
+#include "File.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+// The CSV file is read in blocks of this size
+static const UInt32 ReadBlockSize = 1024 * 1024;
+
+
+// FNV-1a, over the raw bytes: no string object is needed for the lookups
+static UInt64 GenerateTextHashValue (const char* text, UInt32 length, UInt64 seed)
+{
+	UInt64 hash = 14695981039346656037ULL ^ seed;
+	for (UInt32 i = 0; i < length; ++i) {
+		hash = (hash ^ static_cast<UInt8> (text[i])) * 1099511628211ULL;
+	}
+	return hash;
+}
+
+
+// -----------------------------------------------------------------------------
+// ImportStatistics
+// -----------------------------------------------------------------------------
+
+PropertyTestImport::ImportStatistics::ImportStatistics () :
+	byteCount (0),
+	rowCount (0),
+	importedRowCount (0),
+	badGuidCount (0),
+	unknownDefinitionCount (0),
+	badValueCount (0),
+	groupCount (0),
+	unchangedValueCount (0),
+	unavailableValueCount (0),
+	writeCallCount (0),
+	failedWriteCount (0),
+	parseSeconds (0.0),
+	checkSeconds (0.0),
+	writeSeconds (0.0)
+{
+}
+
+
+void PropertyTestImport::ImportStatistics::Report (const char* commandName) const
+{
+	WriteReport ("%s: %u row(s) in %.1f MB, %u imported, %u bad guid(s), %u unknown definition(s), %u bad value(s)",
+				 commandName, rowCount, byteCount / (1024.0 * 1024.0), importedRowCount, badGuidCount, unknownDefinitionCount, badValueCount);
+	WriteReport ("  parse   %8.3f s, %.0f row(s)/s, %u distinct value(s)",
+				 parseSeconds, (parseSeconds > 0.0) ? rowCount / parseSeconds : 0.0, groupCount);
+	WriteReport ("  check   %8.3f s, %u value(s) already up to date, %u not available for their element",
+				 checkSeconds, unchangedValueCount, unavailableValueCount);
+	WriteReport ("  write   %8.3f s in %u call(s), %u value(s) could not be written", writeSeconds, writeCallCount, failedWriteCount);
+}
+
+
+// -----------------------------------------------------------------------------
+// CsvReader
+// -----------------------------------------------------------------------------
+
+PropertyTestImport::CsvReader::CsvReader () :
+	lineNumber (1)
+{
+}
+
+
+void PropertyTestImport::CsvReader::Feed (const char* data, size_t size, const RowCallback& callback)
+{
+	buffer.insert (buffer.end (), data, data + size);
+	const size_t parsed = ParseRows (callback);
+	buffer.erase (buffer.begin (), buffer.begin () + parsed);
+}
+
+
+void PropertyTestImport::CsvReader::Finish (const RowCallback& callback)
+{
+	if (!buffer.empty ()) {
+		buffer.push_back ('\n');
+		ParseRows (callback);
+		buffer.clear ();
+	}
+}
+
+
+// Returns the size of the complete rows at the beginning of the buffer
+size_t PropertyTestImport::CsvReader::ParseRows (const RowCallback& callback)
+{
+	CsvRow row;
+	size_t rowStart = 0;
+	UInt32 quotedLineEnds = 0;
+	bool inQuotes = false;
+	for (size_t i = 0; i < buffer.size (); ++i) {
+		const char c = buffer[i];
+		if (c == '"') {
+			inQuotes = !inQuotes;
+		} else if (c == '\n') {
+			if (inQuotes) {
+				++quotedLineEnds;
+				continue;
+			}
+
+			size_t rowEnd = i;
+			if (rowEnd > rowStart && buffer[rowEnd - 1] == '\r') {
+				--rowEnd;
+			}
+
+			row.lineNumber = lineNumber;
+			if (ParseRow (buffer.data () + rowStart, buffer.data () + rowEnd, row)) {
+				callback (row);
+			}
+
+			lineNumber += 1 + quotedLineEnds;
+			quotedLineEnds = 0;
+			rowStart = i + 1;
+		}
+	}
+
+	return rowStart;
+}
+
+
+// The fields are unquoted in place; the terminating zeros go to the
+// separators, which are never before the end of the unquoted text
+bool PropertyTestImport::CsvReader::ParseRow (char* begin, char* end, CsvRow& row)
+{
+	row.fieldCount = 0;
+	if (begin == end) {
+		return false;
+	}
+
+	char* read = begin;
+	while (row.fieldCount < CsvRow::MaxFieldCount) {
+		char* field = read;
+		char* write = read;
+		if (read < end && *read == '"') {
+			++read;
+			while (read < end) {
+				if (*read == '"') {
+					if (read + 1 < end && read[1] == '"') {
+						*write++ = '"';
+						read += 2;
+						continue;
+					}
+					++read;
+					break;
+				}
+				*write++ = *read++;
+			}
+			while (read < end && *read != ',') {
+				++read;
+			}
+		} else {
+			while (read < end && *read != ',') {
+				++read;
+			}
+			write = read;
+		}
+
+		row.fields[row.fieldCount] = field;
+		row.lengths[row.fieldCount] = static_cast<UInt32> (write - field);
+		++row.fieldCount;
+
+		*write = '\0';
+		if (read >= end) {
+			break;
+		}
+		++read;
+	}
+
+	return true;
+}
+
+
+// -----------------------------------------------------------------------------
+// ValueParser
+// -----------------------------------------------------------------------------
+
+PropertyTestImport::ValueParser::ValueParser (const GS::Array<API_PropertyDefinition>& definitionsToParse) :
+	definitions (definitionsToParse)
+{
+	definitionNames.reserve (definitions.GetSize ());
+	enumIndices.resize (definitions.GetSize ());
+	for (UInt32 i = 0; i < definitions.GetSize (); ++i) {
+		definitionNames.push_back (definitions[i].name.ToCStr (CC_UTF8).Get ());
+		const std::string& name = definitionNames.back ();
+		definitionIndices.emplace (GenerateTextHashValue (name.data (), static_cast<UInt32> (name.size ()), 0), i);
+
+		if (!definitions[i].possibleEnumValues.IsEmpty ()) {
+			enumIndices[i] = PropertyTestHelpers::EnumIndex (definitions[i]);
+		}
+	}
+}
+
+
+// Names used by more than one definition are ambiguous, they are not imported
+bool PropertyTestImport::ValueParser::FindDefinition (const char* name, UInt32 length, UInt32& definitionIndex) const
+{
+	UInt32 matchCount = 0;
+	auto range = definitionIndices.equal_range (GenerateTextHashValue (name, length, 0));
+	for (auto it = range.first; it != range.second; ++it) {
+		const std::string& candidate = definitionNames[it->second];
+		if (candidate.size () == length && std::memcmp (candidate.data (), name, length) == 0) {
+			definitionIndex = it->second;
+			++matchCount;
+		}
+	}
+	return matchCount == 1;
+}
+
+
+bool PropertyTestImport::ValueParser::ParseValue (UInt32 definitionIndex, const std::string& text, API_PropertyValue& value) const
+{
+	// the list items are terminated in place, in a copy
+	std::vector<char> items (text.begin (), text.end ());
+	items.push_back ('\0');
+
+	std::vector<char*> itemTexts;
+	if (!text.empty ()) {
+		char* item = items.data ();
+		for (;;) {
+			itemTexts.push_back (item);
+			char* separator = std::strchr (item, ';');
+			if (separator == nullptr) {
+				break;
+			}
+			*separator = '\0';
+			item = separator + 1;
+		}
+	}
+
+	switch (definitions[definitionIndex].collectionType) {
+		case API_PropertySingleCollectionType:
+			return ParseVariant (definitionIndex, items.data (), value.singleVariant.variant);
+		case API_PropertyListCollectionType:
+			value.listVariant.variants.Clear ();
+			for (char* itemText : itemTexts) {
+				API_Variant variant;
+				if (!ParseVariant (definitionIndex, itemText, variant)) {
+					return false;
+				}
+				value.listVariant.variants.Push (variant);
+			}
+			return true;
+		case API_PropertySingleChoiceEnumerationCollectionType: {
+			UInt32 ordinal = 0;
+			if (!FindEnumOrdinal (definitionIndex, items.data (), ordinal)) {
+				return false;
+			}
+			value.singleEnumVariant = enumIndices[definitionIndex].Get (ordinal);
+			return true;
+		}
+		case API_PropertyMultipleChoiceEnumerationCollectionType: {
+			// through the set of ordinals: the same choices in any order, or repeated, give the same value
+			PropertyTestHelpers::EnumSet enumSet;
+			for (char* itemText : itemTexts) {
+				UInt32 ordinal = 0;
+				if (!FindEnumOrdinal (definitionIndex, itemText, ordinal)) {
+					return false;
+				}
+				enumSet.Add (ordinal);
+			}
+			enumIndices[definitionIndex].ToValue (enumSet, value.multipleEnumVariant);
+			return true;
+		}
+		default:
+			return false;
+	}
+}
+
+
+bool PropertyTestImport::ValueParser::ParseVariant (UInt32 definitionIndex, char* text, API_Variant& variant) const
+{
+	variant.type = definitions[definitionIndex].valueType;
+
+	char* end = nullptr;
+	switch (variant.type) {
+		case API_PropertyIntegerValueType: {
+			const long number = std::strtol (text, &end, 10);
+			if (end == text || *end != '\0' || number < INT_MIN || number > INT_MAX) {
+				return false;
+			}
+			variant.intValue = static_cast<Int32> (number);
+			return true;
+		}
+		case API_PropertyRealValueType: {
+			const double number = std::strtod (text, &end);
+			if (end == text || *end != '\0') {
+				return false;
+			}
+			variant.doubleValue = number;
+			return true;
+		}
+		case API_PropertyStringValueType:
+			variant.uniStringValue = GS::UniString (text, CC_UTF8);
+			return true;
+		case API_PropertyBooleanValueType:
+			if (std::strcmp (text, "true") == 0 || std::strcmp (text, "1") == 0 || std::strcmp (text, "yes") == 0) {
+				variant.boolValue = true;
+				return true;
+			}
+			if (std::strcmp (text, "false") == 0 || std::strcmp (text, "0") == 0 || std::strcmp (text, "no") == 0) {
+				variant.boolValue = false;
+				return true;
+			}
+			return false;
+		default:
+			return false;
+	}
+}
+
+
+bool PropertyTestImport::ValueParser::IsUnchanged (UInt32 definitionIndex, const API_Property& current, const API_PropertyValue& newValue) const
+{
+	// a value inherited from the definition is written, even if it is equal, to make it custom
+	if (current.isDefault) {
+		return false;
+	}
+
+	const API_PropertyCollectionType collectionType = definitions[definitionIndex].collectionType;
+	if (collectionType != API_PropertyMultipleChoiceEnumerationCollectionType) {
+		return Equals (current.value, newValue, collectionType);
+	}
+
+	const PropertyTestHelpers::EnumIndex& enumIndex = enumIndices[definitionIndex];
+	PropertyTestHelpers::EnumSet currentSet;
+	PropertyTestHelpers::EnumSet newSet;
+	if (!enumIndex.ToSet (current.value.multipleEnumVariant, currentSet)) {
+		return false;		// it has a choice that is not possible any more
+	}
+	enumIndex.ToSet (newValue.multipleEnumVariant, newSet);
+	return currentSet == newSet;
+}
+
+
+const PropertyTestHelpers::EnumIndex& PropertyTestImport::ValueParser::GetEnumIndex (UInt32 definitionIndex) const
+{
+	return enumIndices[definitionIndex];
+}
+
+
+bool PropertyTestImport::ValueParser::FindEnumOrdinal (UInt32 definitionIndex, const char* text, UInt32& ordinal) const
+{
+	return enumIndices[definitionIndex].FindByText (text, std::strlen (text), ordinal);
+}
+
+
+// -----------------------------------------------------------------------------
+// ImportPlanner
+// -----------------------------------------------------------------------------
+
+static int HexDigitValue (char c)
+{
+	if (c >= '0' && c <= '9') {
+		return c - '0';
+	}
+	if (c >= 'a' && c <= 'f') {
+		return c - 'a' + 10;
+	}
+	if (c >= 'A' && c <= 'F') {
+		return c - 'A' + 10;
+	}
+	return -1;
+}
+
+
+static bool ParseHex (const char* text, UInt32 digitCount, UInt32& value)
+{
+	value = 0;
+	for (UInt32 i = 0; i < digitCount; ++i) {
+		const int digit = HexDigitValue (text[i]);
+		if (digit < 0) {
+			return false;
+		}
+		value = (value << 4) | static_cast<UInt32> (digit);
+	}
+	return true;
+}
+
+
+// XXXXXXXX-XXXX-XXXX-XXXX-XXXXXXXXXXXX, optionally in braces; the same byte
+// layout as PropertyTestSnapshot::FormatGuid
+static bool ParseGuid (const char* text, UInt32 length, API_Guid& guid)
+{
+	if (length == 38 && text[0] == '{' && text[37] == '}') {
+		++text;
+		length -= 2;
+	}
+	if (length != 36 || text[8] != '-' || text[13] != '-' || text[18] != '-' || text[23] != '-') {
+		return false;
+	}
+
+	UInt32 data1;
+	UInt32 data2;
+	UInt32 data3;
+	if (!ParseHex (text, 8, data1) || !ParseHex (text + 9, 4, data2) || !ParseHex (text + 14, 4, data3)) {
+		return false;
+	}
+
+	UInt8 bytes[16];
+	const UInt16 shortData2 = static_cast<UInt16> (data2);
+	const UInt16 shortData3 = static_cast<UInt16> (data3);
+	std::memcpy (bytes, &data1, 4);
+	std::memcpy (bytes + 4, &shortData2, 2);
+	std::memcpy (bytes + 6, &shortData3, 2);
+
+	static const UInt32 byteOffsets[8] = { 19, 21, 24, 26, 28, 30, 32, 34 };
+	for (UInt32 i = 0; i < 8; ++i) {
+		UInt32 byte;
+		if (!ParseHex (text + byteOffsets[i], 2, byte)) {
+			return false;
+		}
+		bytes[8 + i] = static_cast<UInt8> (byte);
+	}
+
+	std::memcpy (&guid, bytes, sizeof (API_Guid));
+	return true;
+}
+
+
+PropertyTestImport::ImportPlanner::ImportPlanner (const GS::Array<API_PropertyDefinition>& definitionsToImport) :
+	parser (definitionsToImport)
+{
+}
+
+
+PropertyTestImport::ImportPlanner::Group* PropertyTestImport::ImportPlanner::GetGroup (UInt32 definitionIndex, const char* text, UInt32 length)
+{
+	const UInt64 hash = GenerateTextHashValue (text, length, definitionIndex + 1);
+	auto range = groupIndices.equal_range (hash);
+	for (auto it = range.first; it != range.second; ++it) {
+		Group& group = groups[it->second];
+		if (group.definitionIndex == definitionIndex && group.text.size () == length && std::memcmp (group.text.data (), text, length) == 0) {
+			return &group;
+		}
+	}
+
+	groupIndices.emplace (hash, static_cast<UInt32> (groups.size ()));
+	groups.emplace_back ();
+	Group& group = groups.back ();
+	group.definitionIndex = definitionIndex;
+	group.text.assign (text, length);
+	group.isValid = parser.ParseValue (definitionIndex, group.text, group.value);
+	++statistics.groupCount;
+	return &group;
+}
+
+
+void PropertyTestImport::ImportPlanner::AddRow (const CsvRow& row)
+{
+	API_Guid elemGuid;
+	if (!ParseGuid (row.fields[0], row.lengths[0], elemGuid)) {
+		if (row.lineNumber == 1) {
+			return;		// header
+		}
+		++statistics.rowCount;
+		++statistics.badGuidCount;
+		return;
+	}
+
+	++statistics.rowCount;
+	UInt32 definitionIndex = 0;
+	if (row.fieldCount < 3 || !parser.FindDefinition (row.fields[1], row.lengths[1], definitionIndex)) {
+		++statistics.unknownDefinitionCount;
+		return;
+	}
+
+	Group* group = GetGroup (definitionIndex, row.fields[2], row.lengths[2]);
+	if (!group->isValid) {
+		++statistics.badValueCount;
+		return;
+	}
+
+	group->elemGuids.Push (elemGuid);
+	++statistics.importedRowCount;
+}
+
+
+void PropertyTestImport::ImportPlanner::Plan (PropertyTestBatch::WritePlanner& planner) const
+{
+	for (const Group& group : groups) {
+		if (group.isValid) {
+			planner.Add (group.definitionIndex, group.elemGuids, group.value);
+		}
+	}
+}
+
+
+GSErrCode PropertyTestImport::ImportPlanner::PlanChanges (const PropertyTestHelpers::DefinitionTable& definitionTable, PropertyTestBatch::WritePlanner& planner)
+{
+	API_ElemCategory classificationCategory;
+	GSErrCode error = PropertyTestHelpers::GetElemClassificationCategory (classificationCategory);
+	if (error != NoError) {
+		return error;
+	}
+
+	// the imported values of each element: (group, definition) pairs, the elements in the order of their first value
+	struct ElementValues {
+		API_Guid								elemGuid;
+		std::vector<std::pair<UInt32, UInt32>>	values;
+	};
+	std::vector<ElementValues> elementValues;
+	std::unordered_map<API_Guid, UInt32, PropertyTestHelpers::GuidHash> elementIndices;
+	for (UInt32 groupIndex = 0; groupIndex < groups.size (); ++groupIndex) {
+		const Group& group = groups[groupIndex];
+		if (!group.isValid) {
+			continue;
+		}
+		for (UInt32 i = 0; i < group.elemGuids.GetSize (); ++i) {
+			auto inserted = elementIndices.emplace (group.elemGuids[i], static_cast<UInt32> (elementValues.size ()));
+			if (inserted.second) {
+				elementValues.emplace_back ();
+				elementValues.back ().elemGuid = group.elemGuids[i];
+			}
+			elementValues[inserted.first->second].values.emplace_back (groupIndex, group.definitionIndex);
+		}
+	}
+
+	// one read per element: the available properties with their current values
+	GS::Array<API_Property>	properties;
+	GS::Array<UInt32>		definitionIndices;
+	for (const ElementValues& element : elementValues) {
+		if (PropertyTestHelpers::GetAvailableProperties (element.elemGuid, classificationCategory, definitionTable, properties, definitionIndices) != NoError) {
+			properties.Clear ();
+			definitionIndices.Clear ();
+		}
+
+		for (const std::pair<UInt32, UInt32>& value : element.values) {
+			const Group& group = groups[value.first];
+			const UInt32 definitionIndex = value.second;
+
+			UInt32 propertyIndex = 0;
+			while (propertyIndex < definitionIndices.GetSize () && definitionIndices[propertyIndex] != definitionIndex) {
+				++propertyIndex;
+			}
+
+			if (propertyIndex == definitionIndices.GetSize ()) {
+				++statistics.unavailableValueCount;
+			} else if (parser.IsUnchanged (definitionIndex, properties[propertyIndex], group.value)) {
+				++statistics.unchangedValueCount;
+			} else {
+				planner.Add (definitionIndex, element.elemGuid, group.value);
+			}
+		}
+	}
+
+	return NoError;
+}
+
+
+const PropertyTestImport::ImportStatistics& PropertyTestImport::ImportPlanner::GetStatistics () const
+{
+	return statistics;
+}
+
+
+PropertyTestImport::ImportStatistics& PropertyTestImport::ImportPlanner::GetStatistics ()
+{
+	return statistics;
+}
+
+
+// -----------------------------------------------------------------------------
+// Import
+// -----------------------------------------------------------------------------
+
+GSErrCode PropertyTestImport::ImportFile (const IO::Location& location, const GS::Array<API_PropertyDefinition>& definitions,
+										  PropertyTestHelpers::Progress* progress, ImportStatistics& statistics)
+{
+	PropertyTestBatch::Stopwatch stopwatch;
+
+	IO::File input (location);
+	GSErrCode error = input.GetStatus ();
+	if (error != NoError) {
+		return error;
+	}
+
+	error = input.Open (IO::File::ReadMode);
+	if (error != NoError) {
+		return error;
+	}
+
+	UInt64 length = 0;
+	error = input.GetDataLength (&length);
+	if (error != NoError) {
+		input.Close ();
+		return error;
+	}
+
+	if (progress != nullptr) {
+		progress->SetItemCount (static_cast<UInt32> ((length + ReadBlockSize - 1) / ReadBlockSize));
+	}
+
+	ImportPlanner importPlanner (definitions);
+	CsvReader reader;
+	const CsvReader::RowCallback onRow = [&importPlanner] (const CsvRow& row) {
+		importPlanner.AddRow (row);
+	};
+
+	// nothing is written before the whole file is read, so a cancel leaves the model unchanged
+	std::vector<char> block (ReadBlockSize);
+	for (UInt64 remaining = length; remaining > 0 && error == NoError; ) {
+		if (progress != nullptr && progress->IsCanceled ()) {
+			input.Close ();
+			return APIERR_CANCEL;
+		}
+
+		const UInt32 blockSize = static_cast<UInt32> (std::min<UInt64> (remaining, ReadBlockSize));
+		error = input.ReadBin (block.data (), blockSize);
+		if (error == NoError) {
+			reader.Feed (block.data (), blockSize, onRow);
+			remaining -= blockSize;
+		}
+
+		if (progress != nullptr) {
+			progress->Advance ();
+		}
+	}
+	input.Close ();
+	if (error != NoError) {
+		return error;
+	}
+	reader.Finish (onRow);
+
+	ImportStatistics& result = importPlanner.GetStatistics ();
+	result.byteCount = length;
+	result.parseSeconds = stopwatch.GetSeconds ();
+
+	stopwatch.Restart ();
+	const PropertyTestHelpers::DefinitionTable definitionTable (definitions);
+	PropertyTestBatch::WritePlanner writePlanner (definitionTable);
+	error = importPlanner.PlanChanges (definitionTable, writePlanner);
+	if (error != NoError) {
+		return error;
+	}
+	result.checkSeconds = stopwatch.GetSeconds ();
+
+	stopwatch.Restart ();
+	result.writeCallCount = writePlanner.Execute ();
+	result.failedWriteCount = writePlanner.GetFailedElements ().GetSize ();
+	result.importedRowCount -= result.unavailableValueCount + result.failedWriteCount;
+	result.writeSeconds = stopwatch.GetSeconds ();
+
+	statistics = result;
+	return NoError;
+}
+
+
+// -----------------------------------------------------------------------------
+// Benchmark
+// -----------------------------------------------------------------------------
+
+void PropertyTestImport::RunBenchmark (UInt32 rowCount, ImportStatistics& statistics)
+{
+	static const char* enumTexts[] = { "One", "Two", "Three", "Four", "Five" };
+
+	PropertyTestHelpers::IdGenerator ids (PropertyTestHelpers::BenchmarkSeed);
+
+	GS::Array<API_PropertyDefinition> definitions;
+	definitions.Push (PropertyTestHelpers::CreateStandInDefinition (ids, "Stand-in Integer", API_PropertySingleCollectionType, API_PropertyIntegerValueType));
+	definitions.Push (PropertyTestHelpers::CreateStandInDefinition (ids, "Stand-in String", API_PropertySingleCollectionType, API_PropertyStringValueType));
+	definitions.Push (PropertyTestHelpers::CreateStandInDefinition (ids, "Stand-in Enumeration", API_PropertySingleChoiceEnumerationCollectionType, API_PropertyStringValueType));
+	for (const char* enumText : enumTexts) {
+		API_SingleEnumerationVariant enumValue;
+		enumValue.guid = ids.NextGuid ();
+		enumValue.variant.type = API_PropertyStringValueType;
+		enumValue.variant.uniStringValue = enumText;
+		definitions[2].possibleEnumValues.Push (enumValue);
+	}
+
+	// every element gets a value of every definition
+	std::vector<std::string> elemGuids (rowCount / definitions.GetSize () + 1);
+	for (std::string& elemGuid : elemGuids) {
+		elemGuid = PropertyTestSnapshot::FormatGuid (ids.NextGuid ());
+	}
+
+	std::string csv = "element,property,value\n";
+	csv.reserve (static_cast<size_t> (rowCount) * 64);
+	char line[256];
+	for (UInt32 i = 0; i < rowCount; ++i) {
+		const std::string& elemGuid = elemGuids[i / definitions.GetSize ()];
+		switch (i % definitions.GetSize ()) {
+			case 0:		std::snprintf (line, sizeof (line), "%s,Stand-in Integer,%u\n", elemGuid.c_str (), i % 100);					break;
+			case 1:		std::snprintf (line, sizeof (line), "%s,Stand-in String,\"Value, %u\"\n", elemGuid.c_str (), i % 1000);		break;
+			default:	std::snprintf (line, sizeof (line), "%s,Stand-in Enumeration,%s\n", elemGuid.c_str (), enumTexts[i % 5]);	break;
+		}
+		csv += line;
+	}
+
+	// the same path as ImportFile, with the file in memory and no API calls
+	PropertyTestBatch::Stopwatch stopwatch;
+	ImportPlanner importPlanner (definitions);
+	CsvReader reader;
+	const CsvReader::RowCallback onRow = [&importPlanner] (const CsvRow& row) {
+		importPlanner.AddRow (row);
+	};
+	for (size_t offset = 0; offset < csv.size (); offset += ReadBlockSize) {
+		reader.Feed (csv.data () + offset, std::min<size_t> (ReadBlockSize, csv.size () - offset), onRow);
+	}
+	reader.Finish (onRow);
+
+	ImportStatistics& result = importPlanner.GetStatistics ();
+	result.byteCount = csv.size ();
+	result.parseSeconds = stopwatch.GetSeconds ();
+
+	// the stand-in of the write: the calls are planned, not made
+	stopwatch.Restart ();
+	const PropertyTestHelpers::DefinitionTable definitionTable (definitions);
+	PropertyTestBatch::WritePlanner writePlanner (definitionTable);
+	importPlanner.Plan (writePlanner);
+	result.writeCallCount = writePlanner.GetBucketCount ();
+	result.writeSeconds = stopwatch.GetSeconds ();
+
+	statistics = result;
+}
@@ -0,0 +1,189 @@
+// *****************************************************************************
+// File:			Property_Test_Import.hpp
+// Description:		Property_Test add-on bulk import of property values from CSV
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestImport
+// Contact person:	CSAT
+// *****************************************************************************
+
+#if !defined (IMPORT_HPP)
+#define	IMPORT_HPP
+
+#include "Property_Test.hpp"
+#include "Property_Test_Batch.hpp"
+#include "Property_Test_EnumIndex.hpp"
+#include "Property_Test_Progress.hpp"
+
+#include "Location.hpp"
+
+#include <deque>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace PropertyTestImport
+{
+
+// -----------------------------------------------------------------------------
+// Statistics of one import
+// -----------------------------------------------------------------------------
+
+struct ImportStatistics {
+	UInt64		byteCount;
+	UInt32		rowCount;
+	UInt32		importedRowCount;
+	UInt32		badGuidCount;
+	UInt32		unknownDefinitionCount;
+	UInt32		badValueCount;
+	UInt32		groupCount;				// distinct (definition, value text) pairs
+	UInt32		unchangedValueCount;	// equal to the current value of the element: not written
+	UInt32		unavailableValueCount;	// the property is not available for the element: not written
+	UInt32		writeCallCount;
+	UInt32		failedWriteCount;		// rejected by the API
+	double		parseSeconds;			// reading, parsing and grouping
+	double		checkSeconds;			// reading the current values
+	double		writeSeconds;
+
+	ImportStatistics ();
+
+	void		Report (const char* commandName) const;
+};
+
+
+// -----------------------------------------------------------------------------
+// One row of the CSV; the fields are zero terminated and point into the
+// buffer of the reader, they are valid during the row callback only
+// -----------------------------------------------------------------------------
+
+struct CsvRow {
+	static const UInt32 MaxFieldCount = 8;
+
+	UInt32		lineNumber;
+	UInt32		fieldCount;
+	char*		fields[MaxFieldCount];
+	UInt32		lengths[MaxFieldCount];
+};
+
+
+// -----------------------------------------------------------------------------
+// Splits a comma separated text into rows as it arrives, in blocks of any
+// size. Quoted fields ("a, ""b""") may contain separators and new lines.
+// The fields are unquoted and terminated in place, the buffer is reused, so
+// a row costs no allocation.
+// -----------------------------------------------------------------------------
+
+class CsvReader
+{
+public:
+	typedef std::function<void (const CsvRow&)>	RowCallback;
+
+	CsvReader ();
+
+	void		Feed (const char* data, size_t size, const RowCallback& callback);
+	void		Finish (const RowCallback& callback);		// the last line may have no line end
+
+private:
+	size_t		ParseRows (const RowCallback& callback);
+	bool		ParseRow (char* begin, char* end, CsvRow& row);
+
+	std::vector<char>	buffer;			// the unparsed tail of the previous block + the new block
+	UInt32				lineNumber;
+};
+
+
+// -----------------------------------------------------------------------------
+// Finds the definitions by name, by a hash of the name bytes, and parses the
+// value texts by the type of the definition: numbers in C format, booleans
+// as true/false, 1/0 or yes/no, enumerations by their display text, list
+// items separated by ';'.
+// -----------------------------------------------------------------------------
+
+class ValueParser
+{
+public:
+	explicit ValueParser (const GS::Array<API_PropertyDefinition>& definitionsToParse);
+
+	bool		FindDefinition (const char* name, UInt32 length, UInt32& definitionIndex) const;	// false for an unknown or ambiguous name
+	bool		ParseValue (UInt32 definitionIndex, const std::string& text, API_PropertyValue& value) const;
+
+	// true if writing newValue would not change the current property: a default value is never unchanged,
+	// the choices of a multiple choice enumeration are compared as sets
+	bool		IsUnchanged (UInt32 definitionIndex, const API_Property& current, const API_PropertyValue& newValue) const;
+
+	const PropertyTestHelpers::EnumIndex&	GetEnumIndex (UInt32 definitionIndex) const;	// empty for the non-enumeration definitions
+
+private:
+	bool		ParseVariant (UInt32 definitionIndex, char* text, API_Variant& variant) const;
+	bool		FindEnumOrdinal (UInt32 definitionIndex, const char* text, UInt32& ordinal) const;
+
+	const GS::Array<API_PropertyDefinition>&		definitions;
+	std::vector<std::string>						definitionNames;	// UTF-8
+	std::unordered_multimap<UInt64, UInt32>			definitionIndices;	// hash of the name -> definition
+	std::vector<PropertyTestHelpers::EnumIndex>		enumIndices;		// per definition
+};
+
+
+// -----------------------------------------------------------------------------
+// Turns the rows (element guid, definition name, value) into groups of
+// elements getting the same value of the same definition:
+//	- the definitions are resolved by name once
+//	- the value text of a definition is parsed only the first time it occurs,
+//	  later rows with the same text just add their element to its group
+// PlanChanges reads the current values of every imported element with one
+// call and plans only the values that change, so importing the same file
+// again writes nothing; the values of the properties not available for their
+// element are dropped before they could fail a write.
+// -----------------------------------------------------------------------------
+
+class ImportPlanner
+{
+public:
+	explicit ImportPlanner (const GS::Array<API_PropertyDefinition>& definitionsToImport);
+
+	void		AddRow (const CsvRow& row);
+
+	void		Plan (PropertyTestBatch::WritePlanner& planner) const;		// every value, without reading the model
+	GSErrCode	PlanChanges (const PropertyTestHelpers::DefinitionTable& definitionTable, PropertyTestBatch::WritePlanner& planner);
+
+	const ImportStatistics&		GetStatistics () const;
+	ImportStatistics&			GetStatistics ();
+
+private:
+	struct Group {
+		UInt32					definitionIndex;
+		std::string				text;
+		bool					isValid;
+		API_PropertyValue		value;
+		GS::Array<API_Guid>		elemGuids;
+	};
+
+	Group*		GetGroup (UInt32 definitionIndex, const char* text, UInt32 length);
+
+	ValueParser										parser;
+	std::deque<Group>								groups;				// stable: the element arrays are never moved
+	std::unordered_multimap<UInt64, UInt32>			groupIndices;		// hash of (definition, text) -> group
+	ImportStatistics								statistics;
+};
+
+
+// -----------------------------------------------------------------------------
+// Reads the CSV file in blocks and writes the changed values with
+// ACAPI_ElementList_ModifyPropertyValue, one call per distinct value.
+// The first line is skipped if it is a header (its first field is not a guid).
+// -----------------------------------------------------------------------------
+
+GSErrCode	ImportFile (const IO::Location& location, const GS::Array<API_PropertyDefinition>& definitions,
+						PropertyTestHelpers::Progress* progress, ImportStatistics& statistics);
+
+
+// -----------------------------------------------------------------------------
+// Measures the parsing and grouping speed on a generated CSV of rowCount rows
+// and stand-in definitions; nothing is read from or written to the model.
+// -----------------------------------------------------------------------------
+
+void		RunBenchmark (UInt32 rowCount, ImportStatistics& statistics);
+
+}
+
+#endif
@@ -0,0 +1,100 @@
+// *****************************************************************************
+// File:			Property_Test_Progress.cpp
+// Description:		Property_Test add-on progress window and cancellation
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestHelpers
+// Contact person:	CSAT
+// *****************************************************************************
+
+#include "Property_Test_Progress.hpp"
+
+// The process window is updated at most this often; the calls are not free
+// and the user cannot read faster anyway
+static const std::chrono::milliseconds UpdateInterval (100);
+
+
+PropertyTestHelpers::Progress::Progress (const GS::UniString& commandName, const GS::UniString& phaseName, UInt32 itemsToProcess) :
+	title (commandName),
+	phase (phaseName),
+	phaseStarted (false),
+	itemCount (itemsToProcess),
+	itemsDone (0),
+	canceled (false),
+	start (std::chrono::steady_clock::now ()),
+	lastUpdate (start)
+{
+	Int32 nPhase = 1;
+	ACAPI_Interface (APIIo_InitProcessWindowID, &title, &nPhase);
+}
+
+
+PropertyTestHelpers::Progress::~Progress ()
+{
+	ACAPI_Interface (APIIo_CloseProcessWindowID, nullptr, nullptr);
+
+	const double seconds = GetSeconds ();
+	WriteReport ("%s: %u of %u item(s) in %.1f s (%.0f/s)%s", title.ToCStr ().Get (), itemsDone, itemCount, seconds,
+				 (seconds > 0.0) ? itemsDone / seconds : 0.0, canceled ? ", canceled by the user" : "");
+}
+
+
+void PropertyTestHelpers::Progress::SetItemCount (UInt32 newItemCount)
+{
+	itemCount = newItemCount;
+	StartPhase ();
+}
+
+
+void PropertyTestHelpers::Progress::Advance (UInt32 itemsDoneNow /* = 1*/)
+{
+	itemsDone += itemsDoneNow;
+	UpdateWindow (itemsDone >= itemCount);
+}
+
+
+bool PropertyTestHelpers::Progress::IsCanceled ()
+{
+	if (!canceled && ACAPI_Interface (APIIo_IsProcessCanceledID, nullptr, nullptr)) {
+		canceled = true;
+	}
+	return canceled;
+}
+
+
+UInt32 PropertyTestHelpers::Progress::GetItemsDone () const
+{
+	return itemsDone;
+}
+
+
+double PropertyTestHelpers::Progress::GetSeconds () const
+{
+	return std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+}
+
+
+void PropertyTestHelpers::Progress::StartPhase ()
+{
+	if (phaseStarted) {
+		return;
+	}
+	phaseStarted = true;
+
+	Int32 maxValue = static_cast<Int32> (itemCount);
+	ACAPI_Interface (APIIo_SetNextProcessPhaseID, &phase, &maxValue);
+}
+
+
+void PropertyTestHelpers::Progress::UpdateWindow (bool force)
+{
+	StartPhase ();
+
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now ();
+	if (!force && now - lastUpdate < UpdateInterval) {
+		return;
+	}
+	lastUpdate = now;
+
+	Int32 value = static_cast<Int32> (itemsDone);
+	ACAPI_Interface (APIIo_SetProcessValueID, &value, nullptr);
+}
@@ -0,0 +1,62 @@
+// *****************************************************************************
+// File:			Property_Test_Progress.hpp
+// Description:		Property_Test add-on progress window and cancellation
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestHelpers
+// Contact person:	CSAT
+// *****************************************************************************
+
+#if !defined (PROGRESS_HPP)
+#define	PROGRESS_HPP
+
+#include "Property_Test.hpp"
+
+#include <chrono>
+
+namespace PropertyTestHelpers
+{
+
+// -----------------------------------------------------------------------------
+// Shows the process window of ArchiCAD for a long running command.
+// The command reports its progress in items (elements, definitions) and
+// calls IsCanceled () at its chunk boundaries; once the user has pressed
+// Cancel it stops there and returns APIERR_CANCEL. The window is closed and
+// the summary (items done, rate) is written to the report window when the
+// object is destroyed.
+// The item count can be set later with SetItemCount (), until the first
+// Advance () call.
+// -----------------------------------------------------------------------------
+
+class Progress
+{
+public:
+	Progress (const GS::UniString& commandName, const GS::UniString& phaseName, UInt32 itemsToProcess);
+	~Progress ();
+
+	void			SetItemCount (UInt32 itemCount);
+	void			Advance (UInt32 itemsDone = 1);
+	bool			IsCanceled ();
+
+	UInt32			GetItemsDone () const;
+	double			GetSeconds () const;
+
+private:
+	Progress (const Progress&);				// disabled
+	Progress& operator= (const Progress&);	// disabled
+
+	void			StartPhase ();
+	void			UpdateWindow (bool force);
+
+	GS::UniString							title;
+	GS::UniString							phase;
+	bool									phaseStarted;
+	UInt32									itemCount;
+	UInt32									itemsDone;
+	bool									canceled;
+	std::chrono::steady_clock::time_point	start;
+	std::chrono::steady_clock::time_point	lastUpdate;
+};
+
+}
+
+#endif
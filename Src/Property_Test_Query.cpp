@@ -0,0 +1,1711 @@
+// *****************************************************************************
+// File:			Property_Test_Query.cpp
+// Description:		Property_Test add-on predicates over property values
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestQuery
+// Contact person:	CSAT
+// *****************************************************************************
+
+#include "Property_Test_Query.hpp"
+#include "Property_Test_Batch.hpp"
+#include "Property_Test_Helpers.hpp"
+#include "Property_Test_IdGenerator.hpp"
+
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+
+// Elements read between two checks of the cancel button
+static const UInt32 CancelCheckInterval = 1024;
+
+
+// -----------------------------------------------------------------------------
+// ValueTable
+// -----------------------------------------------------------------------------
+
+PropertyTestQuery::ValueTable::ValueTable (const PropertyTestHelpers::DefinitionTable& definitionsToRead, const GS::Array<API_Guid>& elemGuids) :
+	definitions (definitionsToRead),
+	elements (elemGuids),
+	columns (definitionsToRead.GetSize ()),
+	enumIndices (definitionsToRead.GetSize ()),
+	valueCount (0)
+{
+	for (UInt32 i = 0; i < columns.size (); ++i) {
+		Column& column = columns[i];
+		column.states.assign (elemGuids.GetSize (), static_cast<UInt8> (NotAvailable));
+		if (IsEnumSetColumn (i)) {
+			enumIndices[i] = PropertyTestHelpers::EnumIndex (definitions[i]);
+			column.enumSets.resize (elemGuids.GetSize ());
+		} else {
+			column.values.resize (elemGuids.GetSize ());
+		}
+	}
+}
+
+
+GSErrCode PropertyTestQuery::ValueTable::Read (PropertyTestHelpers::Progress* progress)
+{
+	if (definitions.IsEmpty ()) {
+		return NoError;
+	}
+
+	API_ElemCategory classificationCategory;
+	GSErrCode error = PropertyTestHelpers::GetElemClassificationCategory (classificationCategory);
+	if (error != NoError) {
+		return error;
+	}
+
+	if (progress != nullptr) {
+		progress->SetItemCount (elements.GetSize ());
+	}
+
+	GS::Array<API_Property>	properties;
+	GS::Array<UInt32>		columnIndices;
+	for (UInt32 elemIndex = 0; elemIndex < elements.GetSize (); ++elemIndex) {
+		if (progress != nullptr) {
+			if (elemIndex % CancelCheckInterval == 0 && progress->IsCanceled ()) {
+				return APIERR_CANCEL;
+			}
+			progress->Advance ();
+		}
+
+		if (PropertyTestHelpers::GetAvailableProperties (elements[elemIndex], classificationCategory, definitions, properties, columnIndices) != NoError) {
+			continue;
+		}
+
+		for (UInt32 i = 0; i < properties.GetSize (); ++i) {
+			SetValue (elemIndex, columnIndices[i], properties[i].isDefault, properties[i].value);
+		}
+	}
+
+	return NoError;
+}
+
+
+void PropertyTestQuery::ValueTable::SetValue (UInt32 elemIndex, UInt32 columnIndex, bool isDefault, const API_PropertyValue& value)
+{
+	Column& column = columns[columnIndex];
+	if (column.states[elemIndex] == NotAvailable) {
+		++valueCount;
+	}
+
+	column.states[elemIndex] = static_cast<UInt8> (isDefault ? DefaultValue : CustomValue);
+	if (isDefault) {
+		return;
+	}
+	if (IsEnumSetColumn (columnIndex)) {
+		enumIndices[columnIndex].ToSet (value.multipleEnumVariant, column.enumSets[elemIndex]);
+	} else {
+		column.values[elemIndex] = value;
+	}
+}
+
+
+bool PropertyTestQuery::ValueTable::FindColumn (const API_Guid& definitionGuid, UInt32& columnIndex) const
+{
+	return definitions.Find (definitionGuid, columnIndex);
+}
+
+
+UInt32 PropertyTestQuery::ValueTable::GetElementCount () const
+{
+	return elements.GetSize ();
+}
+
+
+UInt32 PropertyTestQuery::ValueTable::GetColumnCount () const
+{
+	return definitions.GetSize ();
+}
+
+
+UInt32 PropertyTestQuery::ValueTable::GetValueCount () const
+{
+	return valueCount;
+}
+
+
+const API_Guid& PropertyTestQuery::ValueTable::GetElement (UInt32 elemIndex) const
+{
+	return elements[elemIndex];
+}
+
+
+const API_PropertyDefinition& PropertyTestQuery::ValueTable::GetDefinition (UInt32 columnIndex) const
+{
+	return definitions[columnIndex];
+}
+
+
+const PropertyTestQuery::ValueTable::Column& PropertyTestQuery::ValueTable::GetColumn (UInt32 columnIndex) const
+{
+	return columns[columnIndex];
+}
+
+
+bool PropertyTestQuery::ValueTable::IsEnumSetColumn (UInt32 columnIndex) const
+{
+	return definitions[columnIndex].collectionType == API_PropertyMultipleChoiceEnumerationCollectionType;
+}
+
+
+// -----------------------------------------------------------------------------
+// Evaluators
+// -----------------------------------------------------------------------------
+
+class PropertyTestQuery::Node
+{
+public:
+	// the columns of the table, in the order of Query::GetDefinitions (); nullptr if the table has no such column
+	typedef std::vector<const ValueTable::Column*>	Columns;
+
+	virtual ~Node ();
+
+	// matches[i] is 1 if the i-th element of the table matches, 0 if not
+	virtual void	Evaluate (const Columns& columns, UInt32 elementCount, std::vector<UInt8>& matches) const = 0;
+};
+
+
+PropertyTestQuery::Node::~Node ()
+{
+}
+
+
+namespace {
+
+using PropertyTestQuery::Node;
+using PropertyTestQuery::ValueTable;
+
+class NotNode : public Node
+{
+public:
+	explicit NotNode (std::unique_ptr<Node> operandNode) :
+		operand (std::move (operandNode))
+	{
+	}
+
+	virtual void Evaluate (const Columns& columns, UInt32 elementCount, std::vector<UInt8>& matches) const override
+	{
+		operand->Evaluate (columns, elementCount, matches);
+		for (UInt8& match : matches) {
+			match ^= 1;
+		}
+	}
+
+private:
+	std::unique_ptr<Node>	operand;
+};
+
+
+class BinaryNode : public Node
+{
+public:
+	enum Kind {
+		And,
+		Or
+	};
+
+	BinaryNode (Kind nodeKind, std::unique_ptr<Node> leftNode, std::unique_ptr<Node> rightNode) :
+		kind (nodeKind),
+		left (std::move (leftNode)),
+		right (std::move (rightNode))
+	{
+	}
+
+	virtual void Evaluate (const Columns& columns, UInt32 elementCount, std::vector<UInt8>& matches) const override
+	{
+		left->Evaluate (columns, elementCount, matches);
+		std::vector<UInt8> rightMatches;
+		right->Evaluate (columns, elementCount, rightMatches);
+		if (kind == And) {
+			for (UInt32 i = 0; i < elementCount; ++i) {
+				matches[i] &= rightMatches[i];
+			}
+		} else {
+			for (UInt32 i = 0; i < elementCount; ++i) {
+				matches[i] |= rightMatches[i];
+			}
+		}
+	}
+
+private:
+	Kind					kind;
+	std::unique_ptr<Node>	left;
+	std::unique_ptr<Node>	right;
+};
+
+
+class IsDefaultNode : public Node
+{
+public:
+	explicit IsDefaultNode (UInt32 columnIndex) :
+		column (columnIndex)
+	{
+	}
+
+	virtual void Evaluate (const Columns& columns, UInt32 elementCount, std::vector<UInt8>& matches) const override
+	{
+		matches.assign (elementCount, 0);
+		if (columns[column] == nullptr) {
+			return;
+		}
+
+		const std::vector<UInt8>& states = columns[column]->states;
+		for (UInt32 i = 0; i < elementCount; ++i) {
+			matches[i] = (states[i] == ValueTable::DefaultValue) ? 1 : 0;
+		}
+	}
+
+private:
+	UInt32	column;
+};
+
+
+// Tests the value of one column with Test, a functor on API_PropertyValue
+// chosen by the type of the property at compile time. The default value is
+// the same for every element, it is tested once, when the node is created.
+template <typename Test>
+class ValueNode : public Node
+{
+public:
+	ValueNode (UInt32 columnIndex, const Test& valueTest, const API_PropertyValue& defaultValue) :
+		column (columnIndex),
+		test (valueTest),
+		defaultMatch (valueTest (defaultValue) ? 1 : 0)
+	{
+	}
+
+	virtual void Evaluate (const Columns& columns, UInt32 elementCount, std::vector<UInt8>& matches) const override
+	{
+		matches.assign (elementCount, 0);
+		if (columns[column] == nullptr) {
+			return;
+		}
+
+		const std::vector<UInt8>& states = columns[column]->states;
+		const std::vector<API_PropertyValue>& values = columns[column]->values;
+		for (UInt32 i = 0; i < elementCount; ++i) {
+			switch (states[i]) {
+				case ValueTable::DefaultValue:	matches[i] = defaultMatch;						break;
+				case ValueTable::CustomValue:	matches[i] = test (values[i]) ? 1 : 0;			break;
+				default:																		break;
+			}
+		}
+	}
+
+private:
+	UInt32	column;
+	Test	test;
+	UInt8	defaultMatch;
+};
+
+
+// Tests the value of a multiple choice enumeration column with Test, a
+// functor on the set of the ordinals of its choices, like ValueNode does
+template <typename Test>
+class EnumSetNode : public Node
+{
+public:
+	EnumSetNode (UInt32 columnIndex, const Test& setTest, const PropertyTestHelpers::EnumSet& defaultSet) :
+		column (columnIndex),
+		test (setTest),
+		defaultMatch (setTest (defaultSet) ? 1 : 0)
+	{
+	}
+
+	virtual void Evaluate (const Columns& columns, UInt32 elementCount, std::vector<UInt8>& matches) const override
+	{
+		matches.assign (elementCount, 0);
+		if (columns[column] == nullptr) {
+			return;
+		}
+
+		const std::vector<UInt8>& states = columns[column]->states;
+		const std::vector<PropertyTestHelpers::EnumSet>& enumSets = columns[column]->enumSets;
+		for (UInt32 i = 0; i < elementCount; ++i) {
+			switch (states[i]) {
+				case ValueTable::DefaultValue:	matches[i] = defaultMatch;						break;
+				case ValueTable::CustomValue:	matches[i] = test (enumSets[i]) ? 1 : 0;		break;
+				default:																		break;
+			}
+		}
+	}
+
+private:
+	UInt32	column;
+	Test	test;
+	UInt8	defaultMatch;
+};
+
+
+// Accessors of the typed member of an API_Variant
+
+struct IntValue {
+	typedef Int32 Type;
+	static Int32 Get (const API_Variant& variant) { return variant.intValue; }
+};
+
+struct IntAsRealValue {
+	typedef double Type;
+	static double Get (const API_Variant& variant) { return variant.intValue; }
+};
+
+struct RealValue {
+	typedef double Type;
+	static double Get (const API_Variant& variant) { return variant.doubleValue; }
+};
+
+struct BoolValue {
+	typedef bool Type;
+	static bool Get (const API_Variant& variant) { return variant.boolValue; }
+};
+
+struct StringValue {
+	typedef GS::UniString Type;
+	static const GS::UniString& Get (const API_Variant& variant) { return variant.uniStringValue; }
+};
+
+
+// Tests of a value
+
+template <typename Accessor, typename Compare>
+struct SingleCompare {
+	typename Accessor::Type		operand;
+
+	bool operator() (const API_PropertyValue& value) const
+	{
+		return Compare () (Accessor::Get (value.singleVariant.variant), operand);
+	}
+};
+
+template <typename Accessor>
+struct ListContains {
+	typename Accessor::Type		operand;
+
+	bool operator() (const API_PropertyValue& value) const
+	{
+		const GS::Array<API_Variant>& items = value.listVariant.variants;
+		for (UInt32 i = 0; i < items.GetSize (); ++i) {
+			if (Accessor::Get (items[i]) == operand) {
+				return true;
+			}
+		}
+		return false;
+	}
+};
+
+struct StringContains {
+	GS::UniString	operand;
+
+	bool operator() (const API_PropertyValue& value) const
+	{
+		return value.singleVariant.variant.uniStringValue.Contains (operand);
+	}
+};
+
+template <typename Compare>
+struct EnumCompare {
+	API_Guid	operand;
+
+	bool operator() (const API_PropertyValue& value) const
+	{
+		return Compare () (value.singleEnumVariant.guid, operand);
+	}
+};
+
+
+// Tests of the set of choices of a multiple choice enumeration
+
+struct EnumSetContains {
+	PropertyTestHelpers::EnumSet	operand;
+
+	bool operator() (const PropertyTestHelpers::EnumSet& enumSet) const
+	{
+		return enumSet.ContainsAll (operand);
+	}
+};
+
+template <typename Compare>
+struct EnumSetCompare {
+	PropertyTestHelpers::EnumSet	operand;
+
+	bool operator() (const PropertyTestHelpers::EnumSet& enumSet) const
+	{
+		return Compare () (enumSet, operand);
+	}
+};
+
+
+enum CompareOperator {
+	EqualOperator,
+	NotEqualOperator,
+	LessOperator,
+	LessOrEqualOperator,
+	GreaterOperator,
+	GreaterOrEqualOperator
+};
+
+
+template <typename Test>
+std::unique_ptr<Node> CreateValueNode (UInt32 column, const Test& test, const API_PropertyDefinition& definition)
+{
+	return std::unique_ptr<Node> (new ValueNode<Test> (column, test, definition.defaultValue));
+}
+
+
+// The default value is converted with the index the operand was found with
+template <typename Test>
+std::unique_ptr<Node> CreateEnumSetNode (UInt32 column, const Test& test, const PropertyTestHelpers::EnumIndex& enumIndex, const API_PropertyDefinition& definition)
+{
+	PropertyTestHelpers::EnumSet defaultSet;
+	enumIndex.ToSet (definition.defaultValue.multipleEnumVariant, defaultSet);
+	return std::unique_ptr<Node> (new EnumSetNode<Test> (column, test, defaultSet));
+}
+
+
+template <typename Accessor>
+std::unique_ptr<Node> CreateEqualityNode (UInt32 column, CompareOperator op, const typename Accessor::Type& operand, const API_PropertyDefinition& definition)
+{
+	typedef typename Accessor::Type Type;
+	if (op == EqualOperator) {
+		const SingleCompare<Accessor, std::equal_to<Type>> test = { operand };
+		return CreateValueNode (column, test, definition);
+	}
+	const SingleCompare<Accessor, std::not_equal_to<Type>> test = { operand };
+	return CreateValueNode (column, test, definition);
+}
+
+
+template <typename Accessor>
+std::unique_ptr<Node> CreateCompareNode (UInt32 column, CompareOperator op, const typename Accessor::Type& operand, const API_PropertyDefinition& definition)
+{
+	typedef typename Accessor::Type Type;
+	switch (op) {
+		case LessOperator: {
+			const SingleCompare<Accessor, std::less<Type>> test = { operand };
+			return CreateValueNode (column, test, definition);
+		}
+		case LessOrEqualOperator: {
+			const SingleCompare<Accessor, std::less_equal<Type>> test = { operand };
+			return CreateValueNode (column, test, definition);
+		}
+		case GreaterOperator: {
+			const SingleCompare<Accessor, std::greater<Type>> test = { operand };
+			return CreateValueNode (column, test, definition);
+		}
+		case GreaterOrEqualOperator: {
+			const SingleCompare<Accessor, std::greater_equal<Type>> test = { operand };
+			return CreateValueNode (column, test, definition);
+		}
+		default:
+			return CreateEqualityNode<Accessor> (column, op, operand, definition);
+	}
+}
+
+
+bool IsDigit (char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+
+bool IsNameStart (char c)
+{
+	// the bytes of the UTF-8 sequences are name characters too
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || static_cast<UInt8> (c) >= 0x80;
+}
+
+
+bool IsNameCharacter (char c)
+{
+	return IsNameStart (c) || IsDigit (c);
+}
+
+} // namespace
+
+
+// -----------------------------------------------------------------------------
+// Parser
+// -----------------------------------------------------------------------------
+
+class PropertyTestQuery::Query::Parser
+{
+public:
+	Parser (Query& queryToBuild, const GS::Array<API_PropertyDefinition>& definitionsToSearch);
+
+	bool		Parse (const char* text, std::string& errorMessage);
+
+private:
+	enum TokenType {
+		EndToken,
+		NameToken,
+		StringToken,
+		IntegerToken,
+		RealToken,
+		TrueToken,
+		FalseToken,
+		AndToken,
+		OrToken,
+		NotToken,
+		ContainsToken,
+		IsDefaultToken,
+		OperatorToken,
+		LeftParenToken,
+		RightParenToken
+	};
+
+	struct Token {
+		TokenType		type;
+		std::string		text;		// UTF-8, unquoted
+		UInt32			position;	// of the first character, from 1
+	};
+
+	// the literal converted to the value type of a property
+	struct Operand {
+		enum Kind {
+			Int,
+			IntAsReal,
+			Real,
+			String,
+			Bool
+		};
+
+		Kind			kind;
+		Int32			intValue;
+		double			realValue;
+		GS::UniString	stringValue;
+		bool			boolValue;
+	};
+
+	bool					Tokenize (const char* text);
+
+	std::unique_ptr<Node>	ParseOr ();
+	std::unique_ptr<Node>	ParseAnd ();
+	std::unique_ptr<Node>	ParseUnary ();
+	std::unique_ptr<Node>	ParseComparison ();
+
+	std::unique_ptr<Node>	CreateCompare (const Token& name, UInt32 column, CompareOperator op, const Token& literal);
+	std::unique_ptr<Node>	CreateContains (const Token& name, UInt32 column, const Token& literal);
+
+	bool					FindDefinition (const Token& name, UInt32& column);
+	bool					FindEnumValue (const Token& name, const API_PropertyDefinition& definition, const Token& literal, API_Guid& enumGuid);
+	bool					FindEnumSet (const Token& name, const PropertyTestHelpers::EnumIndex& enumIndex, const Token& literal, PropertyTestHelpers::EnumSet& enumSet);
+	bool					ConvertLiteral (const Token& name, const API_PropertyDefinition& definition, const Token& literal, Operand& operand);
+
+	const Token&			Peek () const;
+	const Token&			Next ();
+	void					SetError (UInt32 position, const std::string& message);
+	void					SetExpected (const Token& found, const std::string& expected);
+
+	Query&										query;
+	const GS::Array<API_PropertyDefinition>&	allDefinitions;
+	std::vector<Token>							tokens;
+	size_t										current;
+	std::string									error;
+};
+
+
+PropertyTestQuery::Query::Parser::Parser (Query& queryToBuild, const GS::Array<API_PropertyDefinition>& definitionsToSearch) :
+	query (queryToBuild),
+	allDefinitions (definitionsToSearch),
+	current (0)
+{
+}
+
+
+bool PropertyTestQuery::Query::Parser::Parse (const char* text, std::string& errorMessage)
+{
+	if (Tokenize (text)) {
+		if (Peek ().type == EndToken) {
+			SetError (1, "the query is empty");
+		} else {
+			std::unique_ptr<Node> root = ParseOr ();
+			if (root != nullptr && Peek ().type != EndToken) {
+				SetExpected (Peek (), "'and', 'or' or the end of the query");
+			} else if (root != nullptr) {
+				query.root = std::move (root);
+			}
+		}
+	}
+
+	errorMessage = error;
+	return error.empty ();
+}
+
+
+bool PropertyTestQuery::Query::Parser::Tokenize (const char* text)
+{
+	const char* p = text;
+	for (;;) {
+		while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') {
+			++p;
+		}
+
+		Token token;
+		token.position = static_cast<UInt32> (p - text) + 1;
+
+		const char c = *p;
+		if (c == '\0') {
+			token.type = EndToken;
+			tokens.push_back (token);
+			return true;
+		}
+
+		if (c == '(' || c == ')') {
+			token.type = (c == '(') ? LeftParenToken : RightParenToken;
+			token.text.assign (p, 1);
+			++p;
+		} else if (c == '=' || c == '!' || c == '<' || c == '>') {
+			token.type = OperatorToken;
+			if (p[1] == '=') {
+				token.text = (c == '=') ? "=" : std::string (p, 2);		// "==" is "="
+				p += 2;
+			} else if (c == '<' && p[1] == '>') {
+				token.text = "!=";
+				p += 2;
+			} else if (c == '!') {
+				SetError (token.position, "'=' is expected after '!'");
+				return false;
+			} else {
+				token.text.assign (p, 1);
+				++p;
+			}
+		} else if (c == '"') {
+			token.type = StringToken;
+			for (++p; *p != '"'; ++p) {
+				if (*p == '\0') {
+					SetError (token.position, "the string is not closed");
+					return false;
+				}
+				if (*p == '\\' && p[1] != '\0') {
+					++p;
+				}
+				token.text.push_back (*p);
+			}
+			++p;
+		} else if (c == '[') {
+			const char* end = std::strchr (p + 1, ']');
+			if (end == nullptr) {
+				SetError (token.position, "the property name is not closed");
+				return false;
+			}
+			token.type = NameToken;
+			token.text.assign (p + 1, end);
+			p = end + 1;
+			if (token.text.empty ()) {
+				SetError (token.position, "the property name is empty");
+				return false;
+			}
+		} else if (IsDigit (c) || (c == '.' && IsDigit (p[1])) ||
+				   ((c == '-' || c == '+') && (IsDigit (p[1]) || (p[1] == '.' && IsDigit (p[2]))))) {
+			const char* end = p + 1;
+			while (IsDigit (*end)) {
+				++end;
+			}
+			bool isReal = (c == '.');
+			if (*end == '.' && !isReal) {
+				isReal = true;
+				++end;
+				while (IsDigit (*end)) {
+					++end;
+				}
+			}
+			if ((*end == 'e' || *end == 'E') && (IsDigit (end[1]) || ((end[1] == '-' || end[1] == '+') && IsDigit (end[2])))) {
+				isReal = true;
+				end += 2;
+				while (IsDigit (*end)) {
+					++end;
+				}
+			}
+			if (IsNameCharacter (*end)) {
+				SetError (static_cast<UInt32> (end - text) + 1, "unexpected character in a number");
+				return false;
+			}
+			token.type = isReal ? RealToken : IntegerToken;
+			token.text.assign (p, end);
+			p = end;
+		} else if (IsNameStart (c)) {
+			const char* end = p + 1;
+			while (IsNameCharacter (*end)) {
+				++end;
+			}
+			token.text.assign (p, end);
+			p = end;
+
+			std::string keyword = token.text;
+			for (char& k : keyword) {
+				if (k >= 'A' && k <= 'Z') {
+					k = static_cast<char> (k - 'A' + 'a');
+				}
+			}
+			if (keyword == "and") {
+				token.type = AndToken;
+			} else if (keyword == "or") {
+				token.type = OrToken;
+			} else if (keyword == "not") {
+				token.type = NotToken;
+			} else if (keyword == "contains") {
+				token.type = ContainsToken;
+			} else if (keyword == "isdefault") {
+				token.type = IsDefaultToken;
+			} else if (keyword == "true") {
+				token.type = TrueToken;
+			} else if (keyword == "false") {
+				token.type = FalseToken;
+			} else {
+				token.type = NameToken;
+			}
+		} else {
+			SetError (token.position, std::string ("unexpected character '") + c + "'");
+			return false;
+		}
+
+		tokens.push_back (token);
+	}
+}
+
+
+std::unique_ptr<PropertyTestQuery::Node> PropertyTestQuery::Query::Parser::ParseOr ()
+{
+	std::unique_ptr<Node> node = ParseAnd ();
+	while (node != nullptr && Peek ().type == OrToken) {
+		Next ();
+		std::unique_ptr<Node> right = ParseAnd ();
+		if (right == nullptr) {
+			return nullptr;
+		}
+		std::unique_ptr<Node> left = std::move (node);
+		node.reset (new BinaryNode (BinaryNode::Or, std::move (left), std::move (right)));
+	}
+	return node;
+}
+
+
+std::unique_ptr<PropertyTestQuery::Node> PropertyTestQuery::Query::Parser::ParseAnd ()
+{
+	std::unique_ptr<Node> node = ParseUnary ();
+	while (node != nullptr && Peek ().type == AndToken) {
+		Next ();
+		std::unique_ptr<Node> right = ParseUnary ();
+		if (right == nullptr) {
+			return nullptr;
+		}
+		std::unique_ptr<Node> left = std::move (node);
+		node.reset (new BinaryNode (BinaryNode::And, std::move (left), std::move (right)));
+	}
+	return node;
+}
+
+
+std::unique_ptr<PropertyTestQuery::Node> PropertyTestQuery::Query::Parser::ParseUnary ()
+{
+	if (Peek ().type == NotToken) {
+		Next ();
+		std::unique_ptr<Node> operand = ParseUnary ();
+		if (operand == nullptr) {
+			return nullptr;
+		}
+		return std::unique_ptr<Node> (new NotNode (std::move (operand)));
+	}
+
+	if (Peek ().type == LeftParenToken) {
+		Next ();
+		std::unique_ptr<Node> node = ParseOr ();
+		if (node == nullptr) {
+			return nullptr;
+		}
+		if (Peek ().type != RightParenToken) {
+			SetExpected (Peek (), "')'");
+			return nullptr;
+		}
+		Next ();
+		return node;
+	}
+
+	return ParseComparison ();
+}
+
+
+std::unique_ptr<PropertyTestQuery::Node> PropertyTestQuery::Query::Parser::ParseComparison ()
+{
+	const Token& name = Next ();
+	if (name.type != NameToken) {
+		SetExpected (name, "a property name");
+		return nullptr;
+	}
+
+	UInt32 column = 0;
+	if (!FindDefinition (name, column)) {
+		return nullptr;
+	}
+
+	const Token& operation = Next ();
+	if (operation.type == IsDefaultToken) {
+		return std::unique_ptr<Node> (new IsDefaultNode (column));
+	}
+	if (operation.type != OperatorToken && operation.type != ContainsToken) {
+		SetExpected (operation, "an operator, 'contains' or 'isDefault' after " + name.text);
+		return nullptr;
+	}
+
+	const Token& literal = Next ();
+	if (literal.type != StringToken && literal.type != IntegerToken && literal.type != RealToken &&
+		literal.type != TrueToken && literal.type != FalseToken) {
+		SetExpected (literal, "a value");
+		return nullptr;
+	}
+
+	if (operation.type == ContainsToken) {
+		return CreateContains (name, column, literal);
+	}
+
+	CompareOperator op = EqualOperator;
+	if (operation.text == "!=") {
+		op = NotEqualOperator;
+	} else if (operation.text == "<") {
+		op = LessOperator;
+	} else if (operation.text == "<=") {
+		op = LessOrEqualOperator;
+	} else if (operation.text == ">") {
+		op = GreaterOperator;
+	} else if (operation.text == ">=") {
+		op = GreaterOrEqualOperator;
+	}
+	return CreateCompare (name, column, op, literal);
+}
+
+
+std::unique_ptr<PropertyTestQuery::Node> PropertyTestQuery::Query::Parser::CreateCompare (const Token& name, UInt32 column, CompareOperator op, const Token& literal)
+{
+	const API_PropertyDefinition& definition = query.definitions[column];
+	const bool isEquality = (op == EqualOperator || op == NotEqualOperator);
+
+	switch (definition.collectionType) {
+		case API_PropertySingleCollectionType:
+			break;
+
+		case API_PropertySingleChoiceEnumerationCollectionType: {
+			if (!isEquality) {
+				SetError (name.position, name.text + " is an enumeration, only = and != can be used on it");
+				return nullptr;
+			}
+			API_Guid enumGuid;
+			if (!FindEnumValue (name, definition, literal, enumGuid)) {
+				return nullptr;
+			}
+			if (op == EqualOperator) {
+				const EnumCompare<std::equal_to<API_Guid>> test = { enumGuid };
+				return CreateValueNode (column, test, definition);
+			}
+			const EnumCompare<std::not_equal_to<API_Guid>> test = { enumGuid };
+			return CreateValueNode (column, test, definition);
+		}
+
+		case API_PropertyMultipleChoiceEnumerationCollectionType: {
+			if (!isEquality) {
+				SetError (name.position, name.text + " is an enumeration, only = and != can be used on it");
+				return nullptr;
+			}
+			const PropertyTestHelpers::EnumIndex enumIndex (definition);
+			PropertyTestHelpers::EnumSet enumSet;
+			if (!FindEnumSet (name, enumIndex, literal, enumSet)) {
+				return nullptr;
+			}
+			if (op == EqualOperator) {
+				const EnumSetCompare<std::equal_to<PropertyTestHelpers::EnumSet>> test = { enumSet };
+				return CreateEnumSetNode (column, test, enumIndex, definition);
+			}
+			const EnumSetCompare<std::not_equal_to<PropertyTestHelpers::EnumSet>> test = { enumSet };
+			return CreateEnumSetNode (column, test, enumIndex, definition);
+		}
+
+		default:
+			SetError (name.position, name.text + " has more values, only 'contains' can be used on it");
+			return nullptr;
+	}
+
+	Operand operand;
+	if (!ConvertLiteral (name, definition, literal, operand)) {
+		return nullptr;
+	}
+
+	switch (operand.kind) {
+		case Operand::Int:			return CreateCompareNode<IntValue> (column, op, operand.intValue, definition);
+		case Operand::IntAsReal:	return CreateCompareNode<IntAsRealValue> (column, op, operand.realValue, definition);
+		case Operand::Real:			return CreateCompareNode<RealValue> (column, op, operand.realValue, definition);
+		case Operand::String:		return CreateCompareNode<StringValue> (column, op, operand.stringValue, definition);
+		case Operand::Bool:
+		default:
+			if (!isEquality) {
+				SetError (name.position, name.text + " is a boolean, only = and != can be used on it");
+				return nullptr;
+			}
+			return CreateEqualityNode<BoolValue> (column, op, operand.boolValue, definition);
+	}
+}
+
+
+std::unique_ptr<PropertyTestQuery::Node> PropertyTestQuery::Query::Parser::CreateContains (const Token& name, UInt32 column, const Token& literal)
+{
+	const API_PropertyDefinition& definition = query.definitions[column];
+
+	switch (definition.collectionType) {
+		case API_PropertySingleCollectionType: {
+			if (definition.valueType != API_PropertyStringValueType) {
+				SetError (name.position, name.text + " is not a string, a list or a multiple choice enumeration, 'contains' cannot be used on it");
+				return nullptr;
+			}
+			Operand operand;
+			if (!ConvertLiteral (name, definition, literal, operand)) {
+				return nullptr;
+			}
+			const StringContains test = { operand.stringValue };
+			return CreateValueNode (column, test, definition);
+		}
+
+		case API_PropertyListCollectionType: {
+			Operand operand;
+			if (!ConvertLiteral (name, definition, literal, operand)) {
+				return nullptr;
+			}
+			switch (operand.kind) {
+				case Operand::Int: {
+					const ListContains<IntValue> test = { operand.intValue };
+					return CreateValueNode (column, test, definition);
+				}
+				case Operand::IntAsReal: {
+					const ListContains<IntAsRealValue> test = { operand.realValue };
+					return CreateValueNode (column, test, definition);
+				}
+				case Operand::Real: {
+					const ListContains<RealValue> test = { operand.realValue };
+					return CreateValueNode (column, test, definition);
+				}
+				case Operand::String: {
+					const ListContains<StringValue> test = { operand.stringValue };
+					return CreateValueNode (column, test, definition);
+				}
+				case Operand::Bool:
+				default: {
+					const ListContains<BoolValue> test = { operand.boolValue };
+					return CreateValueNode (column, test, definition);
+				}
+			}
+		}
+
+		case API_PropertyMultipleChoiceEnumerationCollectionType: {
+			const PropertyTestHelpers::EnumIndex enumIndex (definition);
+			EnumSetContains test;
+			if (!FindEnumSet (name, enumIndex, literal, test.operand)) {
+				return nullptr;
+			}
+			return CreateEnumSetNode (column, test, enumIndex, definition);
+		}
+
+		default:
+			SetError (name.position, name.text + " has one value, use = instead of 'contains'");
+			return nullptr;
+	}
+}
+
+
+bool PropertyTestQuery::Query::Parser::FindDefinition (const Token& name, UInt32& column)
+{
+	const GS::UniString uniName (name.text.c_str (), CC_UTF8);
+	UInt32 matchCount = 0;
+	UInt32 definitionIndex = 0;
+	for (UInt32 i = 0; i < allDefinitions.GetSize (); ++i) {
+		if (allDefinitions[i].name == uniName) {
+			definitionIndex = i;
+			++matchCount;
+		}
+	}
+
+	if (matchCount == 0) {
+		SetError (name.position, "there is no property named " + name.text);
+		return false;
+	}
+	if (matchCount > 1) {
+		SetError (name.position, "there are " + std::to_string (matchCount) + " properties named " + name.text);
+		return false;
+	}
+
+	// each definition is one column, however many times it is used
+	column = query.definitions.Add (allDefinitions[definitionIndex]);
+	return true;
+}
+
+
+bool PropertyTestQuery::Query::Parser::FindEnumValue (const Token& name, const API_PropertyDefinition& definition, const Token& literal, API_Guid& enumGuid)
+{
+	const PropertyTestHelpers::EnumIndex enumIndex (definition);
+	UInt32 ordinal = 0;
+	if (enumIndex.FindByText (literal.text.data (), literal.text.size (), ordinal)) {
+		enumGuid = enumIndex.Get (ordinal).guid;
+		return true;
+	}
+
+	SetError (literal.position, name.text + " has no value " + literal.text);
+	return false;
+}
+
+
+// The literal is one display text, or more separated by ; or empty for no choice
+bool PropertyTestQuery::Query::Parser::FindEnumSet (const Token& name, const PropertyTestHelpers::EnumIndex& enumIndex, const Token& literal, PropertyTestHelpers::EnumSet& enumSet)
+{
+	enumSet.Clear ();
+	if (literal.text.empty ()) {
+		return true;
+	}
+
+	UInt32 ordinal = 0;
+	if (enumIndex.FindByText (literal.text.data (), literal.text.size (), ordinal)) {
+		enumSet.Add (ordinal);		// a display text with ; in it
+		return true;
+	}
+
+	size_t itemStart = 0;
+	for (;;) {
+		const size_t separator = literal.text.find (';', itemStart);
+		const size_t itemEnd = (separator == std::string::npos) ? literal.text.size () : separator;
+		if (!enumIndex.FindByText (literal.text.data () + itemStart, itemEnd - itemStart, ordinal)) {
+			SetError (literal.position, name.text + " has no value " + literal.text.substr (itemStart, itemEnd - itemStart));
+			return false;
+		}
+		enumSet.Add (ordinal);
+		if (separator == std::string::npos) {
+			return true;
+		}
+		itemStart = separator + 1;
+	}
+}
+
+
+bool PropertyTestQuery::Query::Parser::ConvertLiteral (const Token& name, const API_PropertyDefinition& definition, const Token& literal, Operand& operand)
+{
+	switch (definition.valueType) {
+		case API_PropertyIntegerValueType:
+			if (literal.type == IntegerToken) {
+				const long long number = std::strtoll (literal.text.c_str (), nullptr, 10);
+				if (number < INT_MIN || number > INT_MAX) {
+					SetError (literal.position, literal.text + " is out of the range of " + name.text);
+					return false;
+				}
+				operand.kind = Operand::Int;
+				operand.intValue = static_cast<Int32> (number);
+				return true;
+			}
+			if (literal.type == RealToken) {
+				operand.kind = Operand::IntAsReal;
+				operand.realValue = std::strtod (literal.text.c_str (), nullptr);
+				return true;
+			}
+			SetError (literal.position, name.text + " is an integer, a number is expected");
+			return false;
+
+		case API_PropertyRealValueType:
+			if (literal.type == IntegerToken || literal.type == RealToken) {
+				operand.kind = Operand::Real;
+				operand.realValue = std::strtod (literal.text.c_str (), nullptr);
+				return true;
+			}
+			SetError (literal.position, name.text + " is a real number, a number is expected");
+			return false;
+
+		case API_PropertyStringValueType:
+			if (literal.type == StringToken) {
+				operand.kind = Operand::String;
+				operand.stringValue = GS::UniString (literal.text.c_str (), CC_UTF8);
+				return true;
+			}
+			SetError (literal.position, name.text + " is a string, a quoted string is expected");
+			return false;
+
+		case API_PropertyBooleanValueType:
+			if (literal.type == TrueToken || literal.type == FalseToken) {
+				operand.kind = Operand::Bool;
+				operand.boolValue = (literal.type == TrueToken);
+				return true;
+			}
+			SetError (literal.position, name.text + " is a boolean, true or false is expected");
+			return false;
+
+		default:
+			SetError (name.position, "the value type of " + name.text + " is not supported");
+			return false;
+	}
+}
+
+
+const PropertyTestQuery::Query::Parser::Token& PropertyTestQuery::Query::Parser::Peek () const
+{
+	return tokens[current];
+}
+
+
+// The end token is never passed
+const PropertyTestQuery::Query::Parser::Token& PropertyTestQuery::Query::Parser::Next ()
+{
+	const Token& token = tokens[current];
+	if (token.type != EndToken) {
+		++current;
+	}
+	return token;
+}
+
+
+void PropertyTestQuery::Query::Parser::SetError (UInt32 position, const std::string& message)
+{
+	// the first error is the one to report
+	if (error.empty ()) {
+		error = "at " + std::to_string (position) + ": " + message;
+	}
+}
+
+
+void PropertyTestQuery::Query::Parser::SetExpected (const Token& found, const std::string& expected)
+{
+	if (found.type == EndToken) {
+		SetError (found.position, expected + " is expected at the end of the query");
+	} else {
+		SetError (found.position, expected + " is expected instead of " + found.text);
+	}
+}
+
+
+// -----------------------------------------------------------------------------
+// Query
+// -----------------------------------------------------------------------------
+
+PropertyTestQuery::Query::Query ()
+{
+}
+
+
+PropertyTestQuery::Query::~Query ()
+{
+}
+
+
+bool PropertyTestQuery::Query::Compile (const char* text, const GS::Array<API_PropertyDefinition>& allDefinitions, std::string& errorMessage)
+{
+	root.reset ();
+	definitions.Clear ();
+
+	Parser parser (*this, allDefinitions);
+	if (!parser.Parse (text, errorMessage)) {
+		root.reset ();
+		definitions.Clear ();
+		return false;
+	}
+	return true;
+}
+
+
+const PropertyTestHelpers::DefinitionTable& PropertyTestQuery::Query::GetDefinitions () const
+{
+	return definitions;
+}
+
+
+void PropertyTestQuery::Query::Evaluate (const ValueTable& table, std::vector<UInt8>& matches) const
+{
+	if (root == nullptr) {
+		matches.assign (table.GetElementCount (), 0);
+		return;
+	}
+
+	Node::Columns columns (definitions.GetSize (), nullptr);
+	for (UInt32 i = 0; i < definitions.GetSize (); ++i) {
+		UInt32 columnIndex = 0;
+		if (table.FindColumn (definitions[i].guid, columnIndex)) {
+			columns[i] = &table.GetColumn (columnIndex);
+		}
+	}
+
+	root->Evaluate (columns, table.GetElementCount (), matches);
+}
+
+
+void PropertyTestQuery::Query::Filter (const ValueTable& table, GS::Array<API_Guid>& matchingElements) const
+{
+	std::vector<UInt8> matches;
+	Evaluate (table, matches);
+	for (UInt32 i = 0; i < matches.size (); ++i) {
+		if (matches[i] != 0) {
+			matchingElements.Push (table.GetElement (i));
+		}
+	}
+}
+
+
+// -----------------------------------------------------------------------------
+// Benchmark
+// -----------------------------------------------------------------------------
+
+void PropertyTestQuery::RunBenchmark (UInt32 elementCount, const char* commandName)
+{
+	static const UInt32 RepeatCount = 10;
+	static const char* fruits[] = { "Apple", "Pear", "Watermelon" };
+	static const char* queries[] = {
+		"IntProp > 40",
+		"Tags contains \"Apple\"",
+		"Tags = \"Pear;Apple\"",
+		"IntProp isDefault",
+		"Height >= 2.5 and not Label contains \"7\"",
+		"(IntProp < 10 or IntProp >= 90) and Tags contains \"Pear\"",
+		"Notes contains \"Note 3\" or Label = \"Label 42\""
+	};
+
+	PropertyTestHelpers::IdGenerator ids (PropertyTestHelpers::BenchmarkSeed);
+
+	GS::Array<API_PropertyDefinition> definitions;
+	definitions.Push (PropertyTestHelpers::CreateStandInDefinition (ids, "IntProp", API_PropertySingleCollectionType, API_PropertyIntegerValueType));
+	definitions.Push (PropertyTestHelpers::CreateStandInDefinition (ids, "Height", API_PropertySingleCollectionType, API_PropertyRealValueType));
+	definitions.Push (PropertyTestHelpers::CreateStandInDefinition (ids, "Label", API_PropertySingleCollectionType, API_PropertyStringValueType));
+	definitions.Push (PropertyTestHelpers::CreateStandInDefinition (ids, "Notes", API_PropertyListCollectionType, API_PropertyStringValueType));
+	definitions.Push (PropertyTestHelpers::CreateStandInDefinition (ids, "Tags", API_PropertyMultipleChoiceEnumerationCollectionType, API_PropertyStringValueType));
+	for (const char* fruit : fruits) {
+		API_SingleEnumerationVariant enumValue;
+		enumValue.guid = ids.NextGuid ();
+		enumValue.variant.type = API_PropertyStringValueType;
+		enumValue.variant.uniStringValue = fruit;
+		definitions[4].possibleEnumValues.Push (enumValue);
+	}
+
+	GS::Array<API_Guid> elemGuids;
+	ids.NextGuids (elementCount, elemGuids);
+
+	// the stand-in of ValueTable::Read: generated values, every tenth integer is the default one
+	PropertyTestBatch::Stopwatch stopwatch;
+	ValueTable table (PropertyTestHelpers::DefinitionTable (definitions), elemGuids);
+	std::mt19937 random (static_cast<std::mt19937::result_type> (PropertyTestHelpers::BenchmarkSeed));
+	API_PropertyValue intValue;
+	API_PropertyValue realValue;
+	API_PropertyValue stringValue;
+	API_PropertyValue listValue;
+	API_PropertyValue enumValue;
+	intValue.singleVariant.variant.type = API_PropertyIntegerValueType;
+	realValue.singleVariant.variant.type = API_PropertyRealValueType;
+	stringValue.singleVariant.variant.type = API_PropertyStringValueType;
+	for (UInt32 i = 0; i < elementCount; ++i) {
+		intValue.singleVariant.variant.intValue = static_cast<Int32> (random () % 100);
+		table.SetValue (i, 0, i % 10 == 0, intValue);
+
+		realValue.singleVariant.variant.doubleValue = (random () % 500) / 100.0;
+		table.SetValue (i, 1, false, realValue);
+
+		stringValue.singleVariant.variant.uniStringValue = GS::UniString ("Label ") + GS::ValueToUniString (static_cast<Int32> (random () % 1000));
+		table.SetValue (i, 2, false, stringValue);
+
+		listValue.listVariant.variants.Clear ();
+		for (UInt32 item = random () % 3; item > 0; --item) {
+			API_Variant variant;
+			variant.type = API_PropertyStringValueType;
+			variant.uniStringValue = GS::UniString ("Note ") + GS::ValueToUniString (static_cast<Int32> (random () % 10));
+			listValue.listVariant.variants.Push (variant);
+		}
+		table.SetValue (i, 3, false, listValue);
+
+		enumValue.multipleEnumVariant.variants.Clear ();
+		const UInt32 fruitMask = random () % 8;
+		for (UInt32 fruit = 0; fruit < 3; ++fruit) {
+			if ((fruitMask & (1 << fruit)) != 0) {
+				enumValue.multipleEnumVariant.variants.Push (definitions[4].possibleEnumValues[fruit]);
+			}
+		}
+		table.SetValue (i, 4, false, enumValue);
+	}
+
+	WriteReport ("%s: %u element(s), %u value(s) generated in %.3f s", commandName, table.GetElementCount (), table.GetValueCount (), stopwatch.GetSeconds ());
+
+	std::vector<UInt8> matches;
+	for (const char* text : queries) {
+		Query query;
+		std::string errorMessage;
+		stopwatch.Restart ();
+		if (!query.Compile (text, definitions, errorMessage)) {
+			WriteReport ("  %s: %s", text, errorMessage.c_str ());
+			continue;
+		}
+		const double compileSeconds = stopwatch.GetSeconds ();
+
+		stopwatch.Restart ();
+		for (UInt32 i = 0; i < RepeatCount; ++i) {
+			query.Evaluate (table, matches);
+		}
+		const double filterSeconds = stopwatch.GetSeconds () / RepeatCount;
+
+		UInt32 matchCount = 0;
+		for (UInt8 match : matches) {
+			matchCount += match;
+		}
+		WriteReport ("  %-58s %7u match(es), compiled in %.3f ms, filtered in %.3f ms",
+					 text, matchCount, compileSeconds * 1000.0, filterSeconds * 1000.0);
+	}
+}
+
+
+// -----------------------------------------------------------------------------
+// Tests
+// -----------------------------------------------------------------------------
+
+namespace {
+
+using PropertyTestQuery::Query;
+
+// The definitions and the values of six elements, '-' is not available:
+//	element		IntProp		Height	Label		Tags		Color	Notes
+//	0			50			2.5		"Label 7"	Apple;Pear	Red		Note 1;Note 3
+//	1			default		1.0		"B"			default		-		-
+//	2			10			-		-			Watermelon	-		-
+//	3			-			3.0		"Label 42"	(none)		-		-
+//	4			95			2.0		"x"			Pear;Apple	Green	-
+//	5			-			-		-			-			-		-
+// The default of IntProp is 7, the default of Tags is Pear. Flag, Odd (of
+// no value type) and the two Dup definitions have no values, they are there
+// for the errors.
+class TestTable
+{
+public:
+	TestTable ();
+
+	std::string		Match (const char* text) const;		// '1' for each matching element, '0' for the others
+	std::string		GetError (const char* text) const;	// the error message, empty if the query compiles
+
+private:
+	enum Column {
+		IntProp,
+		Height,
+		Label,
+		Tags,
+		Color,
+		Notes
+	};
+
+	void		AddDefinition (PropertyTestHelpers::IdGenerator& ids, const char* name, API_PropertyCollectionType collectionType, API_VariantType valueType);
+	void		AddEnumValue (PropertyTestHelpers::IdGenerator& ids, Column column, const char* text);
+	void		SetIntValue (UInt32 elemIndex, Column column, Int32 intValue);
+	void		SetRealValue (UInt32 elemIndex, Column column, double realValue);
+	void		SetStringValue (UInt32 elemIndex, Column column, const char* text);
+	void		SetEnumSet (UInt32 elemIndex, Column column, const char* firstText, const char* secondText);
+
+	GS::Array<API_PropertyDefinition>	definitions;
+	std::unique_ptr<ValueTable>			table;
+};
+
+
+TestTable::TestTable ()
+{
+	PropertyTestHelpers::IdGenerator ids (PropertyTestHelpers::BenchmarkSeed);
+
+	AddDefinition (ids, "IntProp", API_PropertySingleCollectionType, API_PropertyIntegerValueType);
+	AddDefinition (ids, "Height", API_PropertySingleCollectionType, API_PropertyRealValueType);
+	AddDefinition (ids, "Label", API_PropertySingleCollectionType, API_PropertyStringValueType);
+	AddDefinition (ids, "Tags", API_PropertyMultipleChoiceEnumerationCollectionType, API_PropertyStringValueType);
+	AddDefinition (ids, "Color", API_PropertySingleChoiceEnumerationCollectionType, API_PropertyStringValueType);
+	AddDefinition (ids, "Notes", API_PropertyListCollectionType, API_PropertyStringValueType);
+	AddDefinition (ids, "Flag", API_PropertySingleCollectionType, API_PropertyBooleanValueType);
+	AddDefinition (ids, "Odd", API_PropertySingleCollectionType, API_PropertyUndefinedValueType);
+	AddDefinition (ids, "Dup", API_PropertySingleCollectionType, API_PropertyIntegerValueType);
+	AddDefinition (ids, "Dup", API_PropertySingleCollectionType, API_PropertyIntegerValueType);
+
+	AddEnumValue (ids, Tags, "Apple");
+	AddEnumValue (ids, Tags, "Pear");
+	AddEnumValue (ids, Tags, "Watermelon");
+	AddEnumValue (ids, Color, "Red");
+	AddEnumValue (ids, Color, "Green");
+
+	definitions[IntProp].defaultValue.singleVariant.variant.intValue = 7;
+	definitions[Tags].defaultValue.multipleEnumVariant.variants.Push (definitions[Tags].possibleEnumValues[1]);
+
+	GS::Array<API_Guid> elemGuids;
+	ids.NextGuids (6, elemGuids);
+	table.reset (new ValueTable (PropertyTestHelpers::DefinitionTable (definitions), elemGuids));
+
+	SetIntValue (0, IntProp, 50);
+	table->SetValue (1, IntProp, true, definitions[IntProp].defaultValue);
+	SetIntValue (2, IntProp, 10);
+	SetIntValue (4, IntProp, 95);
+
+	SetRealValue (0, Height, 2.5);
+	SetRealValue (1, Height, 1.0);
+	SetRealValue (3, Height, 3.0);
+	SetRealValue (4, Height, 2.0);
+
+	SetStringValue (0, Label, "Label 7");
+	SetStringValue (1, Label, "B");
+	SetStringValue (3, Label, "Label 42");
+	SetStringValue (4, Label, "x");
+
+	SetEnumSet (0, Tags, "Apple", "Pear");
+	table->SetValue (1, Tags, true, definitions[Tags].defaultValue);
+	SetEnumSet (2, Tags, "Watermelon", nullptr);
+	SetEnumSet (3, Tags, nullptr, nullptr);
+	SetEnumSet (4, Tags, "Pear", "Apple");
+
+	API_PropertyValue colorValue;
+	colorValue.singleEnumVariant = definitions[Color].possibleEnumValues[0];
+	table->SetValue (0, Color, false, colorValue);
+	colorValue.singleEnumVariant = definitions[Color].possibleEnumValues[1];
+	table->SetValue (4, Color, false, colorValue);
+
+	API_PropertyValue notesValue;
+	API_Variant note;
+	note.type = API_PropertyStringValueType;
+	note.uniStringValue = "Note 1";
+	notesValue.listVariant.variants.Push (note);
+	note.uniStringValue = "Note 3";
+	notesValue.listVariant.variants.Push (note);
+	table->SetValue (0, Notes, false, notesValue);
+}
+
+
+std::string TestTable::Match (const char* text) const
+{
+	Query query;
+	std::string errorMessage;
+	if (!query.Compile (text, definitions, errorMessage)) {
+		return errorMessage;
+	}
+
+	std::vector<UInt8> matches;
+	query.Evaluate (*table, matches);
+	std::string result;
+	for (UInt8 match : matches) {
+		result.push_back ((match != 0) ? '1' : '0');
+	}
+	return result;
+}
+
+
+std::string TestTable::GetError (const char* text) const
+{
+	Query query;
+	std::string errorMessage;
+	query.Compile (text, definitions, errorMessage);
+	return errorMessage;
+}
+
+
+void TestTable::AddDefinition (PropertyTestHelpers::IdGenerator& ids, const char* name, API_PropertyCollectionType collectionType, API_VariantType valueType)
+{
+	definitions.Push (PropertyTestHelpers::CreateStandInDefinition (ids, name, collectionType, valueType));
+}
+
+
+void TestTable::AddEnumValue (PropertyTestHelpers::IdGenerator& ids, Column column, const char* text)
+{
+	API_SingleEnumerationVariant enumValue;
+	enumValue.guid = ids.NextGuid ();
+	enumValue.variant.type = API_PropertyStringValueType;
+	enumValue.variant.uniStringValue = text;
+	definitions[column].possibleEnumValues.Push (enumValue);
+}
+
+
+void TestTable::SetIntValue (UInt32 elemIndex, Column column, Int32 intValue)
+{
+	API_PropertyValue value;
+	value.singleVariant.variant.type = API_PropertyIntegerValueType;
+	value.singleVariant.variant.intValue = intValue;
+	table->SetValue (elemIndex, column, false, value);
+}
+
+
+void TestTable::SetRealValue (UInt32 elemIndex, Column column, double realValue)
+{
+	API_PropertyValue value;
+	value.singleVariant.variant.type = API_PropertyRealValueType;
+	value.singleVariant.variant.doubleValue = realValue;
+	table->SetValue (elemIndex, column, false, value);
+}
+
+
+void TestTable::SetStringValue (UInt32 elemIndex, Column column, const char* text)
+{
+	API_PropertyValue value;
+	value.singleVariant.variant.type = API_PropertyStringValueType;
+	value.singleVariant.variant.uniStringValue = text;
+	table->SetValue (elemIndex, column, false, value);
+}
+
+
+// The choices are found by their display text, nullptr is no choice
+void TestTable::SetEnumSet (UInt32 elemIndex, Column column, const char* firstText, const char* secondText)
+{
+	const PropertyTestHelpers::EnumIndex enumIndex (definitions[column]);
+	API_PropertyValue value;
+	for (const char* text : { firstText, secondText }) {
+		UInt32 ordinal = 0;
+		if (text != nullptr && enumIndex.FindByText (text, std::strlen (text), ordinal)) {
+			value.multipleEnumVariant.variants.Push (enumIndex.Get (ordinal));
+		}
+	}
+	table->SetValue (elemIndex, column, false, value);
+}
+
+
+GSErrCode TestQueryPrecedence ()
+{
+	const TestTable table;
+
+	// not binds the tightest, then and, then or
+	ASSERT (table.Match ("IntProp > 40 or IntProp < 20 and Height > 2") == "100010");
+	ASSERT (table.Match ("(IntProp > 40 or IntProp < 20) and Height > 2") == "100000");
+	ASSERT (table.Match ("not IntProp > 40 and Height > 2") == "000100");
+	ASSERT (table.Match ("not (IntProp > 40 and Height > 2)") == "011111");
+	ASSERT (table.Match ("not not IntProp > 40") == "100010");
+
+	// the keywords are case insensitive
+	ASSERT (table.Match ("NOT IntProp > 40 OR Label = \"x\"") == "011111");
+
+	return NoError;
+}
+
+
+GSErrCode TestQueryIsDefault ()
+{
+	const TestTable table;
+
+	ASSERT (table.Match ("IntProp isDefault") == "010000");
+	ASSERT (table.Match ("[Tags] ISDEFAULT") == "010000");
+	ASSERT (table.Match ("Height isDefault") == "000000");
+	ASSERT (table.Match ("not IntProp isDefault") == "101111");
+
+	return NoError;
+}
+
+
+// The elements with the default value are compared by the default value of the definition
+GSErrCode TestQueryDefaultValues ()
+{
+	const TestTable table;
+
+	ASSERT (table.Match ("IntProp = 7") == "010000");
+	ASSERT (table.Match ("IntProp < 20") == "011000");
+	ASSERT (table.Match ("IntProp != 7") == "101010");
+	ASSERT (table.Match ("Tags = \"Pear\"") == "010000");
+	ASSERT (table.Match ("Tags contains \"Pear\"") == "110010");
+
+	return NoError;
+}
+
+
+// A comparison is false for the elements the property is not available for,
+// even with !=; not negates the comparison, so it is true for them
+GSErrCode TestQueryNotAvailable ()
+{
+	const TestTable table;
+
+	ASSERT (table.Match ("IntProp != 50") == "011010");
+	ASSERT (table.Match ("Height > 0") == "110110");
+	ASSERT (table.Match ("Tags != \"Pear\"") == "101110");
+	ASSERT (table.Match ("Color != \"Red\"") == "000010");
+	ASSERT (table.Match ("not IntProp != 50") == "100101");
+
+	return NoError;
+}
+
+
+// An integer literal is compared as a real number to a real property, a real
+// literal to an integer property
+GSErrCode TestQueryNumberLiterals ()
+{
+	const TestTable table;
+
+	ASSERT (table.Match ("Height = 2") == "000010");
+	ASSERT (table.Match ("Height < 3") == "110010");
+	ASSERT (table.Match ("Height >= 2.5") == "100100");
+	ASSERT (table.Match ("Height = 25e-1") == "100000");
+	ASSERT (table.Match ("IntProp > 49.5") == "100010");
+	ASSERT (table.Match ("IntProp <= 10.0") == "011000");
+
+	return NoError;
+}
+
+
+// The values of a multiple choice enumeration are compared as sets of choices
+GSErrCode TestQueryEnumerations ()
+{
+	const TestTable table;
+
+	ASSERT (table.Match ("Tags = \"Pear;Apple\"") == "100010");
+	ASSERT (table.Match ("Tags = \"Apple;Pear\"") == "100010");
+	ASSERT (table.Match ("Tags = \"Apple\"") == "000000");
+	ASSERT (table.Match ("Tags = \"\"") == "000100");
+	ASSERT (table.Match ("Tags contains \"Apple;Pear\"") == "100010");
+	ASSERT (table.Match ("Tags contains \"Watermelon\"") == "001000");
+	ASSERT (table.Match ("Tags contains \"\"") == "111110");
+	ASSERT (table.Match ("Color = \"Red\"") == "100000");
+	ASSERT (table.Match ("Notes contains \"Note 3\"") == "100000");
+	ASSERT (table.Match ("Label contains \"7\"") == "100000");
+
+	return NoError;
+}
+
+
+// The first error is reported, at the position of the token it is found at
+GSErrCode TestQueryErrors ()
+{
+	const TestTable table;
+
+	// tokens
+	ASSERT (table.GetError ("") == "at 1: the query is empty");
+	ASSERT (table.GetError ("IntProp ! 3") == "at 9: '=' is expected after '!'");
+	ASSERT (table.GetError ("Label = \"abc") == "at 9: the string is not closed");
+	ASSERT (table.GetError ("[Int Prop = 3") == "at 1: the property name is not closed");
+	ASSERT (table.GetError ("[] = 3") == "at 1: the property name is empty");
+	ASSERT (table.GetError ("IntProp = 3x") == "at 12: unexpected character in a number");
+	ASSERT (table.GetError ("IntProp = 3 # 4") == "at 13: unexpected character '#'");
+
+	// grammar
+	ASSERT (table.GetError ("IntProp > 3 IntProp") == "at 13: 'and', 'or' or the end of the query is expected instead of IntProp");
+	ASSERT (table.GetError ("(IntProp > 3") == "at 13: ')' is expected at the end of the query");
+	ASSERT (table.GetError ("IntProp > 3 and") == "at 16: a property name is expected at the end of the query");
+	ASSERT (table.GetError ("= 3") == "at 1: a property name is expected instead of =");
+	ASSERT (table.GetError ("IntProp 3") == "at 9: an operator, 'contains' or 'isDefault' after IntProp is expected instead of 3");
+	ASSERT (table.GetError ("IntProp >") == "at 10: a value is expected at the end of the query");
+
+	// names
+	ASSERT (table.GetError ("Missing = 1") == "at 1: there is no property named Missing");
+	ASSERT (table.GetError ("Dup = 1") == "at 1: there are 2 properties named Dup");
+	ASSERT (table.GetError ("Missing = 1 or Dup = 1") == "at 1: there is no property named Missing");
+
+	// operators
+	ASSERT (table.GetError ("[Tags] < \"Pear\"") == "at 1: Tags is an enumeration, only = and != can be used on it");
+	ASSERT (table.GetError ("IntProp > 1 and Color >= \"Red\"") == "at 17: Color is an enumeration, only = and != can be used on it");
+	ASSERT (table.GetError ("Notes = \"a\"") == "at 1: Notes has more values, only 'contains' can be used on it");
+	ASSERT (table.GetError ("Flag > true") == "at 1: Flag is a boolean, only = and != can be used on it");
+	ASSERT (table.GetError ("IntProp contains 3") == "at 1: IntProp is not a string, a list or a multiple choice enumeration, 'contains' cannot be used on it");
+	ASSERT (table.GetError ("Color contains \"Red\"") == "at 1: Color has one value, use = instead of 'contains'");
+
+	// literals
+	ASSERT (table.GetError ("Tags = \"Banana\"") == "at 8: Tags has no value Banana");
+	ASSERT (table.GetError ("Tags = \"Apple;Banana\"") == "at 8: Tags has no value Banana");
+	ASSERT (table.GetError ("Color = \"Blue\"") == "at 9: Color has no value Blue");
+	ASSERT (table.GetError ("IntProp = 3000000000") == "at 11: 3000000000 is out of the range of IntProp");
+	ASSERT (table.GetError ("IntProp = \"a\"") == "at 11: IntProp is an integer, a number is expected");
+	ASSERT (table.GetError ("Height = true") == "at 10: Height is a real number, a number is expected");
+	ASSERT (table.GetError ("Label = 3") == "at 9: Label is a string, a quoted string is expected");
+	ASSERT (table.GetError ("Flag = 1") == "at 8: Flag is a boolean, true or false is expected");
+	ASSERT (table.GetError ("Odd = 1") == "at 1: the value type of Odd is not supported");
+
+	return NoError;
+}
+
+} // namespace
+
+
+void PropertyTestQuery::RegisterTests (PropertyTestHelpers::TestRegistry& registry)
+{
+	registry.Add ("TestQueryPrecedence", TestQueryPrecedence);
+	registry.Add ("TestQueryIsDefault", TestQueryIsDefault);
+	registry.Add ("TestQueryDefaultValues", TestQueryDefaultValues);
+	registry.Add ("TestQueryNotAvailable", TestQueryNotAvailable);
+	registry.Add ("TestQueryNumberLiterals", TestQueryNumberLiterals);
+	registry.Add ("TestQueryEnumerations", TestQueryEnumerations);
+	registry.Add ("TestQueryErrors", TestQueryErrors);
+}
@@ -0,0 +1,146 @@
+// *****************************************************************************
+// File:			Property_Test_Query.hpp
+// Description:		Property_Test add-on predicates over property values
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestQuery
+// Contact person:	CSAT
+// *****************************************************************************
+
+#if !defined (QUERY_HPP)
+#define	QUERY_HPP
+
+#include "Property_Test.hpp"
+#include "Property_Test_DefinitionTable.hpp"
+#include "Property_Test_EnumIndex.hpp"
+#include "Property_Test_Progress.hpp"
+#include "Property_Test_TestRunner.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace PropertyTestQuery
+{
+
+// -----------------------------------------------------------------------------
+// The values of some definitions for a list of elements, read once and kept
+// in one column per definition, so a query can be evaluated on them any
+// number of times without API calls
+// -----------------------------------------------------------------------------
+
+class ValueTable
+{
+public:
+	enum CellState {
+		NotAvailable	= 0,
+		DefaultValue	= 1,		// the value is the default value of the definition
+		CustomValue		= 2
+	};
+
+	// the values of a multiple choice enumeration are kept as sets of the
+	// ordinals of their choices, instead of API_PropertyValue
+	struct Column {
+		std::vector<UInt8>							states;		// CellState
+		std::vector<API_PropertyValue>				values;		// valid for the CustomValue cells only
+		std::vector<PropertyTestHelpers::EnumSet>	enumSets;	// the same for the multiple choice enumerations
+	};
+
+	ValueTable (const PropertyTestHelpers::DefinitionTable& definitionsToRead, const GS::Array<API_Guid>& elemGuids);
+
+	GSErrCode		Read (PropertyTestHelpers::Progress* progress);		// APIERR_CANCEL if canceled
+	void			SetValue (UInt32 elemIndex, UInt32 columnIndex, bool isDefault, const API_PropertyValue& value);
+
+	bool								FindColumn (const API_Guid& definitionGuid, UInt32& columnIndex) const;
+
+	UInt32								GetElementCount () const;
+	UInt32								GetColumnCount () const;
+	UInt32								GetValueCount () const;
+	const API_Guid&						GetElement (UInt32 elemIndex) const;
+	const API_PropertyDefinition&		GetDefinition (UInt32 columnIndex) const;
+	const Column&						GetColumn (UInt32 columnIndex) const;
+
+private:
+	bool								IsEnumSetColumn (UInt32 columnIndex) const;
+
+	PropertyTestHelpers::DefinitionTable		definitions;
+	GS::Array<API_Guid>							elements;
+	std::vector<Column>							columns;
+	std::vector<PropertyTestHelpers::EnumIndex>	enumIndices;		// per column, for the enumSets
+	UInt32										valueCount;
+};
+
+
+// -----------------------------------------------------------------------------
+// A predicate over the property values of an element, for example
+//	IntProp > 40
+//	Tags contains "Apple" and not [Fire Rating] isDefault
+// The grammar, from the lowest precedence:
+//	query		= and { "or" and }
+//	and			= unary { "and" unary }
+//	unary		= "not" unary | "(" query ")" | comparison
+//	comparison	= name ( operator literal | "contains" literal | "isDefault" )
+//	operator	= "=" | "!=" | "<" | "<=" | ">" | ">="
+//	literal		= "string" | integer | real | true | false
+// The keywords are case insensitive. The name of a property is an identifier
+// or any text in square brackets; it must identify one definition.
+// The text is compiled once: every comparison is resolved to its definition
+// and turned into an evaluator typed for its value and collection type, the
+// literal converted to the type of the property:
+//	- single values: every operator on numbers and strings, = and != on
+//	  booleans; "contains" searches a text in a string value
+//	- enumerations: = and != by the display text of the value; on multiple
+//	  choice ones the literal may list more texts separated by ; and is
+//	  compared as a set, whatever the order of the choices, "contains" tests
+//	  that every listed choice is set
+//	- lists: "contains" tests the items
+// The comparisons are false for the elements the property is not available
+// for. A query is evaluated on a whole ValueTable at once, column by column;
+// the table may have more columns than the definitions of the query.
+// -----------------------------------------------------------------------------
+
+class Node;
+
+class Query
+{
+public:
+	Query ();
+	~Query ();
+
+	bool		Compile (const char* text, const GS::Array<API_PropertyDefinition>& allDefinitions, std::string& errorMessage);
+
+	const PropertyTestHelpers::DefinitionTable&	GetDefinitions () const;	// the columns of the ValueTable to evaluate on, shared with it
+
+	void		Evaluate (const ValueTable& table, std::vector<UInt8>& matches) const;
+	void		Filter (const ValueTable& table, GS::Array<API_Guid>& matchingElements) const;
+
+private:
+	class Parser;
+
+	Query (const Query&);				// disabled
+	Query& operator= (const Query&);	// disabled
+
+	std::unique_ptr<Node>					root;
+	PropertyTestHelpers::DefinitionTable	definitions;
+};
+
+
+// -----------------------------------------------------------------------------
+// Measures the evaluation of some sample queries on elementCount elements
+// with stand-in definitions and generated values; nothing is read from the
+// model
+// -----------------------------------------------------------------------------
+
+void		RunBenchmark (UInt32 elementCount, const char* commandName);
+
+
+// -----------------------------------------------------------------------------
+// Adds the test cases of the query language to the registry: they compile
+// queries and evaluate them on a small ValueTable built by hand, so they
+// need no element and change nothing in the model
+// -----------------------------------------------------------------------------
+
+void		RegisterTests (PropertyTestHelpers::TestRegistry& registry);
+
+}
+
+#endif
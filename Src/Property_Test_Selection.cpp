@@ -0,0 +1,228 @@
+// *****************************************************************************
+// File:			Property_Test_Selection.cpp
+// Description:		Property_Test add-on programmatic element selection
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestHelpers
+// Contact person:	CSAT
+// *****************************************************************************
+
+#include "Property_Test_Selection.hpp"
+#include "Property_Test_Helpers.hpp"
+
+// Elements filtered between two checks of the cancel button
+static const UInt32 CancelCheckInterval = 1024;
+
+
+PropertyTestHelpers::SelectionBuilder::SelectionBuilder () :
+	filterClassification (false),
+	classificationGuid (APINULLGuid),
+	propertyDefinitionGuid (APINULLGuid),
+	filterFlags (APIFilt_None),
+	progress (nullptr)
+{
+}
+
+
+PropertyTestHelpers::SelectionBuilder& PropertyTestHelpers::SelectionBuilder::AddType (API_ElemTypeID typeID)
+{
+	if (!types.Contains (typeID)) {
+		types.Push (typeID);
+	}
+	return *this;
+}
+
+
+PropertyTestHelpers::SelectionBuilder& PropertyTestHelpers::SelectionBuilder::SetClassification (const API_ElemCategoryValue& classification)
+{
+	filterClassification = true;
+	classificationGuid = classification.guid;
+	return *this;
+}
+
+
+PropertyTestHelpers::SelectionBuilder& PropertyTestHelpers::SelectionBuilder::SetPropertyFilter (const API_Guid& definitionGuid, const PropertyPredicate& predicate)
+{
+	propertyDefinitionGuid = definitionGuid;
+	propertyPredicate = predicate;
+	return *this;
+}
+
+
+PropertyTestHelpers::SelectionBuilder& PropertyTestHelpers::SelectionBuilder::SetFilterFlags (API_ElemFilterFlags flags)
+{
+	filterFlags = flags;
+	return *this;
+}
+
+
+PropertyTestHelpers::SelectionBuilder& PropertyTestHelpers::SelectionBuilder::SetProgress (Progress* progressToReport)
+{
+	progress = progressToReport;
+	return *this;
+}
+
+
+GSErrCode PropertyTestHelpers::SelectionBuilder::Enumerate (const TypeCallback& callback) const
+{
+	GS::Array<API_ElemTypeID> typesToCollect = types;
+	if (typesToCollect.IsEmpty ()) {
+		for (Int32 typeID = API_WallID; typeID <= API_LastElemType; ++typeID) {
+			typesToCollect.Push (static_cast<API_ElemTypeID> (typeID));
+		}
+	}
+
+	// the classification category is fetched once, not once per element
+	API_ElemCategory classificationCategory;
+	if (filterClassification) {
+		GSErrCode error = GetElemClassificationCategory (classificationCategory);
+		if (error != NoError) {
+			return error;
+		}
+	}
+
+	GS::Array<API_Property> properties;
+	if (propertyPredicate) {
+		API_Property property;
+		property.definition.guid = propertyDefinitionGuid;
+		GSErrCode error = ACAPI_Property_GetPropertyDefinition (property.definition);
+		if (error != NoError) {
+			return error;
+		}
+		properties.Push (property);
+	}
+
+	// the element lists are fetched first, so the progress counts the elements
+	GS::Array<GS::Array<API_Guid>> elemLists;
+	elemLists.SetCapacity (typesToCollect.GetSize ());
+	UInt32 elementCount = 0;
+	for (UInt32 t = 0; t < typesToCollect.GetSize (); ++t) {
+		elemLists.Push (GS::Array<API_Guid> ());
+		if (ACAPI_Element_GetElemList (typesToCollect[t], &elemLists[t], filterFlags) != NoError) {
+			elemLists[t].Clear ();
+		}
+		elementCount += elemLists[t].GetSize ();
+	}
+
+	if (progress != nullptr) {
+		progress->SetItemCount (elementCount);
+	}
+
+	GS::Array<API_Guid> matchingList;
+	for (UInt32 t = 0; t < typesToCollect.GetSize (); ++t) {
+		if (progress != nullptr && progress->IsCanceled ()) {
+			return APIERR_CANCEL;
+		}
+
+		const GS::Array<API_Guid>& elemList = elemLists[t];
+		if (elemList.IsEmpty ()) {
+			continue;
+		}
+
+		if (!filterClassification && !propertyPredicate) {
+			callback (typesToCollect[t], elemList);
+			if (progress != nullptr) {
+				progress->Advance (elemList.GetSize ());
+			}
+			continue;
+		}
+
+		matchingList.Clear ();
+		matchingList.SetCapacity (elemList.GetSize ());
+		for (UInt32 i = 0; i < elemList.GetSize (); ++i) {
+			if (progress != nullptr) {
+				if (i % CancelCheckInterval == 0 && i > 0 && progress->IsCanceled ()) {
+					return APIERR_CANCEL;
+				}
+				progress->Advance ();
+			}
+
+			if (filterClassification) {
+				API_ElemCategoryValue catValue;
+				if (ACAPI_Element_GetCategoryValue (elemList[i], classificationCategory, &catValue) != NoError ||
+					catValue.guid != classificationGuid) {
+					continue;
+				}
+			}
+
+			if (propertyPredicate) {
+				// APIERR_BADPROPERTYFORELEM just means that the property is not available for the elem
+				if (ACAPI_Element_GetProperties (elemList[i], properties) != NoError || !propertyPredicate (properties[0])) {
+					continue;
+				}
+			}
+
+			matchingList.Push (elemList[i]);
+		}
+
+		if (!matchingList.IsEmpty ()) {
+			callback (typesToCollect[t], matchingList);
+		}
+	}
+
+	return NoError;
+}
+
+
+GSErrCode PropertyTestHelpers::SelectionBuilder::Collect (GS::Array<API_Guid>& result) const
+{
+	return Enumerate ([&] (API_ElemTypeID, const GS::Array<API_Guid>& guids) {
+		result.SetCapacity (result.GetSize () + guids.GetSize ());
+		for (UInt32 i = 0; i < guids.GetSize (); ++i) {
+			result.Push (guids[i]);
+		}
+	});
+}
+
+
+static GSErrCode SelectNeigs (const GS::Array<API_Neig>& neigs, bool addToSelection, UInt32* nSelected)
+{
+	if (nSelected != nullptr) {
+		*nSelected = neigs.GetSize ();
+	}
+
+	if (!addToSelection) {
+		GSErrCode error = ACAPI_Element_DeselectAll ();
+		if (error != NoError) {
+			return error;
+		}
+	}
+
+	if (neigs.IsEmpty ()) {
+		return NoError;
+	}
+
+	return ACAPI_Element_Select (neigs, true);
+}
+
+
+GSErrCode PropertyTestHelpers::SelectionBuilder::Select (bool addToSelection /* = false*/, UInt32* nSelected /* = nullptr*/) const
+{
+	GS::Array<API_Neig> neigs;
+	GSErrCode error = Enumerate ([&] (API_ElemTypeID typeID, const GS::Array<API_Guid>& guids) {
+		ElemGuids_To_Neigs (neigs, typeID, guids);
+	});
+	if (error != NoError) {
+		return error;
+	}
+
+	return SelectNeigs (neigs, addToSelection, nSelected);
+}
+
+
+GSErrCode PropertyTestHelpers::SelectElements (const GS::Array<API_Guid>& elemGuids, bool addToSelection /* = false*/, UInt32* nSelected /* = nullptr*/)
+{
+	// headers with the guid only: ElemHeads_To_Neigs reads the element types
+	GS::Array<API_Elem_Head> elemHeads;
+	elemHeads.SetCapacity (elemGuids.GetSize ());
+	for (UInt32 i = 0; i < elemGuids.GetSize (); ++i) {
+		API_Elem_Head elemHead;
+		BNZeroMemory (&elemHead, sizeof (API_Elem_Head));
+		elemHead.guid = elemGuids[i];
+		elemHeads.Push (elemHead);
+	}
+
+	GS::Array<API_Neig> neigs;
+	ElemHeads_To_Neigs (neigs, elemHeads);
+
+	return SelectNeigs (neigs, addToSelection, nSelected);
+}
@@ -0,0 +1,68 @@
+// *****************************************************************************
+// File:			Property_Test_Selection.hpp
+// Description:		Property_Test add-on programmatic element selection
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestHelpers
+// Contact person:	CSAT
+// *****************************************************************************
+
+#if !defined (SELECTION_HPP)
+#define	SELECTION_HPP
+
+#include "Property_Test.hpp"
+#include "Property_Test_Progress.hpp"
+
+#include <functional>
+
+namespace PropertyTestHelpers
+{
+
+// -----------------------------------------------------------------------------
+// Collects the elements of the project that match every given criterion:
+//	- element type (no type given: all types)
+//	- classification (the API_ElemCategory_ElementClassification value)
+//	- a predicate on the value of one property
+// The result can be pushed back as the current selection in one batch.
+// -----------------------------------------------------------------------------
+
+class SelectionBuilder
+{
+public:
+	typedef std::function<bool (const API_Property&)>	PropertyPredicate;
+
+	SelectionBuilder ();
+
+	SelectionBuilder&	AddType (API_ElemTypeID typeID);
+	SelectionBuilder&	SetClassification (const API_ElemCategoryValue& classification);
+	SelectionBuilder&	SetPropertyFilter (const API_Guid& definitionGuid, const PropertyPredicate& predicate);
+	SelectionBuilder&	SetFilterFlags (API_ElemFilterFlags filterFlags);
+	SelectionBuilder&	SetProgress (Progress* progressToReport);		// counts the elements; APIERR_CANCEL if canceled
+
+	GSErrCode			Collect (GS::Array<API_Guid>& result) const;
+	GSErrCode			Select (bool addToSelection = false, UInt32* nSelected = nullptr) const;
+
+private:
+	typedef std::function<void (API_ElemTypeID, const GS::Array<API_Guid>&)>	TypeCallback;
+
+	GSErrCode			Enumerate (const TypeCallback& callback) const;
+
+	GS::Array<API_ElemTypeID>	types;
+	bool						filterClassification;
+	API_Guid					classificationGuid;
+	API_Guid					propertyDefinitionGuid;
+	PropertyPredicate			propertyPredicate;
+	API_ElemFilterFlags			filterFlags;
+	Progress*					progress;
+};
+
+
+// -----------------------------------------------------------------------------
+// Selects a list of elements of any types in one batch; the elements that
+// cannot be selected are skipped
+// -----------------------------------------------------------------------------
+
+GSErrCode	SelectElements (const GS::Array<API_Guid>& elemGuids, bool addToSelection = false, UInt32* nSelected = nullptr);
+
+}
+
+#endif
@@ -0,0 +1,701 @@
+// *****************************************************************************
+// File:			Property_Test_Snapshot.cpp
+// Description:		Property_Test add-on binary property snapshot
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestSnapshot
+// Contact person:	CSAT
+// *****************************************************************************
+
+#include "Property_Test_Snapshot.hpp"
+#include "Property_Test_Helpers.hpp"
+#include "Property_Test_Selection.hpp"
+
+#include "File.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+// Elements read between two checks of the cancel button
+static const UInt32 CancelCheckInterval = 256;
+
+
+static UInt64 AlignUp (UInt64 offset)
+{
+	return (offset + 7) & ~static_cast<UInt64> (7);
+}
+
+
+bool PropertyTestSnapshot::GuidLess (const API_Guid& lhs, const API_Guid& rhs)
+{
+	return std::memcmp (&lhs, &rhs, sizeof (API_Guid)) < 0;
+}
+
+
+// -----------------------------------------------------------------------------
+// SnapshotView
+// -----------------------------------------------------------------------------
+
+PropertyTestSnapshot::SnapshotView::SnapshotView (const void* fileData, UInt64 fileSize) :
+	data (static_cast<const char*> (fileData)),
+	size (fileSize),
+	header (fileSize >= sizeof (FileHeader) ? static_cast<const FileHeader*> (fileData) : nullptr)
+{
+}
+
+
+template<typename Type>
+const Type* PropertyTestSnapshot::SnapshotView::At (UInt64 offset) const
+{
+	return reinterpret_cast<const Type*> (data + offset);
+}
+
+
+static bool IsTableInside (UInt64 offset, UInt64 count, UInt64 recordSize, UInt64 fileSize)
+{
+	return offset % 8 == 0 && offset <= fileSize && count * recordSize <= fileSize - offset;
+}
+
+
+bool PropertyTestSnapshot::SnapshotView::IsValid () const
+{
+	if (header == nullptr || std::memcmp (header->magic, FileMagic, sizeof (FileMagic)) != 0 ||
+		header->version != FileVersion || header->headerSize != sizeof (FileHeader) || header->fileSize > size) {
+		return false;
+	}
+
+	return AreTablesInside () && AreStringsValid () && AreIndicesValid ();
+}
+
+
+bool PropertyTestSnapshot::SnapshotView::AreTablesInside () const
+{
+	const UInt64 fileSize = header->fileSize;
+	return IsTableInside (header->elementsOffset, header->elementCount, sizeof (API_Guid), fileSize) &&
+		   IsTableInside (header->definitionsOffset, header->definitionCount, sizeof (DefinitionRecord), fileSize) &&
+		   IsTableInside (header->enumValuesOffset, header->enumValueCount, sizeof (EnumValueRecord), fileSize) &&
+		   IsTableInside (header->stringOffsetsOffset, header->stringCount, sizeof (UInt32), fileSize) &&
+		   IsTableInside (header->valueElemsOffset, header->valueCount, sizeof (UInt32), fileSize) &&
+		   IsTableInside (header->valueDataOffset, header->valueCount, sizeof (UInt64), fileSize) &&
+		   IsTableInside (header->valueFlagsOffset, header->valueCount, sizeof (UInt8), fileSize) &&
+		   IsTableInside (header->listItemsOffset, header->listItemCount, sizeof (UInt64), fileSize) &&
+		   header->stringDataOffset <= fileSize;
+}
+
+
+// Every string starts in the string data and is terminated in the file: the
+// last byte of the file is a zero, so no string can run past it
+bool PropertyTestSnapshot::SnapshotView::AreStringsValid () const
+{
+	if (header->stringCount == 0) {
+		return true;
+	}
+
+	const UInt64 stringDataSize = header->fileSize - header->stringDataOffset;
+	if (stringDataSize == 0 || data[header->fileSize - 1] != '\0') {
+		return false;
+	}
+
+	const UInt32* stringOffsets = At<UInt32> (header->stringOffsetsOffset);
+	for (UInt32 i = 0; i < header->stringCount; ++i) {
+		if (stringOffsets[i] >= stringDataSize) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+// The value data of a list or a multiple choice enumeration: first list item | item count << 32;
+// with areItemsIndices the items must be below itemLimit
+bool PropertyTestSnapshot::SnapshotView::IsListRangeValid (UInt64 valueData, bool areItemsIndices, UInt32 itemLimit) const
+{
+	const UInt64 firstItem = valueData & 0xFFFFFFFF;
+	const UInt64 itemCount = valueData >> 32;
+	if (firstItem + itemCount > header->listItemCount) {
+		return false;
+	}
+
+	if (!areItemsIndices) {
+		return true;
+	}
+
+	const UInt64* items = At<UInt64> (header->listItemsOffset) + firstItem;
+	for (UInt64 i = 0; i < itemCount; ++i) {
+		if (items[i] >= itemLimit) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+bool PropertyTestSnapshot::SnapshotView::AreIndicesValid () const
+{
+	const EnumValueRecord* enumValues = At<EnumValueRecord> (header->enumValuesOffset);
+	for (UInt32 i = 0; i < header->enumValueCount; ++i) {
+		if (enumValues[i].definitionIndex >= header->definitionCount || enumValues[i].displayName >= header->stringCount) {
+			return false;
+		}
+	}
+
+	const UInt32* valueElems = At<UInt32> (header->valueElemsOffset);
+	for (UInt32 i = 0; i < header->valueCount; ++i) {
+		if (valueElems[i] >= header->elementCount) {
+			return false;
+		}
+	}
+
+	// the values are checked by the collection type of their definition; the
+	// items of a list are checked as strings only for string definitions,
+	// the other encoded variants have no index to check
+	const DefinitionRecord* definitions = At<DefinitionRecord> (header->definitionsOffset);
+	const UInt64* valueData = At<UInt64> (header->valueDataOffset);
+	for (UInt32 d = 0; d < header->definitionCount; ++d) {
+		const DefinitionRecord& definition = definitions[d];
+		if (definition.name >= header->stringCount ||
+			static_cast<UInt64> (definition.firstValue) + definition.valueCount > header->valueCount) {
+			return false;
+		}
+
+		const bool isString = definition.valueType == API_PropertyStringValueType;
+		for (UInt32 i = definition.firstValue; i < definition.firstValue + definition.valueCount; ++i) {
+			bool isValueValid = true;
+			switch (definition.collectionType) {
+				case API_PropertySingleCollectionType:
+					isValueValid = !isString || valueData[i] < header->stringCount;
+					break;
+				case API_PropertyListCollectionType:
+					isValueValid = IsListRangeValid (valueData[i], isString, header->stringCount);
+					break;
+				case API_PropertySingleChoiceEnumerationCollectionType:
+					isValueValid = valueData[i] < header->enumValueCount;
+					break;
+				case API_PropertyMultipleChoiceEnumerationCollectionType:
+					isValueValid = IsListRangeValid (valueData[i], true, header->enumValueCount);
+					break;
+				default:
+					break;
+			}
+			if (!isValueValid) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+
+UInt32 PropertyTestSnapshot::SnapshotView::GetElementCount () const
+{
+	return header->elementCount;
+}
+
+
+const API_Guid& PropertyTestSnapshot::SnapshotView::GetElement (UInt32 elemIndex) const
+{
+	return At<API_Guid> (header->elementsOffset)[elemIndex];
+}
+
+
+bool PropertyTestSnapshot::SnapshotView::FindElement (const API_Guid& elemGuid, UInt32& elemIndex) const
+{
+	const API_Guid* begin = At<API_Guid> (header->elementsOffset);
+	const API_Guid* end = begin + header->elementCount;
+	const API_Guid* it = std::lower_bound (begin, end, elemGuid, GuidLess);
+	if (it == end || *it != elemGuid) {
+		return false;
+	}
+
+	elemIndex = static_cast<UInt32> (it - begin);
+	return true;
+}
+
+
+UInt32 PropertyTestSnapshot::SnapshotView::GetDefinitionCount () const
+{
+	return header->definitionCount;
+}
+
+
+const PropertyTestSnapshot::DefinitionRecord& PropertyTestSnapshot::SnapshotView::GetDefinition (UInt32 definitionIndex) const
+{
+	return At<DefinitionRecord> (header->definitionsOffset)[definitionIndex];
+}
+
+
+bool PropertyTestSnapshot::SnapshotView::FindDefinition (const API_Guid& definitionGuid, UInt32& definitionIndex) const
+{
+	const DefinitionRecord* begin = At<DefinitionRecord> (header->definitionsOffset);
+	const DefinitionRecord* end = begin + header->definitionCount;
+	const DefinitionRecord* it = std::lower_bound (begin, end, definitionGuid,
+		[] (const DefinitionRecord& record, const API_Guid& guid) { return GuidLess (record.guid, guid); });
+	if (it == end || it->guid != definitionGuid) {
+		return false;
+	}
+
+	definitionIndex = static_cast<UInt32> (it - begin);
+	return true;
+}
+
+
+UInt32 PropertyTestSnapshot::SnapshotView::GetEnumValueCount () const
+{
+	return header->enumValueCount;
+}
+
+
+const PropertyTestSnapshot::EnumValueRecord& PropertyTestSnapshot::SnapshotView::GetEnumValue (UInt32 enumValueIndex) const
+{
+	return At<EnumValueRecord> (header->enumValuesOffset)[enumValueIndex];
+}
+
+
+UInt32 PropertyTestSnapshot::SnapshotView::GetStringCount () const
+{
+	return header->stringCount;
+}
+
+
+const char* PropertyTestSnapshot::SnapshotView::GetString (UInt32 stringIndex) const
+{
+	return At<char> (header->stringDataOffset) + At<UInt32> (header->stringOffsetsOffset)[stringIndex];
+}
+
+
+UInt32 PropertyTestSnapshot::SnapshotView::GetValueCount () const
+{
+	return header->valueCount;
+}
+
+
+const UInt32* PropertyTestSnapshot::SnapshotView::GetValueElems () const
+{
+	return At<UInt32> (header->valueElemsOffset);
+}
+
+
+const UInt64* PropertyTestSnapshot::SnapshotView::GetValueData () const
+{
+	return At<UInt64> (header->valueDataOffset);
+}
+
+
+const UInt8* PropertyTestSnapshot::SnapshotView::GetValueFlags () const
+{
+	return At<UInt8> (header->valueFlagsOffset);
+}
+
+
+UInt32 PropertyTestSnapshot::SnapshotView::GetListItemCount () const
+{
+	return header->listItemCount;
+}
+
+
+const UInt64* PropertyTestSnapshot::SnapshotView::GetListItems () const
+{
+	return At<UInt64> (header->listItemsOffset);
+}
+
+
+// -----------------------------------------------------------------------------
+// SnapshotWriter
+// -----------------------------------------------------------------------------
+
+PropertyTestSnapshot::SnapshotWriter::SnapshotWriter ()
+{
+	InternString (GS::UniString ());
+}
+
+
+void PropertyTestSnapshot::SnapshotWriter::AddElement (const API_Guid& elemGuid, const GS::Array<API_Property>& properties)
+{
+	RawElement element;
+	element.guid = elemGuid;
+	element.firstValue = static_cast<UInt32> (values.size ());
+	element.valueCount = properties.GetSize ();
+	elements.push_back (element);
+
+	for (UInt32 i = 0; i < properties.GetSize (); ++i) {
+		RawValue value;
+		value.definitionIndex = GetDefinitionIndex (properties[i].definition);
+		value.flags = properties[i].isDefault ? ValueIsDefault : 0;
+		value.data = EncodeValue (properties[i], value.definitionIndex);
+		values.push_back (value);
+	}
+}
+
+
+UInt32 PropertyTestSnapshot::SnapshotWriter::GetElementCount () const
+{
+	return static_cast<UInt32> (elements.size ());
+}
+
+
+UInt32 PropertyTestSnapshot::SnapshotWriter::GetValueCount () const
+{
+	return static_cast<UInt32> (values.size ());
+}
+
+
+UInt32 PropertyTestSnapshot::SnapshotWriter::GetDefinitionIndex (const API_PropertyDefinition& definition)
+{
+	auto it = definitionIndices.find (definition.guid);
+	if (it != definitionIndices.end ()) {
+		return it->second;
+	}
+
+	DefinitionRecord record;
+	record.guid = definition.guid;
+	record.groupGuid = definition.groupGuid;
+	record.name = InternString (definition.name);
+	record.collectionType = static_cast<UInt32> (definition.collectionType);
+	record.valueType = static_cast<UInt32> (definition.valueType);
+	record.firstValue = 0;
+	record.valueCount = 0;
+	record.reserved = 0;
+
+	const UInt32 definitionIndex = static_cast<UInt32> (definitions.size ());
+	definitions.push_back (record);
+	definitionIndices.emplace (definition.guid, definitionIndex);
+	return definitionIndex;
+}
+
+
+UInt32 PropertyTestSnapshot::SnapshotWriter::GetEnumValueIndex (const API_Guid& enumGuid, const API_PropertyDefinition& definition, UInt32 definitionIndex)
+{
+	auto it = enumValueIndices.find (enumGuid);
+	if (it != enumValueIndices.end ()) {
+		return it->second;
+	}
+
+	EnumValueRecord record;
+	record.guid = enumGuid;
+	record.definitionIndex = definitionIndex;
+	record.displayName = 0;
+	for (UInt32 i = 0; i < definition.possibleEnumValues.GetSize (); ++i) {
+		if (definition.possibleEnumValues[i].guid == enumGuid) {
+			record.displayName = InternString (PropertyTestHelpers::ToString (definition.possibleEnumValues[i].variant));
+			break;
+		}
+	}
+
+	const UInt32 enumValueIndex = static_cast<UInt32> (enumValues.size ());
+	enumValues.push_back (record);
+	enumValueIndices.emplace (enumGuid, enumValueIndex);
+	return enumValueIndex;
+}
+
+
+UInt32 PropertyTestSnapshot::SnapshotWriter::InternString (const GS::UniString& string)
+{
+	std::string utf8 (string.ToCStr (CC_UTF8).Get ());
+	auto it = stringIndices.find (utf8);
+	if (it != stringIndices.end ()) {
+		return it->second;
+	}
+
+	const UInt32 stringIndex = static_cast<UInt32> (stringOffsets.size ());
+	stringOffsets.push_back (static_cast<UInt32> (stringData.size ()));
+	stringData.insert (stringData.end (), utf8.begin (), utf8.end ());
+	stringData.push_back ('\0');
+	stringIndices.emplace (std::move (utf8), stringIndex);
+	return stringIndex;
+}
+
+
+UInt64 PropertyTestSnapshot::SnapshotWriter::EncodeVariant (const API_Variant& variant)
+{
+	switch (variant.type) {
+		case API_PropertyIntegerValueType:
+			return static_cast<UInt64> (static_cast<Int64> (variant.intValue));
+		case API_PropertyRealValueType: {
+			UInt64 bits;
+			std::memcpy (&bits, &variant.doubleValue, sizeof (bits));
+			return bits;
+		}
+		case API_PropertyStringValueType:
+			return InternString (variant.uniStringValue);
+		case API_PropertyBooleanValueType:
+			return variant.boolValue ? 1 : 0;
+		default:
+			return 0;
+	}
+}
+
+
+// A default value is stored as the default of the definition (the value of such a property is not
+// guaranteed to be filled in), and keeps its ValueIsDefault flag
+UInt64 PropertyTestSnapshot::SnapshotWriter::EncodeValue (const API_Property& property, UInt32 definitionIndex)
+{
+	const API_PropertyValue& value = property.isDefault ? property.definition.defaultValue : property.value;
+	const UInt64 firstItem = listItems.size ();
+	switch (property.definition.collectionType) {
+		case API_PropertySingleCollectionType:
+			return EncodeVariant (value.singleVariant.variant);
+		case API_PropertyListCollectionType:
+			for (UInt32 i = 0; i < value.listVariant.variants.GetSize (); ++i) {
+				listItems.push_back (EncodeVariant (value.listVariant.variants[i]));
+			}
+			return firstItem | (static_cast<UInt64> (value.listVariant.variants.GetSize ()) << 32);
+		case API_PropertySingleChoiceEnumerationCollectionType:
+			return GetEnumValueIndex (value.singleEnumVariant.guid, property.definition, definitionIndex);
+		case API_PropertyMultipleChoiceEnumerationCollectionType:
+			for (UInt32 i = 0; i < value.multipleEnumVariant.variants.GetSize (); ++i) {
+				listItems.push_back (GetEnumValueIndex (value.multipleEnumVariant.variants[i].guid, property.definition, definitionIndex));
+			}
+			return firstItem | (static_cast<UInt64> (value.multipleEnumVariant.variants.GetSize ()) << 32);
+		default:
+			return 0;
+	}
+}
+
+
+template<typename Type>
+static void CopyTable (std::vector<char>& file, UInt64 offset, const std::vector<Type>& table)
+{
+	if (!table.empty ()) {
+		std::memcpy (file.data () + offset, table.data (), table.size () * sizeof (Type));
+	}
+}
+
+
+void PropertyTestSnapshot::SnapshotWriter::Build (std::vector<char>& file) const
+{
+	// the elements and the definitions are sorted by guid, so a reader can
+	// binary search them and two snapshots can be merged without sorting
+	std::vector<UInt32> elemOrder (elements.size ());
+	for (UInt32 i = 0; i < elemOrder.size (); ++i) {
+		elemOrder[i] = i;
+	}
+	std::sort (elemOrder.begin (), elemOrder.end (), [this] (UInt32 lhs, UInt32 rhs) {
+		return GuidLess (elements[lhs].guid, elements[rhs].guid);
+	});
+
+	std::vector<UInt32> definitionOrder (definitions.size ());
+	for (UInt32 i = 0; i < definitionOrder.size (); ++i) {
+		definitionOrder[i] = i;
+	}
+	std::sort (definitionOrder.begin (), definitionOrder.end (), [this] (UInt32 lhs, UInt32 rhs) {
+		return GuidLess (definitions[lhs].guid, definitions[rhs].guid);
+	});
+
+	std::vector<UInt32> definitionRank (definitions.size ());
+	for (UInt32 i = 0; i < definitionOrder.size (); ++i) {
+		definitionRank[definitionOrder[i]] = i;
+	}
+
+	// counting sort of the values by definition, the elements are visited in
+	// their sorted order, so the values of a definition are sorted by element
+	std::vector<DefinitionRecord> sortedDefinitions (definitions.size ());
+	for (UInt32 i = 0; i < definitionOrder.size (); ++i) {
+		sortedDefinitions[i] = definitions[definitionOrder[i]];
+	}
+	for (const RawValue& value : values) {
+		++sortedDefinitions[definitionRank[value.definitionIndex]].valueCount;
+	}
+	UInt32 firstValue = 0;
+	for (DefinitionRecord& record : sortedDefinitions) {
+		record.firstValue = firstValue;
+		firstValue += record.valueCount;
+	}
+
+	std::vector<UInt32> valueElems (values.size ());
+	std::vector<UInt64> valueData (values.size ());
+	std::vector<UInt8>  valueFlags (values.size ());
+	std::vector<UInt32> nextSlot (sortedDefinitions.size ());
+	for (UInt32 i = 0; i < sortedDefinitions.size (); ++i) {
+		nextSlot[i] = sortedDefinitions[i].firstValue;
+	}
+
+	std::vector<API_Guid> sortedElements (elements.size ());
+	for (UInt32 elemIndex = 0; elemIndex < elemOrder.size (); ++elemIndex) {
+		const RawElement& element = elements[elemOrder[elemIndex]];
+		sortedElements[elemIndex] = element.guid;
+		for (UInt32 i = element.firstValue; i < element.firstValue + element.valueCount; ++i) {
+			const UInt32 slot = nextSlot[definitionRank[values[i].definitionIndex]]++;
+			valueElems[slot] = elemIndex;
+			valueData[slot] = values[i].data;
+			valueFlags[slot] = values[i].flags;
+		}
+	}
+
+	std::vector<EnumValueRecord> sortedEnumValues (enumValues);
+	for (EnumValueRecord& record : sortedEnumValues) {
+		record.definitionIndex = definitionRank[record.definitionIndex];
+	}
+
+	// layout
+	FileHeader header;
+	BNZeroMemory (&header, sizeof (FileHeader));
+	std::memcpy (header.magic, FileMagic, sizeof (FileMagic));
+	header.version = FileVersion;
+	header.headerSize = sizeof (FileHeader);
+	header.elementCount = static_cast<UInt32> (sortedElements.size ());
+	header.definitionCount = static_cast<UInt32> (sortedDefinitions.size ());
+	header.enumValueCount = static_cast<UInt32> (sortedEnumValues.size ());
+	header.stringCount = static_cast<UInt32> (stringOffsets.size ());
+	header.valueCount = static_cast<UInt32> (values.size ());
+	header.listItemCount = static_cast<UInt32> (listItems.size ());
+
+	UInt64 offset = AlignUp (sizeof (FileHeader));
+	auto Place = [&offset] (UInt64 byteCount) -> UInt64 {
+		const UInt64 start = offset;
+		offset = AlignUp (offset + byteCount);
+		return start;
+	};
+	header.elementsOffset		= Place (sortedElements.size () * sizeof (API_Guid));
+	header.definitionsOffset	= Place (sortedDefinitions.size () * sizeof (DefinitionRecord));
+	header.enumValuesOffset		= Place (sortedEnumValues.size () * sizeof (EnumValueRecord));
+	header.valueDataOffset		= Place (valueData.size () * sizeof (UInt64));
+	header.listItemsOffset		= Place (listItems.size () * sizeof (UInt64));
+	header.valueElemsOffset		= Place (valueElems.size () * sizeof (UInt32));
+	header.stringOffsetsOffset	= Place (stringOffsets.size () * sizeof (UInt32));
+	header.valueFlagsOffset		= Place (valueFlags.size () * sizeof (UInt8));
+	header.stringDataOffset		= Place (stringData.size ());
+	header.fileSize = offset;
+
+	file.assign (static_cast<size_t> (header.fileSize), 0);
+	std::memcpy (file.data (), &header, sizeof (FileHeader));
+	CopyTable (file, header.elementsOffset, sortedElements);
+	CopyTable (file, header.definitionsOffset, sortedDefinitions);
+	CopyTable (file, header.enumValuesOffset, sortedEnumValues);
+	CopyTable (file, header.valueDataOffset, valueData);
+	CopyTable (file, header.listItemsOffset, listItems);
+	CopyTable (file, header.valueElemsOffset, valueElems);
+	CopyTable (file, header.stringOffsetsOffset, stringOffsets);
+	CopyTable (file, header.valueFlagsOffset, valueFlags);
+	CopyTable (file, header.stringDataOffset, stringData);
+}
+
+
+// -----------------------------------------------------------------------------
+// Project level functions
+// -----------------------------------------------------------------------------
+
+GSErrCode PropertyTestSnapshot::CollectProject (SnapshotWriter& writer, PropertyTestHelpers::Progress* progress)
+{
+	GS::Array<API_Guid> elemGuids;
+	GSErrCode error = PropertyTestHelpers::SelectionBuilder ().Collect (elemGuids);
+	if (error != NoError) {
+		return error;
+	}
+
+	if (progress != nullptr) {
+		progress->SetItemCount (elemGuids.GetSize ());
+	}
+
+	GS::Array<API_PropertyDefinition> definitions;
+	GS::Array<API_Property> properties;
+	for (UInt32 i = 0; i < elemGuids.GetSize (); ++i) {
+		if (progress != nullptr && i % CancelCheckInterval == 0 && progress->IsCanceled ()) {
+			return APIERR_CANCEL;
+		}
+
+		definitions.Clear ();
+		if (COLLECT_ERROR (ACAPI_Element_GetPropertyDefinitions (elemGuids[i], definitions)) != NoError) {
+			continue;
+		}
+
+		// the requests have the guids only, the definitions are filled in by the API
+		properties.Clear ();
+		properties.SetCapacity (definitions.GetSize ());
+		for (UInt32 d = 0; d < definitions.GetSize (); ++d) {
+			API_Property property;
+			property.definition.guid = definitions[d].guid;
+			properties.Push (property);
+		}
+		if (!properties.IsEmpty () && COLLECT_ERROR (ACAPI_Element_GetProperties (elemGuids[i], properties)) != NoError) {
+			continue;
+		}
+
+		writer.AddElement (elemGuids[i], properties);
+		if (progress != nullptr) {
+			progress->Advance ();
+		}
+	}
+
+	return NoError;
+}
+
+
+GSErrCode PropertyTestSnapshot::GetProjectFileLocation (const GS::UniString& suffix, IO::Location& location)
+{
+	API_ProjectInfo projectInfo;
+	BNZeroMemory (&projectInfo, sizeof (API_ProjectInfo));
+	GSErrCode error = ACAPI_Environment (APIEnv_ProjectID, &projectInfo, nullptr);
+	if (error != NoError) {
+		return error;
+	}
+
+	if (projectInfo.untitled || projectInfo.location == nullptr || projectInfo.projectName == nullptr) {
+		error = APIERR_NOPLAN;
+	} else {
+		location = *projectInfo.location;
+		location.DeleteLastLocalName ();
+		location.AppendToLocal (IO::Name (*projectInfo.projectName + suffix));
+	}
+
+	delete projectInfo.location;
+	delete projectInfo.location_team;
+	delete projectInfo.projectPath;
+	delete projectInfo.projectName;
+
+	return error;
+}
+
+
+GSErrCode PropertyTestSnapshot::GetSnapshotLocations (IO::Location& current, IO::Location& previous)
+{
+	GSErrCode error = GetProjectFileLocation (".ptsnap", current);
+	if (error != NoError) {
+		return error;
+	}
+	return GetProjectFileLocation (".prev.ptsnap", previous);
+}
+
+
+GSErrCode PropertyTestSnapshot::SaveFile (const IO::Location& location, const std::vector<char>& file)
+{
+	IO::File output (location, IO::File::Create);
+	GSErrCode error = output.GetStatus ();
+	if (error != NoError) {
+		return error;
+	}
+
+	error = output.Open (IO::File::WriteEmptyMode);
+	if (error != NoError) {
+		return error;
+	}
+
+	error = output.WriteBin (file.data (), static_cast<USize> (file.size ()));
+	GSErrCode closeError = output.Close ();
+
+	return (error != NoError) ? error : closeError;
+}
+
+
+GSErrCode PropertyTestSnapshot::LoadFile (const IO::Location& location, std::vector<char>& file)
+{
+	IO::File input (location);
+	GSErrCode error = input.GetStatus ();
+	if (error != NoError) {
+		return error;
+	}
+
+	error = input.Open (IO::File::ReadMode);
+	if (error != NoError) {
+		return error;
+	}
+
+	UInt64 length = 0;
+	error = input.GetDataLength (&length);
+	if (error == NoError) {
+		file.resize (static_cast<size_t> (length));
+		error = input.ReadBin (file.data (), static_cast<USize> (length));
+	}
+	GSErrCode closeError = input.Close ();
+
+	return (error != NoError) ? error : closeError;
+}
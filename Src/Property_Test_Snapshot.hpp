@@ -0,0 +1,234 @@
+// *****************************************************************************
+// File:			Property_Test_Snapshot.hpp
+// Description:		Property_Test add-on binary property snapshot
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestSnapshot
+// Contact person:	CSAT
+// *****************************************************************************
+
+#if !defined (SNAPSHOT_HPP)
+#define	SNAPSHOT_HPP
+
+#include "Property_Test.hpp"
+#include "Property_Test_Helpers.hpp"
+#include "Property_Test_Progress.hpp"
+
+#include "Location.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace PropertyTestSnapshot
+{
+
+// -----------------------------------------------------------------------------
+// File format
+//
+// The snapshot is one block that can be mapped into memory and used as it
+// is: every table is a fixed size record array at an 8-byte aligned offset
+// from the beginning of the file, referenced from the FileHeader. Numbers
+// are little-endian (the byte order of every platform of ArchiCAD).
+//	- elements:		API_Guid, sorted by GuidLess
+//	- definitions:	DefinitionRecord, sorted by the definition guid; the values
+//					of a definition are the [firstValue, firstValue + valueCount)
+//					range of the value columns
+//	- enum values:	EnumValueRecord, the enumeration values used in the values
+//	- strings:		zero terminated UTF-8 texts, interned, string 0 is ""
+//	- values:		three columns, sorted by definition and element:
+//					element index (UInt32), data (UInt64), flags (UInt8)
+//	- list items:	data (UInt64) of the items of the list values
+//
+// The data of a value depends on the collection type of its definition:
+//	- single:				the encoded variant (see below)
+//	- list:					first list item | item count << 32
+//	- single choice enum:	enum value index
+//	- multiple choice enum:	first list item | item count << 32, the items
+//							are enum value indices
+// An encoded variant is the Int32 (sign extended), the bits of the double,
+// the string index or 0/1 for booleans. A value flagged ValueIsDefault is
+// the default value of its definition.
+// -----------------------------------------------------------------------------
+
+static const char	FileMagic[8] = { 'P', 'T', 'S', 'N', 'A', 'P', '\r', '\n' };
+static const UInt32	FileVersion = 1;
+
+enum ValueFlags {
+	ValueIsDefault	= 0x01
+};
+
+struct FileHeader {
+	char		magic[8];
+	UInt32		version;
+	UInt32		headerSize;
+	UInt32		elementCount;
+	UInt32		definitionCount;
+	UInt32		enumValueCount;
+	UInt32		stringCount;
+	UInt32		valueCount;
+	UInt32		listItemCount;
+	UInt64		fileSize;
+	UInt64		elementsOffset;			// API_Guid [elementCount]
+	UInt64		definitionsOffset;		// DefinitionRecord [definitionCount]
+	UInt64		enumValuesOffset;		// EnumValueRecord [enumValueCount]
+	UInt64		stringOffsetsOffset;	// UInt32 [stringCount], into the string data
+	UInt64		stringDataOffset;		// char []
+	UInt64		valueElemsOffset;		// UInt32 [valueCount]
+	UInt64		valueDataOffset;		// UInt64 [valueCount]
+	UInt64		valueFlagsOffset;		// UInt8 [valueCount]
+	UInt64		listItemsOffset;		// UInt64 [listItemCount]
+};
+
+struct DefinitionRecord {
+	API_Guid	guid;
+	API_Guid	groupGuid;
+	UInt32		name;					// string index
+	UInt32		collectionType;			// API_PropertyCollectionType
+	UInt32		valueType;				// API_VariantType
+	UInt32		firstValue;
+	UInt32		valueCount;
+	UInt32		reserved;
+};
+
+struct EnumValueRecord {
+	API_Guid	guid;
+	UInt32		definitionIndex;
+	UInt32		displayName;			// string index
+};
+
+static_assert (sizeof (API_Guid) == 16, "API_Guid is written as 16 bytes");
+static_assert (sizeof (FileHeader) == 120, "FileHeader layout changed");
+static_assert (sizeof (DefinitionRecord) == 56, "DefinitionRecord layout changed");
+static_assert (sizeof (EnumValueRecord) == 24, "EnumValueRecord layout changed");
+
+
+// -----------------------------------------------------------------------------
+// Byte order of the guids in the snapshot tables
+// -----------------------------------------------------------------------------
+
+bool		GuidLess (const API_Guid& lhs, const API_Guid& rhs);
+
+
+// -----------------------------------------------------------------------------
+// Read-only access to a snapshot in memory (loaded or mapped). Nothing is
+// parsed or copied: the accessors point into the given block, which must
+// outlive the view.
+// IsValid checks every table and every index stored in the file (strings,
+// enum values, list ranges, value elements), so the accessors do not check
+// them again: use a view only after IsValid returned true.
+// -----------------------------------------------------------------------------
+
+class SnapshotView
+{
+public:
+	SnapshotView (const void* fileData, UInt64 fileSize);
+
+	bool						IsValid () const;
+
+	UInt32						GetElementCount () const;
+	const API_Guid&				GetElement (UInt32 elemIndex) const;
+	bool						FindElement (const API_Guid& elemGuid, UInt32& elemIndex) const;
+
+	UInt32						GetDefinitionCount () const;
+	const DefinitionRecord&		GetDefinition (UInt32 definitionIndex) const;
+	bool						FindDefinition (const API_Guid& definitionGuid, UInt32& definitionIndex) const;
+
+	UInt32						GetEnumValueCount () const;
+	const EnumValueRecord&		GetEnumValue (UInt32 enumValueIndex) const;
+
+	UInt32						GetStringCount () const;
+	const char*					GetString (UInt32 stringIndex) const;
+
+	UInt32						GetValueCount () const;
+	const UInt32*				GetValueElems () const;
+	const UInt64*				GetValueData () const;
+	const UInt8*				GetValueFlags () const;
+
+	UInt32						GetListItemCount () const;
+	const UInt64*				GetListItems () const;
+
+private:
+	template<typename Type>
+	const Type*					At (UInt64 offset) const;
+
+	bool						AreTablesInside () const;
+	bool						AreStringsValid () const;
+	bool						AreIndicesValid () const;
+	bool						IsListRangeValid (UInt64 valueData, bool areItemsIndices, UInt32 itemLimit) const;
+
+	const char*					data;
+	UInt64						size;
+	const FileHeader*			header;
+};
+
+
+// -----------------------------------------------------------------------------
+// Builds a snapshot from the properties of the elements. The elements can be
+// added in any order, the tables are sorted when the file is built.
+// -----------------------------------------------------------------------------
+
+class SnapshotWriter
+{
+public:
+	SnapshotWriter ();
+
+	void		AddElement (const API_Guid& elemGuid, const GS::Array<API_Property>& properties);
+
+	UInt32		GetElementCount () const;
+	UInt32		GetValueCount () const;
+
+	void		Build (std::vector<char>& file) const;
+
+private:
+	typedef std::unordered_map<API_Guid, UInt32, PropertyTestHelpers::GuidHash> GuidIndices;
+
+	struct RawElement {
+		API_Guid	guid;
+		UInt32		firstValue;
+		UInt32		valueCount;
+	};
+
+	struct RawValue {
+		UInt32		definitionIndex;
+		UInt8		flags;
+		UInt64		data;
+	};
+
+	UInt32		GetDefinitionIndex (const API_PropertyDefinition& definition);
+	UInt32		GetEnumValueIndex (const API_Guid& enumGuid, const API_PropertyDefinition& definition, UInt32 definitionIndex);
+	UInt32		InternString (const GS::UniString& string);
+	UInt64		EncodeVariant (const API_Variant& variant);
+	UInt64		EncodeValue (const API_Property& property, UInt32 definitionIndex);
+
+	std::vector<RawElement>								elements;
+	std::vector<RawValue>								values;
+	std::vector<UInt64>									listItems;
+	std::vector<DefinitionRecord>						definitions;		// in the order of the first occurrence
+	GuidIndices											definitionIndices;
+	std::vector<EnumValueRecord>						enumValues;
+	GuidIndices											enumValueIndices;
+	std::vector<UInt32>									stringOffsets;
+	std::vector<char>									stringData;
+	std::unordered_map<std::string, UInt32>				stringIndices;
+};
+
+
+// -----------------------------------------------------------------------------
+// Project level functions
+// -----------------------------------------------------------------------------
+
+// Reads the properties of every element of the project
+GSErrCode	CollectProject (SnapshotWriter& writer, PropertyTestHelpers::Progress* progress);
+
+// <project folder>/<project name><suffix>; the project must have been saved
+GSErrCode	GetProjectFileLocation (const GS::UniString& suffix, IO::Location& location);
+
+// <project folder>/<project name>.ptsnap, and the one it replaced
+GSErrCode	GetSnapshotLocations (IO::Location& current, IO::Location& previous);
+
+GSErrCode	SaveFile (const IO::Location& location, const std::vector<char>& file);
+GSErrCode	LoadFile (const IO::Location& location, std::vector<char>& file);
+
+}
+
+#endif
@@ -0,0 +1,384 @@
+// *****************************************************************************
+// File:			Property_Test_SnapshotDiff.cpp
+// Description:		Property_Test add-on difference of two property snapshots
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestSnapshot
+// Contact person:	CSAT
+// *****************************************************************************
+
+#include "Property_Test_SnapshotDiff.hpp"
+
+#include "File.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+// The diff file is written in blocks of this size
+static const size_t OutputBlockSize = 64 * 1024;
+
+
+// -----------------------------------------------------------------------------
+// DiffStatistics
+// -----------------------------------------------------------------------------
+
+PropertyTestSnapshot::DiffStatistics::DiffStatistics () :
+	oldElementCount (0),
+	newElementCount (0),
+	addedElementCount (0),
+	removedElementCount (0),
+	addedValueCount (0),
+	removedValueCount (0),
+	changedValueCount (0),
+	unchangedValueCount (0)
+{
+}
+
+
+void PropertyTestSnapshot::DiffStatistics::Report (const char* commandName) const
+{
+	WriteReport ("%s: %u -> %u element(s), %u added, %u removed", commandName, oldElementCount, newElementCount, addedElementCount, removedElementCount);
+	WriteReport ("  values: %u added, %u removed, %u changed, %u unchanged", addedValueCount, removedValueCount, changedValueCount, unchangedValueCount);
+}
+
+
+// -----------------------------------------------------------------------------
+// Comparison
+// -----------------------------------------------------------------------------
+
+static bool AreVariantsEqual (UInt32 valueType, const PropertyTestSnapshot::SnapshotView& oldState, UInt64 oldData,
+							  const PropertyTestSnapshot::SnapshotView& newState, UInt64 newData)
+{
+	switch (valueType) {
+		case API_PropertyRealValueType: {
+			double oldDouble;
+			double newDouble;
+			std::memcpy (&oldDouble, &oldData, sizeof (double));
+			std::memcpy (&newDouble, &newData, sizeof (double));
+			return oldDouble == newDouble;
+		}
+		case API_PropertyStringValueType:
+			return std::strcmp (oldState.GetString (static_cast<UInt32> (oldData)), newState.GetString (static_cast<UInt32> (newData))) == 0;
+		default:
+			return oldData == newData;
+	}
+}
+
+
+static bool AreEnumValuesEqual (const PropertyTestSnapshot::SnapshotView& oldState, UInt64 oldData,
+								const PropertyTestSnapshot::SnapshotView& newState, UInt64 newData)
+{
+	return oldState.GetEnumValue (static_cast<UInt32> (oldData)).guid == newState.GetEnumValue (static_cast<UInt32> (newData)).guid;
+}
+
+
+template<typename ItemEquals>
+static bool AreListsEqual (const PropertyTestSnapshot::SnapshotView& oldState, UInt64 oldData,
+						   const PropertyTestSnapshot::SnapshotView& newState, UInt64 newData, const ItemEquals& itemEquals)
+{
+	const UInt32 count = static_cast<UInt32> (oldData >> 32);
+	if (count != static_cast<UInt32> (newData >> 32)) {
+		return false;
+	}
+
+	const UInt64* oldItems = oldState.GetListItems () + static_cast<UInt32> (oldData);
+	const UInt64* newItems = newState.GetListItems () + static_cast<UInt32> (newData);
+	for (UInt32 i = 0; i < count; ++i) {
+		if (!itemEquals (oldItems[i], newItems[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+bool PropertyTestSnapshot::AreValuesEqual (const SnapshotView& oldState, UInt32 oldDefinition, UInt32 oldValue,
+										   const SnapshotView& newState, UInt32 newDefinition, UInt32 newValue)
+{
+	const DefinitionRecord& oldRecord = oldState.GetDefinition (oldDefinition);
+	const DefinitionRecord& newRecord = newState.GetDefinition (newDefinition);
+	if (oldRecord.collectionType != newRecord.collectionType || oldRecord.valueType != newRecord.valueType ||
+		oldState.GetValueFlags ()[oldValue] != newState.GetValueFlags ()[newValue]) {
+		return false;
+	}
+
+	const UInt64 oldData = oldState.GetValueData ()[oldValue];
+	const UInt64 newData = newState.GetValueData ()[newValue];
+	const UInt32 valueType = oldRecord.valueType;
+	switch (oldRecord.collectionType) {
+		case API_PropertySingleCollectionType:
+			return AreVariantsEqual (valueType, oldState, oldData, newState, newData);
+		case API_PropertyListCollectionType:
+			return AreListsEqual (oldState, oldData, newState, newData, [&] (UInt64 oldItem, UInt64 newItem) {
+				return AreVariantsEqual (valueType, oldState, oldItem, newState, newItem);
+			});
+		case API_PropertySingleChoiceEnumerationCollectionType:
+			return AreEnumValuesEqual (oldState, oldData, newState, newData);
+		case API_PropertyMultipleChoiceEnumerationCollectionType:
+			return AreListsEqual (oldState, oldData, newState, newData, [&] (UInt64 oldItem, UInt64 newItem) {
+				return AreEnumValuesEqual (oldState, oldItem, newState, newItem);
+			});
+		default:
+			return oldData == newData;
+	}
+}
+
+
+// -----------------------------------------------------------------------------
+// Merge
+// -----------------------------------------------------------------------------
+
+static void CountElements (const PropertyTestSnapshot::SnapshotView& oldState, const PropertyTestSnapshot::SnapshotView& newState,
+						   PropertyTestSnapshot::DiffStatistics& statistics)
+{
+	statistics.oldElementCount = oldState.GetElementCount ();
+	statistics.newElementCount = newState.GetElementCount ();
+
+	UInt32 o = 0;
+	UInt32 n = 0;
+	while (o < oldState.GetElementCount () || n < newState.GetElementCount ()) {
+		if (n == newState.GetElementCount () || (o < oldState.GetElementCount () && PropertyTestSnapshot::GuidLess (oldState.GetElement (o), newState.GetElement (n)))) {
+			++statistics.removedElementCount;
+			++o;
+		} else if (o == oldState.GetElementCount () || PropertyTestSnapshot::GuidLess (newState.GetElement (n), oldState.GetElement (o))) {
+			++statistics.addedElementCount;
+			++n;
+		} else {
+			++o;
+			++n;
+		}
+	}
+}
+
+
+static void ReportAll (const PropertyTestSnapshot::SnapshotView& state, UInt32 definitionIndex, PropertyTestSnapshot::DiffKind kind,
+					   const PropertyTestSnapshot::DiffSink& sink, PropertyTestSnapshot::DiffStatistics& statistics)
+{
+	const PropertyTestSnapshot::DefinitionRecord& record = state.GetDefinition (definitionIndex);
+
+	PropertyTestSnapshot::DiffEntry entry;
+	BNZeroMemory (&entry, sizeof (entry));
+	entry.kind = kind;
+	for (UInt32 i = record.firstValue; i < record.firstValue + record.valueCount; ++i) {
+		entry.elemGuid = state.GetElement (state.GetValueElems ()[i]);
+		if (kind == PropertyTestSnapshot::ValueAdded) {
+			entry.newDefinition = definitionIndex;
+			entry.newValue = i;
+			++statistics.addedValueCount;
+		} else {
+			entry.oldDefinition = definitionIndex;
+			entry.oldValue = i;
+			++statistics.removedValueCount;
+		}
+		sink (entry);
+	}
+}
+
+
+static void DiffDefinition (const PropertyTestSnapshot::SnapshotView& oldState, UInt32 oldDefinition,
+							const PropertyTestSnapshot::SnapshotView& newState, UInt32 newDefinition,
+							const PropertyTestSnapshot::DiffSink& sink, PropertyTestSnapshot::DiffStatistics& statistics)
+{
+	const PropertyTestSnapshot::DefinitionRecord& oldRecord = oldState.GetDefinition (oldDefinition);
+	const PropertyTestSnapshot::DefinitionRecord& newRecord = newState.GetDefinition (newDefinition);
+	const UInt32* oldElems = oldState.GetValueElems ();
+	const UInt32* newElems = newState.GetValueElems ();
+
+	PropertyTestSnapshot::DiffEntry entry;
+	entry.oldDefinition = oldDefinition;
+	entry.newDefinition = newDefinition;
+
+	// the values of a definition are sorted by element, and the element
+	// indices follow the guid order in both states
+	UInt32 o = oldRecord.firstValue;
+	UInt32 n = newRecord.firstValue;
+	const UInt32 oldEnd = oldRecord.firstValue + oldRecord.valueCount;
+	const UInt32 newEnd = newRecord.firstValue + newRecord.valueCount;
+	while (o < oldEnd || n < newEnd) {
+		entry.oldValue = o;
+		entry.newValue = n;
+		if (n == newEnd || (o < oldEnd && PropertyTestSnapshot::GuidLess (oldState.GetElement (oldElems[o]), newState.GetElement (newElems[n])))) {
+			entry.kind = PropertyTestSnapshot::ValueRemoved;
+			entry.elemGuid = oldState.GetElement (oldElems[o]);
+			++statistics.removedValueCount;
+			++o;
+		} else if (o == oldEnd || PropertyTestSnapshot::GuidLess (newState.GetElement (newElems[n]), oldState.GetElement (oldElems[o]))) {
+			entry.kind = PropertyTestSnapshot::ValueAdded;
+			entry.elemGuid = newState.GetElement (newElems[n]);
+			++statistics.addedValueCount;
+			++n;
+		} else {
+			const bool equal = PropertyTestSnapshot::AreValuesEqual (oldState, oldDefinition, o, newState, newDefinition, n);
+			++o;
+			++n;
+			if (equal) {
+				++statistics.unchangedValueCount;
+				continue;
+			}
+			entry.kind = PropertyTestSnapshot::ValueChanged;
+			entry.elemGuid = oldState.GetElement (oldElems[o - 1]);
+			++statistics.changedValueCount;
+		}
+		sink (entry);
+	}
+}
+
+
+void PropertyTestSnapshot::Diff (const SnapshotView& oldState, const SnapshotView& newState, const DiffSink& sink, DiffStatistics& statistics)
+{
+	statistics = DiffStatistics ();
+	CountElements (oldState, newState, statistics);
+
+	const UInt32 oldCount = oldState.GetDefinitionCount ();
+	const UInt32 newCount = newState.GetDefinitionCount ();
+	UInt32 o = 0;
+	UInt32 n = 0;
+	while (o < oldCount || n < newCount) {
+		if (n == newCount || (o < oldCount && GuidLess (oldState.GetDefinition (o).guid, newState.GetDefinition (n).guid))) {
+			ReportAll (oldState, o++, ValueRemoved, sink, statistics);
+		} else if (o == oldCount || GuidLess (newState.GetDefinition (n).guid, oldState.GetDefinition (o).guid)) {
+			ReportAll (newState, n++, ValueAdded, sink, statistics);
+		} else {
+			DiffDefinition (oldState, o++, newState, n++, sink, statistics);
+		}
+	}
+}
+
+
+// -----------------------------------------------------------------------------
+// Formatting
+// -----------------------------------------------------------------------------
+
+static std::string FormatVariant (const PropertyTestSnapshot::SnapshotView& state, UInt32 valueType, UInt64 data)
+{
+	char buffer[64];
+	switch (valueType) {
+		case API_PropertyIntegerValueType:
+			std::snprintf (buffer, sizeof (buffer), "%d", static_cast<Int32> (data));
+			return buffer;
+		case API_PropertyRealValueType: {
+			double value;
+			std::memcpy (&value, &data, sizeof (double));
+			std::snprintf (buffer, sizeof (buffer), "%.10g", value);
+			return buffer;
+		}
+		case API_PropertyStringValueType:
+			return state.GetString (static_cast<UInt32> (data));
+		case API_PropertyBooleanValueType:
+			return (data != 0) ? "true" : "false";
+		default:
+			return std::string ();
+	}
+}
+
+
+std::string PropertyTestSnapshot::FormatValue (const SnapshotView& state, UInt32 definitionIndex, UInt32 valueIndex)
+{
+	const DefinitionRecord& record = state.GetDefinition (definitionIndex);
+	const UInt64 data = state.GetValueData ()[valueIndex];
+
+	std::string text = (state.GetValueFlags ()[valueIndex] & ValueIsDefault) ? "(default) " : "";
+	const UInt64* items = state.GetListItems () + static_cast<UInt32> (data);
+	const UInt32 itemCount = static_cast<UInt32> (data >> 32);
+	switch (record.collectionType) {
+		case API_PropertySingleCollectionType:
+			text += FormatVariant (state, record.valueType, data);
+			break;
+		case API_PropertyListCollectionType:
+			for (UInt32 i = 0; i < itemCount; ++i) {
+				text += (i > 0 ? "; " : "") + FormatVariant (state, record.valueType, items[i]);
+			}
+			break;
+		case API_PropertySingleChoiceEnumerationCollectionType:
+			text += state.GetString (state.GetEnumValue (static_cast<UInt32> (data)).displayName);
+			break;
+		case API_PropertyMultipleChoiceEnumerationCollectionType:
+			for (UInt32 i = 0; i < itemCount; ++i) {
+				text += (i > 0 ? "; " : "");
+				text += state.GetString (state.GetEnumValue (static_cast<UInt32> (items[i])).displayName);
+			}
+			break;
+		default:
+			break;
+	}
+	return text;
+}
+
+
+std::string PropertyTestSnapshot::FormatGuid (const API_Guid& guid)
+{
+	UInt8 bytes[16];
+	std::memcpy (bytes, &guid, sizeof (bytes));
+
+	UInt32 data1;
+	UInt16 data2;
+	UInt16 data3;
+	std::memcpy (&data1, bytes, 4);
+	std::memcpy (&data2, bytes + 4, 2);
+	std::memcpy (&data3, bytes + 6, 2);
+
+	char buffer[40];
+	std::snprintf (buffer, sizeof (buffer), "%08X-%04X-%04X-%02X%02X-%02X%02X%02X%02X%02X%02X",
+				   data1, data2, data3, bytes[8], bytes[9], bytes[10], bytes[11], bytes[12], bytes[13], bytes[14], bytes[15]);
+	return buffer;
+}
+
+
+// -----------------------------------------------------------------------------
+// Diff file
+// -----------------------------------------------------------------------------
+
+// Texts of the model may contain the separators of the file
+static void AppendField (std::string& line, const std::string& field)
+{
+	line += '\t';
+	for (char c : field) {
+		line += (c == '\t' || c == '\n' || c == '\r') ? ' ' : c;
+	}
+}
+
+
+GSErrCode PropertyTestSnapshot::WriteDiff (const SnapshotView& oldState, const SnapshotView& newState, const IO::Location& location, DiffStatistics& statistics)
+{
+	IO::File output (location, IO::File::Create);
+	GSErrCode error = output.GetStatus ();
+	if (error != NoError) {
+		return error;
+	}
+
+	error = output.Open (IO::File::WriteEmptyMode);
+	if (error != NoError) {
+		return error;
+	}
+
+	std::string block;
+	block.reserve (OutputBlockSize * 2);
+	auto WriteBlock = [&] () {
+		if (error == NoError && !block.empty ()) {
+			error = output.WriteBin (block.data (), static_cast<USize> (block.size ()));
+		}
+		block.clear ();
+	};
+
+	block += "change\telement\tproperty\told value\tnew value\n";
+	Diff (oldState, newState, [&] (const DiffEntry& entry) {
+		const bool hasOld = (entry.kind != ValueAdded);
+		const bool hasNew = (entry.kind != ValueRemoved);
+		const SnapshotView& state = hasNew ? newState : oldState;
+		const UInt32 definitionIndex = hasNew ? entry.newDefinition : entry.oldDefinition;
+
+		block += (entry.kind == ValueAdded) ? '+' : (entry.kind == ValueRemoved) ? '-' : '~';
+		AppendField (block, FormatGuid (entry.elemGuid));
+		AppendField (block, state.GetString (state.GetDefinition (definitionIndex).name));
+		AppendField (block, hasOld ? FormatValue (oldState, entry.oldDefinition, entry.oldValue) : std::string ());
+		AppendField (block, hasNew ? FormatValue (newState, entry.newDefinition, entry.newValue) : std::string ());
+		block += '\n';
+
+		if (block.size () >= OutputBlockSize) {
+			WriteBlock ();
+		}
+	}, statistics);
+	WriteBlock ();
+
+	GSErrCode closeError = output.Close ();
+	return (error != NoError) ? error : closeError;
+}
@@ -0,0 +1,87 @@
+// *****************************************************************************
+// File:			Property_Test_SnapshotDiff.hpp
+// Description:		Property_Test add-on difference of two property snapshots
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestSnapshot
+// Contact person:	CSAT
+// *****************************************************************************
+
+#if !defined (SNAPSHOTDIFF_HPP)
+#define	SNAPSHOTDIFF_HPP
+
+#include "Property_Test_Snapshot.hpp"
+
+#include <functional>
+#include <string>
+
+namespace PropertyTestSnapshot
+{
+
+// -----------------------------------------------------------------------------
+// One difference between the old and the new state. The indices refer to
+// the view the value is in; the ones of the missing side are not valid.
+// -----------------------------------------------------------------------------
+
+enum DiffKind {
+	ValueAdded,
+	ValueRemoved,
+	ValueChanged
+};
+
+struct DiffEntry {
+	DiffKind		kind;
+	API_Guid		elemGuid;
+	UInt32			oldDefinition;
+	UInt32			oldValue;
+	UInt32			newDefinition;
+	UInt32			newValue;
+};
+
+struct DiffStatistics {
+	UInt32		oldElementCount;
+	UInt32		newElementCount;
+	UInt32		addedElementCount;
+	UInt32		removedElementCount;
+	UInt32		addedValueCount;
+	UInt32		removedValueCount;
+	UInt32		changedValueCount;
+	UInt32		unchangedValueCount;
+
+	DiffStatistics ();
+
+	void		Report (const char* commandName) const;
+};
+
+typedef std::function<void (const DiffEntry&)>	DiffSink;
+
+
+// -----------------------------------------------------------------------------
+// Compares two states, each one a saved snapshot or a live one built in
+// memory. Both the definitions and the values of a definition are sorted by
+// guid in the snapshots, so the states are merged in one pass, O(n), without
+// building any index. The differences are passed to the sink as they are
+// found, per definition and in element guid order.
+// Values are compared like Equals (API_PropertyValue, ...): strings by
+// content, enumeration values by guid, lists item by item; a change of the
+// isDefault flag is a change too.
+// -----------------------------------------------------------------------------
+
+void			Diff (const SnapshotView& oldState, const SnapshotView& newState, const DiffSink& sink, DiffStatistics& statistics);
+
+bool			AreValuesEqual (const SnapshotView& oldState, UInt32 oldDefinition, UInt32 oldValue,
+								const SnapshotView& newState, UInt32 newDefinition, UInt32 newValue);
+
+std::string		FormatValue (const SnapshotView& state, UInt32 definitionIndex, UInt32 valueIndex);
+std::string		FormatGuid (const API_Guid& guid);
+
+
+// -----------------------------------------------------------------------------
+// Streams the differences into a tab separated text file, one line each:
+//	+|-|~	element guid	definition name	old value	new value
+// -----------------------------------------------------------------------------
+
+GSErrCode		WriteDiff (const SnapshotView& oldState, const SnapshotView& newState, const IO::Location& location, DiffStatistics& statistics);
+
+}
+
+#endif
@@ -0,0 +1,381 @@
+// *****************************************************************************
+// File:			Property_Test_Stress.cpp
+// Description:		Property_Test add-on scaled stress tests of groups and definitions
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestStress
+// Contact person:	CSAT
+// *****************************************************************************
+
+#include "Property_Test_Stress.hpp"
+#include "Property_Test_Batch.hpp"
+#include "Property_Test_Helpers.hpp"
+#include "Property_Test_IdGenerator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <unordered_set>
+
+static const UInt32	CancelCheckInterval	= 256;
+static const double	MinMeasuredSeconds	= 0.005;	// below it the timer noise hides the growth
+static const double	MaxExponentExcess	= 0.5;		// halfway to the next power of N
+static const double	LinearExponent		= 1.0;
+static const double	QuadraticExponent	= 2.0;
+
+
+namespace {
+
+// Deletes the groups a failed or canceled run has left in the project; deleting
+// a group deletes its definitions too
+class GroupCleanup
+{
+public:
+	explicit GroupCleanup (GS::Array<API_PropertyGroup>& groupsToDelete) : groups (groupsToDelete) {}
+
+	~GroupCleanup ()
+	{
+		for (UInt32 i = 0; i < groups.GetSize (); ++i) {
+			if (groups[i].guid != APINULLGuid) {
+				ACAPI_Property_DeletePropertyGroup (groups[i].guid);
+			}
+		}
+	}
+
+private:
+	GroupCleanup (const GroupCleanup&);				// disabled
+	GroupCleanup& operator= (const GroupCleanup&);	// disabled
+
+	GS::Array<API_PropertyGroup>&	groups;
+};
+
+}
+
+
+static void AddPhase (PropertyTestStress::StressRun& run, const char* name, UInt32 itemCount, double seconds, double expectedExponent = LinearExponent)
+{
+	PropertyTestStress::PhaseCost phase;
+	phase.name = name;
+	phase.itemCount = itemCount;
+	phase.seconds = seconds;
+	phase.expectedExponent = expectedExponent;
+	run.phases.push_back (phase);
+}
+
+
+// Calls operation on every item as one timed phase; a failed assertion in it
+// throws, a cancel stops it
+static GSErrCode RunPhase (PropertyTestStress::StressRun& run, const char* name, UInt32 count, PropertyTestHelpers::Progress* progress,
+						   const std::function<void (UInt32)>& operation, double expectedExponent = LinearExponent)
+{
+	PropertyTestBatch::Stopwatch stopwatch;
+	for (UInt32 i = 0; i < count; ++i) {
+		if (i % CancelCheckInterval == 0 && progress != nullptr && progress->IsCanceled ()) {
+			return APIERR_CANCEL;
+		}
+		operation (i);
+	}
+	AddPhase (run, name, count, stopwatch.GetSeconds (), expectedExponent);
+	return NoError;
+}
+
+
+// The number of the created objects in the listed ones: one hash lookup per
+// listed object, as a Contains per created object would make the check itself
+// quadratic
+template <typename Type>
+static UInt32 CountListed (const GS::Array<Type>& created, const GS::Array<Type>& listed)
+{
+	std::unordered_set<API_Guid, PropertyTestHelpers::GuidHash> createdGuids;
+	createdGuids.reserve (created.GetSize ());
+	for (UInt32 i = 0; i < created.GetSize (); ++i) {
+		createdGuids.insert (created[i].guid);
+	}
+
+	UInt32 listedCount = 0;
+	for (UInt32 i = 0; i < listed.GetSize (); ++i) {
+		if (createdGuids.count (listed[i].guid) > 0) {
+			++listedCount;
+		}
+	}
+	return listedCount;
+}
+
+
+// -----------------------------------------------------------------------------
+// PhaseCost
+// -----------------------------------------------------------------------------
+
+double PropertyTestStress::PhaseCost::GetMicrosecondsPerItem () const
+{
+	return (itemCount > 0) ? seconds * 1000000.0 / itemCount : 0.0;
+}
+
+
+// -----------------------------------------------------------------------------
+// Stress runs
+// -----------------------------------------------------------------------------
+
+GSErrCode PropertyTestStress::RunGroupStress (UInt32 count, PropertyTestHelpers::Progress* progress, StressRun& run)
+{
+	run.subject = "groups";
+	run.count = count;
+	run.phases.clear ();
+
+	GS::Array<API_PropertyGroup> groups;
+	groups.SetCapacity (count);
+	GroupCleanup cleanup (groups);
+
+	PropertyTestHelpers::IdGenerator& ids = PropertyTestHelpers::IdGenerator::Get ();
+	GSErrCode error = RunPhase (run, "create", count, progress, [&] (UInt32) {
+		API_PropertyGroup group;
+		group.guid = APINULLGuid;
+		group.name = ids.NextName ("Property_Test Stress Group - ");
+		ASSERT_NO_ERROR (ACAPI_Property_CreatePropertyGroup (group));
+		groups.Push (group);
+	});
+	if (error != NoError) {
+		return error;
+	}
+
+	error = RunPhase (run, "get", count, progress, [&] (UInt32 i) {
+		API_PropertyGroup group;
+		group.guid = groups[i].guid;
+		ASSERT_NO_ERROR (ACAPI_Property_GetPropertyGroup (group));
+		ASSERT (group.name == groups[i].name);
+	});
+	if (error != NoError) {
+		return error;
+	}
+
+	PropertyTestBatch::Stopwatch stopwatch;
+	GS::Array<API_PropertyGroup> listedGroups;
+	ASSERT_NO_ERROR (ACAPI_Property_GetPropertyGroups (listedGroups));
+	ASSERT (CountListed (groups, listedGroups) == count);
+	AddPhase (run, "list", count, stopwatch.GetSeconds ());
+
+	if (count <= PropertyTestStress::FindMaxCount) {
+		error = RunPhase (run, "find", count, progress, [&] (UInt32 i) {
+			GS::Array<API_PropertyGroup> foundGroups;
+			ASSERT_NO_ERROR (ACAPI_Property_GetPropertyGroups (foundGroups));
+			ASSERT (foundGroups.Contains (groups[i]));
+		}, QuadraticExponent);
+		if (error != NoError) {
+			return error;
+		}
+	}
+
+	error = RunPhase (run, "rename", count, progress, [&] (UInt32 i) {
+		groups[i].name += " Renamed";
+		ASSERT_NO_ERROR (ACAPI_Property_ChangePropertyGroup (groups[i]));
+	});
+	if (error != NoError) {
+		return error;
+	}
+
+	return RunPhase (run, "delete", count, progress, [&] (UInt32 i) {
+		ASSERT_NO_ERROR (ACAPI_Property_DeletePropertyGroup (groups[i].guid));
+		groups[i].guid = APINULLGuid;
+	});
+}
+
+
+GSErrCode PropertyTestStress::RunDefinitionStress (UInt32 count, PropertyTestHelpers::Progress* progress, StressRun& run)
+{
+	run.subject = "definitions";
+	run.count = count;
+	run.phases.clear ();
+
+	// an own group, so the listing and the cleanup do not depend on the other definitions
+	GS::Array<API_PropertyGroup> stressGroups;
+	GroupCleanup cleanup (stressGroups);
+	API_PropertyGroup group = PropertyTestHelpers::CreateExamplePropertyGroup ();
+	ASSERT_NO_ERROR (ACAPI_Property_CreatePropertyGroup (group));
+	stressGroups.Push (group);
+
+	GS::Array<API_PropertyDefinition> definitions;
+	definitions.SetCapacity (count);
+	GSErrCode error = RunPhase (run, "create", count, progress, [&] (UInt32) {
+		API_PropertyDefinition definition = PropertyTestHelpers::CreateExampleIntPropertyDefinition (group);
+		ASSERT_NO_ERROR (ACAPI_Property_CreatePropertyDefinition (definition));
+		definitions.Push (definition);
+	});
+	if (error != NoError) {
+		return error;
+	}
+
+	error = RunPhase (run, "get", count, progress, [&] (UInt32 i) {
+		API_PropertyDefinition definition;
+		definition.guid = definitions[i].guid;
+		ASSERT_NO_ERROR (ACAPI_Property_GetPropertyDefinition (definition));
+		ASSERT (definition.name == definitions[i].name);
+	});
+	if (error != NoError) {
+		return error;
+	}
+
+	PropertyTestBatch::Stopwatch stopwatch;
+	GS::Array<API_PropertyDefinition> listedDefinitions;
+	ASSERT_NO_ERROR (ACAPI_Property_GetPropertyDefinitions (group.guid, listedDefinitions));
+	ASSERT (CountListed (definitions, listedDefinitions) == count);
+	AddPhase (run, "list", count, stopwatch.GetSeconds ());
+
+	if (count <= PropertyTestStress::FindMaxCount) {
+		error = RunPhase (run, "find", count, progress, [&] (UInt32 i) {
+			GS::Array<API_PropertyDefinition> foundDefinitions;
+			ASSERT_NO_ERROR (ACAPI_Property_GetPropertyDefinitions (group.guid, foundDefinitions));
+			ASSERT (foundDefinitions.Contains (definitions[i]));
+		}, QuadraticExponent);
+		if (error != NoError) {
+			return error;
+		}
+	}
+
+	error = RunPhase (run, "rename", count, progress, [&] (UInt32 i) {
+		definitions[i].name += " Renamed";
+		ASSERT_NO_ERROR (ACAPI_Property_ChangePropertyDefinition (definitions[i]));
+	});
+	if (error != NoError) {
+		return error;
+	}
+
+	error = RunPhase (run, "change", count, progress, [&] (UInt32 i) {
+		definitions[i].defaultValue.singleVariant.variant.intValue = static_cast<Int32> (i);
+		ASSERT_NO_ERROR (ACAPI_Property_ChangePropertyDefinition (definitions[i]));
+	});
+	if (error != NoError) {
+		return error;
+	}
+
+	error = RunPhase (run, "delete", count, progress, [&] (UInt32 i) {
+		ASSERT_NO_ERROR (ACAPI_Property_DeletePropertyDefinition (definitions[i].guid));
+	});
+	if (error != NoError) {
+		return error;
+	}
+
+	ASSERT_NO_ERROR (ACAPI_Property_DeletePropertyGroup (group.guid));
+	stressGroups[0].guid = APINULLGuid;
+
+	return NoError;
+}
+
+
+void PropertyTestStress::RegisterStressTests (const std::vector<UInt32>& counts, PropertyTestHelpers::Progress* progress,
+											  std::vector<StressRun>& runs, PropertyTestHelpers::TestRegistry& registry)
+{
+	// both subjects at a count before the next count, so a canceled suite still has comparable runs
+	for (UInt32 count : counts) {
+		char name[64];
+		std::snprintf (name, sizeof (name), "StressPropertyGroups (N=%u)", count);
+		registry.Add (name, [count, progress, &runs] () {
+			StressRun run;
+			const GSErrCode error = RunGroupStress (count, progress, run);
+			if (error == NoError) {
+				runs.push_back (run);
+			}
+			return error;
+		});
+
+		std::snprintf (name, sizeof (name), "StressPropertyDefinitions (N=%u)", count);
+		registry.Add (name, [count, progress, &runs] () {
+			StressRun run;
+			const GSErrCode error = RunDefinitionStress (count, progress, run);
+			if (error == NoError) {
+				runs.push_back (run);
+			}
+			return error;
+		});
+	}
+}
+
+
+// -----------------------------------------------------------------------------
+// Scaling
+// -----------------------------------------------------------------------------
+
+void PropertyTestStress::CheckScaling (const std::vector<StressRun>& runs, std::vector<Scaling>& scalings)
+{
+	scalings.clear ();
+
+	std::vector<const char*> subjects;
+	for (const StressRun& run : runs) {
+		if (std::find_if (subjects.begin (), subjects.end (), [&] (const char* subject) { return std::strcmp (subject, run.subject) == 0; }) == subjects.end ()) {
+			subjects.push_back (run.subject);
+		}
+	}
+
+	for (const char* subject : subjects) {
+		std::vector<const StressRun*> subjectRuns;
+		for (const StressRun& run : runs) {
+			if (std::strcmp (run.subject, subject) == 0) {
+				subjectRuns.push_back (&run);
+			}
+		}
+		std::stable_sort (subjectRuns.begin (), subjectRuns.end (), [] (const StressRun* lhs, const StressRun* rhs) {
+			return lhs->count < rhs->count;
+		});
+
+		for (size_t i = 1; i < subjectRuns.size (); ++i) {
+			const StressRun& smallRun = *subjectRuns[i - 1];
+			const StressRun& largeRun = *subjectRuns[i];
+			if (largeRun.count <= smallRun.count) {
+				continue;
+			}
+
+			// the phases are paired by name, as a large run may leave out the find phase
+			for (const PhaseCost& largePhase : largeRun.phases) {
+				auto smallPhase = std::find_if (smallRun.phases.begin (), smallRun.phases.end (), [&] (const PhaseCost& phase) {
+					return std::strcmp (phase.name, largePhase.name) == 0;
+				});
+				if (smallPhase == smallRun.phases.end () || smallPhase->seconds < MinMeasuredSeconds || largePhase.seconds <= 0.0) {
+					continue;
+				}
+
+				Scaling scaling;
+				scaling.subject = subject;
+				scaling.phase = largePhase.name;
+				scaling.smallCount = smallRun.count;
+				scaling.largeCount = largeRun.count;
+				scaling.exponent = std::log (largePhase.seconds / smallPhase->seconds) / std::log (static_cast<double> (largeRun.count) / smallRun.count);
+				scaling.expectedExponent = largePhase.expectedExponent;
+				scaling.isSuperlinear = scaling.exponent > scaling.expectedExponent + MaxExponentExcess;
+				scalings.push_back (scaling);
+			}
+		}
+	}
+}
+
+
+UInt32 PropertyTestStress::GetSuperlinearCount (const std::vector<Scaling>& scalings)
+{
+	return static_cast<UInt32> (std::count_if (scalings.begin (), scalings.end (), [] (const Scaling& scaling) {
+		return scaling.isSuperlinear;
+	}));
+}
+
+
+void PropertyTestStress::Report (const char* commandName, const std::vector<StressRun>& runs, const std::vector<Scaling>& scalings)
+{
+	WriteReport ("%s: %u run(s), %u phase(s) scale superlinearly (exponent more than %.1f above the expected one)",
+				 commandName, static_cast<UInt32> (runs.size ()), GetSuperlinearCount (scalings), MaxExponentExcess);
+
+	WriteReport ("  cost per item in microseconds");
+	for (const StressRun& run : runs) {
+		std::string line;
+		for (const PhaseCost& phase : run.phases) {
+			char cost[64];
+			std::snprintf (cost, sizeof (cost), "  %s %9.1f", phase.name, phase.GetMicrosecondsPerItem ());
+			line += cost;
+		}
+		WriteReport ("  %-11s %7u%s", run.subject, run.count, line.c_str ());
+	}
+
+	WriteReport ("  growth of the total time as a power of N");
+	for (const Scaling& scaling : scalings) {
+		WriteReport ("  %-11s %-7s %7u -> %7u  exponent %5.2f, expected %.0f%s", scaling.subject, scaling.phase,
+					 scaling.smallCount, scaling.largeCount, scaling.exponent, scaling.expectedExponent, scaling.isSuperlinear ? "  SUPERLINEAR" : "");
+	}
+}
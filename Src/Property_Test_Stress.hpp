@@ -0,0 +1,92 @@
+// *****************************************************************************
+// File:			Property_Test_Stress.hpp
+// Description:		Property_Test add-on scaled stress tests of groups and definitions
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestStress
+// Contact person:	CSAT
+// *****************************************************************************
+
+#if !defined (STRESS_HPP)
+#define	STRESS_HPP
+
+#include "Property_Test.hpp"
+#include "Property_Test_Progress.hpp"
+#include "Property_Test_TestRunner.hpp"
+
+#include <vector>
+
+namespace PropertyTestStress
+{
+
+// -----------------------------------------------------------------------------
+// The cost of one operation of a stress run, done on every item. The expected
+// exponent is the power of N the total time of the phase grows with when the
+// API scales well: 1 for an operation on one object, 2 for one that lists all
+// the N objects for every item.
+// -----------------------------------------------------------------------------
+
+struct PhaseCost {
+	const char*		name;
+	UInt32			itemCount;
+	double			seconds;
+	double			expectedExponent;
+
+	double			GetMicrosecondsPerItem () const;
+};
+
+
+// -----------------------------------------------------------------------------
+// One stress run: N property groups or definitions created, read back one by
+// one, listed, found one by one, renamed, changed (definitions only) and
+// deleted one by one. Finding an object lists all of them and searches the
+// list, as the thorough tests do; it is quadratic, so it is left out of the
+// runs above FindMaxCount.
+// -----------------------------------------------------------------------------
+
+static const UInt32	FindMaxCount = 10000;
+
+struct StressRun {
+	const char*				subject;		// "groups" or "definitions"
+	UInt32					count;
+	std::vector<PhaseCost>	phases;
+};
+
+
+GSErrCode	RunGroupStress (UInt32 count, PropertyTestHelpers::Progress* progress, StressRun& run);
+
+GSErrCode	RunDefinitionStress (UInt32 count, PropertyTestHelpers::Progress* progress, StressRun& run);
+
+// Adds a group and a definition stress test for every count, which append
+// their run to runs when they pass
+void		RegisterStressTests (const std::vector<UInt32>& counts, PropertyTestHelpers::Progress* progress,
+								 std::vector<StressRun>& runs, PropertyTestHelpers::TestRegistry& registry);
+
+
+// -----------------------------------------------------------------------------
+// The growth of the cost of a phase between two runs of the same subject, as
+// the exponent of N its total time follows: 1 for linear, 2 for quadratic
+// scaling. A phase scales superlinearly if its exponent is well above the
+// expected one. The phases are paired by name; the pairs where the smaller
+// run is too fast to measure are not checked.
+// -----------------------------------------------------------------------------
+
+struct Scaling {
+	const char*		subject;
+	const char*		phase;
+	UInt32			smallCount;
+	UInt32			largeCount;
+	double			exponent;
+	double			expectedExponent;
+	bool			isSuperlinear;
+};
+
+
+void		CheckScaling (const std::vector<StressRun>& runs, std::vector<Scaling>& scalings);
+
+UInt32		GetSuperlinearCount (const std::vector<Scaling>& scalings);
+
+void		Report (const char* commandName, const std::vector<StressRun>& runs, const std::vector<Scaling>& scalings);
+
+}
+
+#endif
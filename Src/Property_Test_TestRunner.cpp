@@ -0,0 +1,305 @@
+// *****************************************************************************
+// File:			Property_Test_TestRunner.cpp
+// Description:		Property_Test add-on timed test runner
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestHelpers
+// Contact person:	CSAT
+// *****************************************************************************
+
+#include "Property_Test_TestRunner.hpp"
+#include "Property_Test_Batch.hpp"
+#include "Property_Test_Helpers.hpp"
+#include "Property_Test_Snapshot.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <exception>
+#include <string>
+
+static PropertyTestHelpers::TestRunner* activeRunner = nullptr;
+
+
+// The sample at the given percent with the nearest-rank method
+static double GetPercentile (const std::vector<double>& sortedSamples, double percent)
+{
+	if (sortedSamples.empty ()) {
+		return 0.0;
+	}
+
+	size_t rank = static_cast<size_t> (std::ceil (percent / 100.0 * sortedSamples.size ()));
+	rank = std::max<size_t> (rank, 1);
+	return sortedSamples[std::min (rank, sortedSamples.size ()) - 1];
+}
+
+
+static void AppendXmlText (std::string& xml, const GS::UniString& text)
+{
+	const std::string utf8 (text.ToCStr (CC_UTF8).Get ());
+	for (char c : utf8) {
+		switch (c) {
+			case '<':	xml += "&lt;";		break;
+			case '>':	xml += "&gt;";		break;
+			case '&':	xml += "&amp;";		break;
+			case '"':	xml += "&quot;";	break;
+			case '\n':	xml += "&#10;";		break;
+			default:	xml += c;			break;
+		}
+	}
+}
+
+
+static void AppendXmlProperty (std::string& xml, const char* name, const char* format, double value)
+{
+	char number[64];
+	std::snprintf (number, sizeof (number), format, value);
+	xml += "      <property name=\"";
+	xml += name;
+	xml += "\" value=\"";
+	xml += number;
+	xml += "\"/>\n";
+}
+
+
+// -----------------------------------------------------------------------------
+// TestRegistry
+// -----------------------------------------------------------------------------
+
+void PropertyTestHelpers::TestRegistry::Add (const char* name, const TestFunction& run)
+{
+	TestCase test;
+	test.name = name;
+	test.run = run;
+	tests.push_back (test);
+}
+
+
+UInt32 PropertyTestHelpers::TestRegistry::GetSize () const
+{
+	return static_cast<UInt32> (tests.size ());
+}
+
+
+const PropertyTestHelpers::TestRegistry::TestCase& PropertyTestHelpers::TestRegistry::Get (UInt32 index) const
+{
+	return tests[index];
+}
+
+
+// -----------------------------------------------------------------------------
+// TestResult
+// -----------------------------------------------------------------------------
+
+PropertyTestHelpers::TestResult::TestResult () :
+	passed (true),
+	runCount (0),
+	apiCallCount (0),
+	minSeconds (0.0),
+	medianSeconds (0.0),
+	p95Seconds (0.0),
+	totalSeconds (0.0)
+{
+}
+
+
+// -----------------------------------------------------------------------------
+// TestRunner
+// -----------------------------------------------------------------------------
+
+PropertyTestHelpers::TestRunner::TestRunner (const TestRegistry& registryToRun) :
+	registry (registryToRun),
+	repeatCount (1),
+	progress (nullptr),
+	runApiCallCount (0)
+{
+}
+
+
+void PropertyTestHelpers::TestRunner::SetRepeatCount (UInt32 count)
+{
+	repeatCount = std::max<UInt32> (count, 1);
+}
+
+
+void PropertyTestHelpers::TestRunner::SetProgress (Progress* progressToReport)
+{
+	progress = progressToReport;
+}
+
+
+GSErrCode PropertyTestHelpers::TestRunner::Run ()
+{
+	struct ActiveGuard {
+		TestRunner* previous;
+		explicit ActiveGuard (TestRunner* runner) : previous (activeRunner) { activeRunner = runner; }
+		~ActiveGuard () { activeRunner = previous; }
+	} activeGuard (this);
+
+	results.clear ();
+	if (progress != nullptr) {
+		progress->SetItemCount (registry.GetSize () * repeatCount);
+	}
+
+	GSErrCode error = NoError;
+	std::vector<double> samples;
+	for (UInt32 testIndex = 0; testIndex < registry.GetSize () && error == NoError; ++testIndex) {
+		const TestRegistry::TestCase& test = registry.Get (testIndex);
+		TestResult result;
+		result.name = test.name;
+		samples.clear ();
+
+		for (UInt32 run = 0; run < repeatCount; ++run) {
+			if (progress != nullptr) {
+				if (progress->IsCanceled ()) {
+					error = APIERR_CANCEL;
+					break;
+				}
+				progress->Advance ();
+			}
+
+			runApiCallCount = 0;
+			runFailure.Clear ();
+
+			PropertyTestBatch::Stopwatch stopwatch;
+			GSErrCode testError = NoError;
+			try {
+				testError = test.run ();
+			} catch (const GS::Exception&) {
+				RecordFailure ("Unexpected GS::Exception");		// a failed assertion has recorded itself already
+				testError = Error;
+			} catch (const std::exception& exception) {
+				RecordFailure (GS::UniString (exception.what ()));
+				testError = Error;
+			}
+			if (testError == APIERR_CANCEL) {
+				error = APIERR_CANCEL;		// canceled inside the test: neither a failure nor a sample
+				break;
+			}
+			samples.push_back (stopwatch.GetSeconds ());
+
+			++result.runCount;
+			if (run == 0) {
+				result.apiCallCount = runApiCallCount;
+			}
+			if (testError != NoError) {
+				result.passed = false;
+				result.failure = runFailure.IsEmpty () ? GS::UniString ("Returned ") + GS::UniString (ErrID_To_Name (testError)) : runFailure;
+				break;
+			}
+		}
+
+		if (samples.empty ()) {
+			break;
+		}
+		for (double seconds : samples) {
+			result.totalSeconds += seconds;
+		}
+		std::sort (samples.begin (), samples.end ());
+		result.minSeconds = samples.front ();
+		result.medianSeconds = GetPercentile (samples, 50.0);
+		result.p95Seconds = GetPercentile (samples, 95.0);
+		results.push_back (result);
+	}
+
+	return error;
+}
+
+
+const std::vector<PropertyTestHelpers::TestResult>& PropertyTestHelpers::TestRunner::GetResults () const
+{
+	return results;
+}
+
+
+UInt32 PropertyTestHelpers::TestRunner::GetFailedCount () const
+{
+	UInt32 failedCount = 0;
+	for (const TestResult& result : results) {
+		if (!result.passed) {
+			++failedCount;
+		}
+	}
+	return failedCount;
+}
+
+
+void PropertyTestHelpers::TestRunner::Report (const char* commandName) const
+{
+	WriteReport ("%s: %u of %u test(s) run, %u failed, %u run(s) each",
+				 commandName, static_cast<UInt32> (results.size ()), registry.GetSize (), GetFailedCount (), repeatCount);
+	WriteReport ("  %-40s %6s %10s %10s %10s %9s", "test", "result", "min ms", "median ms", "p95 ms", "API calls");
+	for (const TestResult& result : results) {
+		WriteReport ("  %-40s %6s %10.2f %10.2f %10.2f %9u", result.name.ToCStr ().Get (), result.passed ? "ok" : "FAILED",
+					 result.minSeconds * 1000.0, result.medianSeconds * 1000.0, result.p95Seconds * 1000.0, result.apiCallCount);
+		if (!result.passed) {
+			WriteReport ("    %s", result.failure.ToCStr ().Get ());
+		}
+	}
+}
+
+
+GSErrCode PropertyTestHelpers::TestRunner::WriteJUnitReport (const IO::Location& location, const char* suiteName) const
+{
+	double totalSeconds = 0.0;
+	for (const TestResult& result : results) {
+		totalSeconds += result.totalSeconds;
+	}
+
+	char header[256];
+	std::snprintf (header, sizeof (header), "<testsuite name=\"%s\" tests=\"%u\" failures=\"%u\" errors=\"0\" time=\"%.6f\">\n",
+				   suiteName, static_cast<UInt32> (results.size ()), GetFailedCount (), totalSeconds);
+
+	std::string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+	xml += header;
+	for (const TestResult& result : results) {
+		char medianTime[64];
+		std::snprintf (medianTime, sizeof (medianTime), "%.6f", result.medianSeconds);
+
+		xml += "  <testcase classname=\"";
+		xml += suiteName;
+		xml += "\" name=\"";
+		AppendXmlText (xml, result.name);
+		xml += "\" time=\"";
+		xml += medianTime;
+		xml += "\">\n";
+
+		xml += "    <properties>\n";
+		AppendXmlProperty (xml, "runs", "%.0f", result.runCount);
+		AppendXmlProperty (xml, "apiCalls", "%.0f", result.apiCallCount);
+		AppendXmlProperty (xml, "minSeconds", "%.6f", result.minSeconds);
+		AppendXmlProperty (xml, "medianSeconds", "%.6f", result.medianSeconds);
+		AppendXmlProperty (xml, "p95Seconds", "%.6f", result.p95Seconds);
+		xml += "    </properties>\n";
+
+		if (!result.passed) {
+			xml += "    <failure message=\"";
+			AppendXmlText (xml, result.failure);
+			xml += "\"/>\n";
+		}
+		xml += "  </testcase>\n";
+	}
+	xml += "</testsuite>\n";
+
+	return PropertyTestSnapshot::SaveFile (location, std::vector<char> (xml.begin (), xml.end ()));
+}
+
+
+void PropertyTestHelpers::TestRunner::RecordApiCall ()
+{
+	++runApiCallCount;
+}
+
+
+void PropertyTestHelpers::TestRunner::RecordFailure (const GS::UniString& message)
+{
+	// the first failure is the cause, the others may follow from it
+	if (runFailure.IsEmpty ()) {
+		runFailure = message;
+	}
+}
+
+
+PropertyTestHelpers::TestRunner* PropertyTestHelpers::TestRunner::GetActive ()
+{
+	return activeRunner;
+}
@@ -0,0 +1,115 @@
+// *****************************************************************************
+// File:			Property_Test_TestRunner.hpp
+// Description:		Property_Test add-on timed test runner
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestHelpers
+// Contact person:	CSAT
+// *****************************************************************************
+
+#if !defined (TESTRUNNER_HPP)
+#define	TESTRUNNER_HPP
+
+#include "Property_Test.hpp"
+#include "Property_Test_Progress.hpp"
+
+#include "Location.hpp"
+
+#include <functional>
+#include <vector>
+
+namespace PropertyTestHelpers
+{
+
+// -----------------------------------------------------------------------------
+// The test cases to run, in the order they were added
+// -----------------------------------------------------------------------------
+
+class TestRegistry
+{
+public:
+	typedef std::function<GSErrCode ()>	TestFunction;
+
+	struct TestCase {
+		GS::UniString	name;
+		TestFunction	run;
+	};
+
+	void				Add (const char* name, const TestFunction& run);
+
+	UInt32				GetSize () const;
+	const TestCase&		Get (UInt32 index) const;
+
+private:
+	std::vector<TestCase>	tests;
+};
+
+
+// -----------------------------------------------------------------------------
+// The result of one test case over every run
+// -----------------------------------------------------------------------------
+
+struct TestResult {
+	GS::UniString	name;
+	bool			passed;
+	GS::UniString	failure;			// the first failed assertion or error
+	UInt32			runCount;			// a failed test is not run again
+	UInt32			apiCallCount;		// in the first run
+	double			minSeconds;
+	double			medianSeconds;
+	double			p95Seconds;
+	double			totalSeconds;
+
+	TestResult ();
+};
+
+
+// -----------------------------------------------------------------------------
+// Runs every test case of a registry, each the given number of times, and
+// measures them:
+//	- the wall time of each run; from more runs the minimum, the median and
+//	  the 95th percentile
+//	- the API calls of the first run: the calls checked with ASSERT_NO_ERROR
+//	  or COLLECT_ERROR
+// A failed assertion (ASSERT, ASSERT_NO_ERROR) or an error returned by the
+// test fails only that test: it is recorded without an alert, and the runner
+// goes on with the next test. A test returning APIERR_CANCEL stops the run.
+// The tests run one after the other on the calling thread, as the API needs.
+// While Run is running the runner is the active one of the add-on.
+// -----------------------------------------------------------------------------
+
+class TestRunner
+{
+public:
+	TestRunner (const TestRegistry& registryToRun);
+
+	void			SetRepeatCount (UInt32 count);
+	void			SetProgress (Progress* progressToReport);		// counts the runs
+
+	GSErrCode		Run ();			// APIERR_CANCEL if the user canceled it; the failures are in the results
+
+	const std::vector<TestResult>&	GetResults () const;
+	UInt32			GetFailedCount () const;
+
+	void			Report (const char* commandName) const;
+	GSErrCode		WriteJUnitReport (const IO::Location& location, const char* suiteName) const;
+
+	void			RecordApiCall ();
+	void			RecordFailure (const GS::UniString& message);
+
+	static TestRunner*	GetActive ();
+
+private:
+	TestRunner (const TestRunner&);				// disabled
+	TestRunner& operator= (const TestRunner&);	// disabled
+
+	const TestRegistry&			registry;
+	UInt32						repeatCount;
+	Progress*					progress;
+	std::vector<TestResult>		results;
+	UInt32						runApiCallCount;
+	GS::UniString				runFailure;
+};
+
+}
+
+#endif
@@ -0,0 +1,225 @@
+// *****************************************************************************
+// File:			Property_Test_WorkerPool.cpp
+// Description:		Property_Test add-on work-stealing thread pool
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestHelpers
+// Contact person:	CSAT
+// *****************************************************************************
+
+#include "Property_Test_WorkerPool.hpp"
+
+static std::unique_ptr<PropertyTestHelpers::WorkerPool> sharedPool;
+
+// Chunks per thread in ParallelFor; more chunks than threads let the idle
+// workers steal the tail of an unevenly distributed range
+static const UInt32 ChunksPerThread = 4;
+
+
+PropertyTestHelpers::WorkerPool::WorkerPool (UInt32 workerCount /* = 0*/) :
+	pendingTasks (0),
+	queuedTasks (0),
+	nextQueue (0),
+	stopping (false)
+{
+	if (workerCount == 0) {
+		const UInt32 cores = std::thread::hardware_concurrency ();
+		workerCount = (cores > 1) ? cores - 1 : 1;
+	}
+
+	for (UInt32 i = 0; i < workerCount + 1; ++i) {
+		queues.emplace_back (new TaskQueue ());
+	}
+
+	for (UInt32 i = 0; i < workerCount; ++i) {
+		threads.emplace_back (&WorkerPool::WorkerMain, this, i);
+	}
+}
+
+
+PropertyTestHelpers::WorkerPool::~WorkerPool ()
+{
+	{
+		std::lock_guard<std::mutex> lock (stateMutex);
+		stopping = true;
+	}
+	workAvailable.notify_all ();
+
+	for (std::thread& thread : threads) {
+		thread.join ();
+	}
+}
+
+
+UInt32 PropertyTestHelpers::WorkerPool::GetWorkerCount () const
+{
+	return static_cast<UInt32> (threads.size ());
+}
+
+
+void PropertyTestHelpers::WorkerPool::Submit (const Task& task)
+{
+	{
+		std::lock_guard<std::mutex> lock (stateMutex);
+		++pendingTasks;
+		++queuedTasks;
+	}
+
+	const UInt32 queueIndex = nextQueue++ % GetWorkerCount ();
+	{
+		std::lock_guard<std::mutex> lock (queues[queueIndex]->mutex);
+		queues[queueIndex]->tasks.push_back (task);
+	}
+	workAvailable.notify_one ();
+}
+
+
+void PropertyTestHelpers::WorkerPool::Wait ()
+{
+	const UInt32 ownQueue = GetWorkerCount ();
+
+	Task task;
+	while (pendingTasks > 0) {
+		if (TryPop (ownQueue, task) || TrySteal (ownQueue, task)) {
+			Execute (task);
+			continue;
+		}
+
+		// nothing left to steal: the remaining tasks are running on the workers
+		std::unique_lock<std::mutex> lock (stateMutex);
+		workDone.wait (lock, [&] () { return pendingTasks == 0; });
+	}
+
+	std::exception_ptr exception;
+	{
+		std::lock_guard<std::mutex> lock (stateMutex);
+		std::swap (exception, firstException);
+	}
+	if (exception != nullptr) {
+		std::rethrow_exception (exception);
+	}
+}
+
+
+UInt32 PropertyTestHelpers::WorkerPool::GetChunkSize (UInt32 count, UInt32 minChunkSize) const
+{
+	const UInt32 threadCount = GetWorkerCount () + 1;
+	UInt32 chunkSize = (count + threadCount * ChunksPerThread - 1) / (threadCount * ChunksPerThread);
+	return (chunkSize < minChunkSize) ? minChunkSize : chunkSize;
+}
+
+
+void PropertyTestHelpers::WorkerPool::ParallelFor (UInt32 count, UInt32 minChunkSize, const RangeTask& body)
+{
+	if (count == 0) {
+		return;
+	}
+
+	if (GetChunkSize (count, minChunkSize) >= count) {
+		body (0, count);
+		return;
+	}
+
+	ParallelForAsync (count, minChunkSize, body);
+	Wait ();
+}
+
+
+void PropertyTestHelpers::WorkerPool::ParallelForAsync (UInt32 count, UInt32 minChunkSize, const RangeTask& body)
+{
+	if (count == 0) {
+		return;
+	}
+
+	// the tasks may outlive the caller's copy of the body
+	std::shared_ptr<RangeTask> sharedBody = std::make_shared<RangeTask> (body);
+
+	const UInt32 chunkSize = GetChunkSize (count, minChunkSize);
+	for (UInt32 begin = 0; begin < count; begin += chunkSize) {
+		const UInt32 end = (count - begin > chunkSize) ? begin + chunkSize : count;
+		Submit ([sharedBody, begin, end] () { (*sharedBody) (begin, end); });
+	}
+}
+
+
+PropertyTestHelpers::WorkerPool& PropertyTestHelpers::WorkerPool::Get ()
+{
+	if (sharedPool == nullptr) {
+		sharedPool.reset (new WorkerPool ());
+	}
+	return *sharedPool;
+}
+
+
+void PropertyTestHelpers::WorkerPool::Shutdown ()
+{
+	sharedPool.reset ();
+}
+
+
+bool PropertyTestHelpers::WorkerPool::TryPop (UInt32 queueIndex, Task& task)
+{
+	TaskQueue& queue = *queues[queueIndex];
+	std::lock_guard<std::mutex> lock (queue.mutex);
+	if (queue.tasks.empty ()) {
+		return false;
+	}
+
+	task = std::move (queue.tasks.back ());
+	queue.tasks.pop_back ();
+	--queuedTasks;
+	return true;
+}
+
+
+bool PropertyTestHelpers::WorkerPool::TrySteal (UInt32 thiefIndex, Task& task)
+{
+	const UInt32 queueCount = static_cast<UInt32> (queues.size ());
+	for (UInt32 i = 1; i < queueCount; ++i) {
+		TaskQueue& queue = *queues[(thiefIndex + i) % queueCount];
+		std::lock_guard<std::mutex> lock (queue.mutex);
+		if (!queue.tasks.empty ()) {
+			task = std::move (queue.tasks.front ());
+			queue.tasks.pop_front ();
+			--queuedTasks;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+void PropertyTestHelpers::WorkerPool::Execute (Task& task)
+{
+	try {
+		task ();
+	} catch (...) {
+		std::lock_guard<std::mutex> lock (stateMutex);
+		if (firstException == nullptr) {
+			firstException = std::current_exception ();
+		}
+	}
+	task = nullptr;
+
+	std::lock_guard<std::mutex> lock (stateMutex);
+	if (--pendingTasks == 0) {
+		workDone.notify_all ();
+	}
+}
+
+
+void PropertyTestHelpers::WorkerPool::WorkerMain (UInt32 queueIndex)
+{
+	Task task;
+	for (;;) {
+		if (TryPop (queueIndex, task) || TrySteal (queueIndex, task)) {
+			Execute (task);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock (stateMutex);
+		workAvailable.wait (lock, [&] () { return stopping || queuedTasks > 0; });
+		if (stopping) {
+			return;
+		}
+	}
+}
@@ -0,0 +1,89 @@
+// *****************************************************************************
+// File:			Property_Test_WorkerPool.hpp
+// Description:		Property_Test add-on work-stealing thread pool
+// Project:			APITools/Property_Test
+// Namespace:		PropertyTestHelpers
+// Contact person:	CSAT
+// *****************************************************************************
+
+#if !defined (WORKERPOOL_HPP)
+#define	WORKERPOOL_HPP
+
+#include "Property_Test.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace PropertyTestHelpers
+{
+
+// -----------------------------------------------------------------------------
+// Thread pool for the pure-compute stages of the bulk commands.
+// Every worker owns a task deque: it pops its own tasks from the back and
+// steals from the front of the others' when it runs out. The calling thread
+// takes part in the work while it waits.
+// Tasks must not call the API, reads and writes stay on the main thread.
+// -----------------------------------------------------------------------------
+
+class WorkerPool
+{
+public:
+	typedef std::function<void ()>						Task;
+	typedef std::function<void (UInt32, UInt32)>		RangeTask;		// [begin, end)
+
+	explicit WorkerPool (UInt32 workerCount = 0);		// 0: one worker per additional core
+	~WorkerPool ();
+
+	UInt32			GetWorkerCount () const;
+
+	void			Submit (const Task& task);
+	void			Wait ();
+
+	// Splits [0, count) into chunks of at least minChunkSize items. Results
+	// written by index keep the output order independent of the scheduling.
+	void			ParallelFor (UInt32 count, UInt32 minChunkSize, const RangeTask& body);
+
+	// Same as ParallelFor, but returns at once; the next Wait () completes it.
+	// Meanwhile the calling thread can do its own work (e.g. API calls).
+	void			ParallelForAsync (UInt32 count, UInt32 minChunkSize, const RangeTask& body);
+
+	static WorkerPool&	Get ();
+	static void			Shutdown ();
+
+private:
+	struct TaskQueue {
+		std::mutex			mutex;
+		std::deque<Task>	tasks;
+	};
+
+	WorkerPool (const WorkerPool&);				// disabled
+	WorkerPool& operator= (const WorkerPool&);	// disabled
+
+	UInt32			GetChunkSize (UInt32 count, UInt32 minChunkSize) const;
+	bool			TryPop (UInt32 queueIndex, Task& task);
+	bool			TrySteal (UInt32 thiefIndex, Task& task);
+	void			Execute (Task& task);
+	void			WorkerMain (UInt32 queueIndex);
+
+	std::vector<std::unique_ptr<TaskQueue>>	queues;			// one per worker + one for the calling thread
+	std::vector<std::thread>				threads;
+	std::atomic<UInt32>						pendingTasks;	// submitted and not finished yet
+	std::atomic<UInt32>						queuedTasks;	// submitted and not taken by a thread yet
+	std::atomic<UInt32>						nextQueue;
+	std::mutex								stateMutex;
+	std::condition_variable					workAvailable;
+	std::condition_variable					workDone;
+	std::exception_ptr						firstException;
+	bool									stopping;
+};
+
+}
+
+#endif